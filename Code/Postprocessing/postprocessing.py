@@ -12,6 +12,7 @@
 #--------#
 
 import os
+import re
 import pandas as pd
 import numpy as np
 import matplotlib.pyplot as plt
@@ -44,6 +45,15 @@ colors = ['black',
 
 algorithms = set(['ARAC', 'PGPE', 'NPGPE', 'RSARAC', 'RSPGPE', 'RSNPGPE'])
 
+#---------------------------------------------------------------------------#
+# File names: convergence and backtest files, skipping summaries and        |
+# checkpoints written in the same directories                               |
+#---------------------------------------------------------------------------#
+
+convergenceFileRegex = re.compile(r'^experiment\d+(_window\d+)?\.csv$')
+backtestFileRegex    = re.compile(r'^experiment\d+\.csv$')
+summaryFileRegex     = re.compile(r'^experiment\d+_summary\.csv$')
+
 
 #-------------------#
 # Utility functions #
@@ -139,7 +149,7 @@ def compareAlgorithmConvergence(debugDir, imagesDir=None):
             algorithmsList += [algorithmName]
 
         # Retrieve debug files for the current algorithm
-        filesList = [os.path.join(subdir, f) for f in files]
+        filesList = [os.path.join(subdir, f) for f in files if convergenceFileRegex.match(f)]
 
         if len(filesList) > 0:
             # Compute aggregate convergence statistics for the current algorithm
@@ -287,8 +297,8 @@ def compareAlgorithmPerformance(outputDir, imagesDir):
         else:
             algorithmsList += [algorithmName]
 
-        # Retrieve debug files for the current algorithm
-        filesList = [os.path.join(subdir, f) for f in files]
+        # Retrieve backtest files for the current algorithm
+        filesList = [os.path.join(subdir, f) for f in files if backtestFileRegex.match(f)]
 
         if len(filesList) > 0:
             # Compute aggregate performance statistics
@@ -361,6 +371,41 @@ def extractBacktestStatistics(dfStatAlgo):
     return dfStatRed
 
 
+def summarizeBacktests(outputDir):
+    """ Aggregate the backtest summaries written by the C++ program along with
+    the backtests, without reading the backtest files. The mean and standard
+    deviation across the experiments of each learning algorithm are written to
+    Statistics/summary.csv.
+
+    Args:
+        outputDir (str): output directory.
+
+    Returns:
+        dfSummary (pd.DataFrame): dataframe containing the aggregate summaries
+    """
+    dfSummary = pd.DataFrame()
+
+    for subdir, dirs, files in os.walk(outputDir):
+
+        # Retrieve algorithm name
+        algorithmName = subdir[::-1].split('/', 1)[0][::-1]
+
+        if algorithmName not in algorithms:
+            continue
+
+        # Retrieve summary files for the current algorithm
+        filesList = [os.path.join(subdir, f) for f in files if summaryFileRegex.match(f)]
+
+        if len(filesList) > 0:
+            dfSummaryExp = pd.concat([pd.read_csv(f) for f in filesList])
+            dfSummary[algorithmName] = dfSummaryExp.mean(axis=0)
+            dfSummary[algorithmName + '_delta'] = dfSummaryExp.std(axis=0)
+
+    createDirectory(outputDir + 'Statistics/')
+    dfSummary.to_csv(outputDir + 'Statistics/summary.csv')
+    return dfSummary
+
+
 def postprocessing(debugDir, outputDir):
     """ Postprocessing wrapper function.
 
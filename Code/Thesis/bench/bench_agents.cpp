@@ -0,0 +1,202 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "bench_common.h"
+#include <thesis/AracAgent.h>
+#include <thesis/ArrsacAgent.h>
+#include <thesis/BinaryPolicy.h>
+#include <thesis/BoltzmannPolicy.h>
+#include <thesis/Critic.h>
+#include <thesis/LearningRate.h>
+#include <thesis/LinearRegressor.h>
+#include <thesis/NpgpeAgent.h>
+#include <thesis/RiskSensitiveNpgpeAgent.h>
+#include <thesis/StochasticActor.h>
+
+namespace
+{
+
+//! Number of cached rewards fed to the agents in turn
+const size_t numRewards = 1024;
+
+/*!
+ * Time the learning step of an agent. The agent receives an observation of
+ * the task, selects an action and then learns from a rotating set of rewards.
+ */
+void learnBenchmark(benchmark::State &state, Agent &agent,
+                    AssetAllocationTask const &task)
+{
+    arma::vec observation = task.getObservation();
+    arma::vec action(agent.getDimAction());
+    agent.receiveObservation(observation);
+    agent.getAction(action);
+    agent.receiveNextObservation(observation);
+
+    arma::vec rewards(numRewards);
+    rewards.randn();
+    rewards *= 0.01;
+
+    size_t idx = 0;
+    for (auto _ : state)
+    {
+        agent.receiveReward(rewards[idx]);
+        agent.learn();
+        idx = (idx + 1) % numRewards;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/*!
+ * Time a full step of the training loop of AssetAllocationExperiment, i.e. the
+ * interaction between the task and the agent followed by the learning step.
+ * With AgentT = Agent the calls go through the virtual table, with a concrete
+ * agent type they are resolved at compile time. The task is reset when the
+ * series is exhausted.
+ */
+template<class AgentT>
+void stepBenchmark(benchmark::State &state, AgentT &agent,
+                   AssetAllocationTask &task)
+{
+    arma::vec observation = task.getObservation();
+    arma::vec action(agent.getDimAction());
+    size_t const numSteps = bench::numDays - task.getNumDaysObserved() - 1;
+    size_t step = 0;
+    for (auto _ : state)
+    {
+        if (step == numSteps)
+        {
+            state.PauseTiming();
+            task.reset();
+            task.getObservation(observation);
+            step = 0;
+            state.ResumeTiming();
+        }
+        agent.receiveObservation(observation);
+        agent.getAction(action);
+        task.performAction(action);
+        agent.receiveReward(task.getReward());
+        task.getObservation(observation);
+        agent.receiveNextObservation(observation);
+        agent.learn();
+        ++step;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+/*!
+ * Sweep over the number of past days observed of a single risky asset, traded
+ * by the long-short agents built by FactoryOfAgents.
+ */
+void daysSweep(benchmark::internal::Benchmark *b)
+{
+    for (int numDaysObserved : {0, 5, 20})
+        b->Args({1, numDaysObserved});
+    b->ArgNames({"assets", "daysObserved"});
+}
+
+} // namespace
+
+/*!
+ * Training step of the ARAC agent with a Boltzmann actor, through the Agent
+ * interface (AgentT = Agent) or the concrete BoltzmannARACAgent type.
+ */
+template<class AgentT>
+static void BM_ARACAgentStep(benchmark::State &state)
+{
+    AssetAllocationTask task = bench::makeTask(state.range(0), state.range(1));
+    BoltzmannPolicy policy(task.getDimObservation(), {-1.0, 1.0});
+    LinearRegressor approximator(task.getDimObservation());
+    ConstantLearningRate baselineLearningRate(0.1);
+    ConstantLearningRate criticLearningRate(0.1);
+    ConstantLearningRate actorLearningRate(0.001);
+    BoltzmannARACAgent agent(BasicStochasticActor<BoltzmannPolicy>(policy),
+                             BasicCritic<LinearRegressor>(approximator),
+                             baselineLearningRate, criticLearningRate,
+                             actorLearningRate, 0.5);
+    stepBenchmark<AgentT>(state, agent, task);
+}
+BENCHMARK_TEMPLATE(BM_ARACAgentStep, Agent)->Apply(daysSweep);
+BENCHMARK_TEMPLATE(BM_ARACAgentStep, BoltzmannARACAgent)->Apply(daysSweep);
+
+/*!
+ * Training step of the NPGPE agent with a binary controller, through the Agent
+ * interface (AgentT = Agent) or the concrete BinaryNPGPEAgent type.
+ */
+template<class AgentT>
+static void BM_NPGPEAgentStep(benchmark::State &state)
+{
+    AssetAllocationTask task = bench::makeTask(state.range(0), state.range(1));
+    BinaryPolicy controller(task.getDimObservation());
+    ConstantLearningRate baselineLearningRate(0.1);
+    ConstantLearningRate hyperparamsLearningRate(0.001);
+    BinaryNPGPEAgent agent(controller, baselineLearningRate, hyperparamsLearningRate, 0.5);
+    stepBenchmark<AgentT>(state, agent, task);
+}
+BENCHMARK_TEMPLATE(BM_NPGPEAgentStep, Agent)->Apply(daysSweep);
+BENCHMARK_TEMPLATE(BM_NPGPEAgentStep, BinaryNPGPEAgent)->Apply(daysSweep);
+
+/*!
+ * Learning step of the NPGPE agent with a binary controller.
+ */
+static void BM_NPGPEAgentLearn(benchmark::State &state)
+{
+    AssetAllocationTask task = bench::makeTask(state.range(0), state.range(1));
+    BinaryPolicy controller(task.getDimObservation());
+    ConstantLearningRate baselineLearningRate(0.1);
+    ConstantLearningRate hyperparamsLearningRate(0.001);
+    NPGPEAgent agent(controller, baselineLearningRate, hyperparamsLearningRate, 0.5);
+    learnBenchmark(state, agent, task);
+}
+BENCHMARK(BM_NPGPEAgentLearn)->Apply(bench::assetsDaysSweep);
+
+/*!
+ * Learning step of the risk-sensitive NPGPE agent with a binary controller.
+ */
+static void BM_RiskSensitiveNPGPEAgentLearn(benchmark::State &state)
+{
+    AssetAllocationTask task = bench::makeTask(state.range(0), state.range(1));
+    BinaryPolicy controller(task.getDimObservation());
+    ConstantLearningRate baselineLearningRate(0.1);
+    ConstantLearningRate hyperparamsLearningRate(0.001);
+    RiskSensitiveNPGPEAgent agent(controller, baselineLearningRate,
+                                  hyperparamsLearningRate, 0.5);
+    learnBenchmark(state, agent, task);
+}
+BENCHMARK(BM_RiskSensitiveNPGPEAgentLearn)->Apply(bench::assetsDaysSweep);
+
+/*!
+ * Learning step of the ARRSAC agent with a Boltzmann actor.
+ */
+static void BM_ARRSACAgentLearn(benchmark::State &state)
+{
+    AssetAllocationTask task = bench::makeTask(state.range(0), state.range(1));
+    Critic criticV(LinearRegressor(task.getDimObservation()));
+    Critic criticU(LinearRegressor(task.getDimObservation()));
+    StochasticActor actor(BoltzmannPolicy(task.getDimObservation(), {-1.0, 1.0}));
+    ConstantLearningRate baselineLearningRate(0.1);
+    ConstantLearningRate criticLearningRate(0.1);
+    ConstantLearningRate actorLearningRate(0.001);
+    ARRSACAgent agent(actor, criticV, criticU, baselineLearningRate,
+                      criticLearningRate, actorLearningRate, 0.5);
+    learnBenchmark(state, agent, task);
+}
+BENCHMARK(BM_ARRSACAgentLearn)->Apply(bench::assetsDaysSweep);
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef BENCH_COMMON_H
+#define BENCH_COMMON_H
+
+#include <thesis/MarketData.h>
+#include <thesis/MarketEnvironment.h>
+#include <thesis/AssetAllocationTask.h>
+#include <thesis/Precision.h>
+#include <benchmark/benchmark.h>
+#include <armadillo>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*!
+ * Shared helpers of the microbenchmark suite. The benchmarks run on synthetic
+ * Gaussian log-returns, so that the suite does not depend on the data folder.
+ */
+
+namespace bench
+{
+
+//! Number of days of the synthetic return series
+static const size_t numDays = 4096;
+
+//! Transaction costs and risk-free rate used by the benchmark tasks
+static const double riskFreeRate = 0.0;
+static const double deltaP = 0.001;
+static const double deltaF = 0.0;
+static const double deltaS = 0.0;
+
+/*!
+ * Build a synthetic market with i.i.d. Gaussian daily log-returns.
+ * \param numRiskyAssets number of risky assets
+ * \param numDays_ number of days of the series
+ * \return shared market data store
+ */
+inline std::shared_ptr<MarketData const> makeMarketData(size_t numRiskyAssets,
+                                                        size_t numDays_ = numDays)
+{
+    arma::arma_rng::set_seed(42);
+    arma::mat returns(numRiskyAssets, numDays_);
+    returns.randn();
+    returns *= 0.01;
+    std::vector<std::string> symbols;
+    for (size_t i = 0; i < numRiskyAssets; ++i)
+        symbols.push_back("A" + std::to_string(i));
+    return std::make_shared<MarketData const>(symbols, returns);
+}
+
+/*!
+ * Build an asset allocation task on a synthetic market.
+ * \param numRiskyAssets number of risky assets
+ * \param numDaysObserved number of past days observed by the agent
+ * \return asset allocation task
+ */
+inline AssetAllocationTask makeTask(size_t numRiskyAssets, size_t numDaysObserved)
+{
+    MarketEnvironment market(makeMarketData(numRiskyAssets));
+    market.setEvaluationInterval(0, numDays - 1);
+    return AssetAllocationTask(market, riskFreeRate, deltaP, deltaF, deltaS,
+                               numDaysObserved);
+}
+
+/*!
+ * Current observation of a task in the learning stack precision, for the
+ * benchmarks that call the policies directly.
+ * \param task asset allocation task
+ * \return observation
+ */
+inline RealVec makeObservation(AssetAllocationTask const &task)
+{
+    RealVec observation;
+    convertTo(task.getObservation(), observation);
+    return observation;
+}
+
+/*!
+ * Sweep over the number of risky assets (first argument) and the number of
+ * past days observed (second argument).
+ */
+inline void assetsDaysSweep(benchmark::internal::Benchmark *b)
+{
+    for (int numRiskyAssets : {1, 2, 5, 10})
+        for (int numDaysObserved : {0, 5, 20})
+            b->Args({numRiskyAssets, numDaysObserved});
+    b->ArgNames({"assets", "daysObserved"});
+}
+
+} // namespace bench
+
+#endif // BENCH_COMMON_H
@@ -0,0 +1,148 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "bench_common.h"
+#include <thesis/AssetAllocationExperiment.h>
+#include <thesis/FactoryOfAgents.h>
+#include <thesis/LearningRate.h>
+#include <atomic>
+#include <cstdlib>
+#include <dlfcn.h>
+#include <new>
+#include <string>
+
+/*!
+ * Allocation accounting. The global allocation functions, which back the
+ * standard containers, are replaced and posix_memalign, which Armadillo uses
+ * for its matrix memory, is interposed, so that the benchmarks below can check
+ * that the interaction loop of AssetAllocationExperiment does not allocate.
+ */
+
+namespace
+{
+
+//! Number of heap allocations performed by the process
+std::atomic<size_t> numAllocations(0);
+
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    ++numAllocations;
+    if (void *ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+extern "C" int posix_memalign(void **memptr, size_t alignment, size_t size)
+{
+    typedef int (*PosixMemalign)(void **, size_t, size_t);
+    static PosixMemalign realPosixMemalign =
+        reinterpret_cast<PosixMemalign>(dlsym(RTLD_NEXT, "posix_memalign"));
+    ++numAllocations;
+    return realPosixMemalign(memptr, alignment, size);
+}
+
+namespace
+{
+
+//! Sizes of the benchmark experiment
+const size_t numTrainingSteps = 1000;
+const size_t numTestSteps = 500;
+
+/*!
+ * Sweep over the number of past days observed of the single risky asset
+ * traded by the agents built by FactoryOfAgents. Armadillo stores objects of
+ * up to 16 elements inside the object, hence the observation, the controller
+ * parameters, the critic and the covariance factor are all kept larger than
+ * that, so that a temporary of their size would be counted.
+ */
+void experimentDaysSweep(benchmark::internal::Benchmark *b)
+{
+    for (int numDaysObserved : {20, 60})
+        b->Args({numDaysObserved});
+    b->ArgNames({"daysObserved"});
+}
+
+} // namespace
+
+/*!
+ * One training epoch of AssetAllocationExperiment followed by the backtest
+ * steps, for an agent built by FactoryOfAgents. The epoch runs the interaction
+ * loop selected for the agent, the convergence statistics and the backtest
+ * log, through the same code as AssetAllocationExperiment::run. After a
+ * warm-up epoch the loop must not allocate: the heap allocations are counted
+ * and the benchmark fails if there are any.
+ */
+static void BM_ExperimentEpoch(benchmark::State &state, std::string const &algorithm)
+{
+    AssetAllocationTask task = bench::makeTask(1, state.range(0));
+    DecayingLearningRate baselineLearningRate(0.1, 0.7);
+    DecayingLearningRate criticLearningRate(0.1, 0.7);
+    DecayingLearningRate actorLearningRate(0.1, 0.7);
+    FactoryOfAgents factory(task.getDimObservation(), baselineLearningRate,
+                            criticLearningRate, actorLearningRate, 0.5,
+                            "full", 1, 1, 1);
+    std::unique_ptr<Agent> agentPtr = factory.make(algorithm);
+    AssetAllocationExperiment experiment(task, *agentPtr, 1, 1, numTrainingSteps,
+                                         numTestSteps, "", "");
+
+    // Warm-up epoch
+    experiment.trainingEpoch();
+    experiment.backtestSteps(numTestSteps);
+
+    size_t const allocationsBefore = numAllocations;
+    for (auto _ : state)
+    {
+        experiment.trainingEpoch();
+        experiment.backtestSteps(numTestSteps);
+    }
+    size_t const allocations = numAllocations - allocationsBefore;
+
+    state.counters["allocations"] = allocations;
+    state.SetItemsProcessed(state.iterations() * (numTrainingSteps + numTestSteps));
+    if (allocations > 0)
+        state.SkipWithError("The interaction loop allocated on the heap");
+}
+BENCHMARK_CAPTURE(BM_ExperimentEpoch, ARAC, std::string("ARAC"))
+    ->Apply(experimentDaysSweep)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_ExperimentEpoch, PGPE, std::string("PGPE"))
+    ->Apply(experimentDaysSweep)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_ExperimentEpoch, NPGPE, std::string("NPGPE"))
+    ->Apply(experimentDaysSweep)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_ExperimentEpoch, RSARAC, std::string("RSARAC"))
+    ->Apply(experimentDaysSweep)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_ExperimentEpoch, RSPGPE, std::string("RSPGPE"))
+    ->Apply(experimentDaysSweep)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_CAPTURE(BM_ExperimentEpoch, RSNPGPE, std::string("RSNPGPE"))
+    ->Apply(experimentDaysSweep)
+    ->Unit(benchmark::kMillisecond);
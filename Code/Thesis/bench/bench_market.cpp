@@ -0,0 +1,102 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "bench_common.h"
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+
+namespace
+{
+
+/*!
+ * Write a synthetic return series in the CSV input format: a header with the
+ * number of days and of assets, the symbols and one line of returns per day.
+ */
+void writeCsv(std::string const &path, MarketData const &data)
+{
+    std::ofstream ofs(path);
+    ofs << data.getNumDays() << "," << data.getNumRiskyAssets() << "\n";
+    for (size_t j = 0; j < data.getNumRiskyAssets(); ++j)
+        ofs << (j ? "," : "") << data.getAssetsSymbols()[j];
+    ofs << "\n" << std::setprecision(17);
+    arma::mat const &returns = data.getAssetsReturns();
+    for (size_t i = 0; i < data.getNumDays(); ++i)
+    {
+        for (size_t j = 0; j < data.getNumRiskyAssets(); ++j)
+            ofs << (j ? "," : "") << returns(j, i);
+        ofs << "\n";
+    }
+}
+
+/*!
+ * Sweep over the number of risky assets (first argument) and the number of
+ * days of the series (second argument). The number of days observed does not
+ * affect the loading time.
+ */
+void assetsLengthSweep(benchmark::internal::Benchmark *b)
+{
+    for (int numRiskyAssets : {1, 2, 5, 10})
+        for (int numDays : {1024, 4096})
+            b->Args({numRiskyAssets, numDays});
+    b->ArgNames({"assets", "days"});
+    b->Unit(benchmark::kMillisecond);
+}
+
+} // namespace
+
+/*!
+ * Construction of a MarketEnvironment from a CSV return series.
+ */
+static void BM_MarketEnvironmentLoadCsv(benchmark::State &state)
+{
+    std::string const path = "bench_market_" + std::to_string(state.range(0)) +
+                              "_" + std::to_string(state.range(1)) + ".csv";
+    writeCsv(path, *bench::makeMarketData(state.range(0), state.range(1)));
+    for (auto _ : state)
+    {
+        MarketEnvironment market(path);
+        benchmark::DoNotOptimize(market.getNumDays());
+    }
+    std::remove(path.c_str());
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(BM_MarketEnvironmentLoadCsv)->Apply(assetsLengthSweep);
+
+/*!
+ * Construction of a MarketEnvironment from a memory-mapped binary series, for
+ * comparison with the CSV loading.
+ */
+static void BM_MarketEnvironmentLoadBinary(benchmark::State &state)
+{
+    std::string const path = "bench_market_" + std::to_string(state.range(0)) +
+                              "_" + std::to_string(state.range(1)) + ".bin";
+    bench::makeMarketData(state.range(0), state.range(1))->save(path);
+    for (auto _ : state)
+    {
+        MarketEnvironment market(path);
+        benchmark::DoNotOptimize(market.getNumDays());
+    }
+    std::remove(path.c_str());
+    state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(BM_MarketEnvironmentLoadBinary)->Apply(assetsLengthSweep);
@@ -0,0 +1,163 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "bench_common.h"
+#include <thesis/BinaryPolicy.h>
+#include <thesis/BoltzmannPolicy.h>
+#include <thesis/FixedBinaryPolicy.h>
+
+/*!
+ * Action selection of the Boltzmann policy for the observation of an asset
+ * allocation task.
+ */
+static void BM_BoltzmannGetAction(benchmark::State &state)
+{
+    AssetAllocationTask task = bench::makeTask(state.range(0), state.range(1));
+    RealVec observation = bench::makeObservation(task);
+    BoltzmannPolicy policy(task.getDimObservation(), {-1.0, 1.0});
+    RealVec action(policy.getDimAction());
+    for (auto _ : state)
+    {
+        policy.getAction(observation, action);
+        benchmark::DoNotOptimize(action.memptr());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BoltzmannGetAction)->Apply(bench::assetsDaysSweep);
+
+/*!
+ * Likelihood score of the Boltzmann policy for the last selected action.
+ */
+static void BM_BoltzmannLikelihoodScore(benchmark::State &state)
+{
+    AssetAllocationTask task = bench::makeTask(state.range(0), state.range(1));
+    RealVec observation = bench::makeObservation(task);
+    BoltzmannPolicy policy(task.getDimObservation(), {-1.0, 1.0});
+    RealVec action = policy.getAction(observation);
+    RealVec likScore(policy.getDimParameters());
+    for (auto _ : state)
+    {
+        policy.likelihoodScore(observation, action, likScore);
+        benchmark::DoNotOptimize(likScore.memptr());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BoltzmannLikelihoodScore)->Apply(bench::assetsDaysSweep);
+
+/*!
+ * Action selection and likelihood score of a Boltzmann policy over a grid of
+ * possible allocations (third argument).
+ */
+static void BM_BoltzmannManyActions(benchmark::State &state)
+{
+    AssetAllocationTask task = bench::makeTask(state.range(0), state.range(1));
+    RealVec observation = bench::makeObservation(task);
+    size_t const numActions = state.range(2);
+    std::vector<double> possibleActions(numActions);
+    for (size_t i = 0; i < numActions; ++i)
+        possibleActions[i] = -1.0 + 2.0 * i / (numActions - 1);
+    BoltzmannPolicy policy(task.getDimObservation(), possibleActions);
+    RealVec action(policy.getDimAction());
+    RealVec likScore(policy.getDimParameters());
+    for (auto _ : state)
+    {
+        policy.getAction(observation, action);
+        policy.likelihoodScore(observation, action, likScore);
+        benchmark::DoNotOptimize(likScore.memptr());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_BoltzmannManyActions)
+    ->ArgsProduct({{1, 10}, {5}, {2, 11, 101}})
+    ->ArgNames({"assets", "daysObserved", "actions"});
+
+/*!
+ * Action selection of a population of binary controllers (third argument) for
+ * the observation of an asset allocation task, with one matrix-vector product.
+ */
+static void BM_BinaryGetActions(benchmark::State &state)
+{
+    AssetAllocationTask task = bench::makeTask(state.range(0), state.range(1));
+    RealVec observation = bench::makeObservation(task);
+    BinaryPolicy policy(task.getDimObservation());
+    RealMat parameters(policy.getDimParameters(), state.range(2), arma::fill::randn);
+    RealMat actions(policy.getDimAction(), state.range(2));
+    for (auto _ : state)
+    {
+        policy.getActions(observation, parameters, actions);
+        benchmark::DoNotOptimize(actions.memptr());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(2));
+}
+BENCHMARK(BM_BinaryGetActions)
+    ->ArgsProduct({{1, 10}, {5, 20}, {1, 8, 64}})
+    ->ArgNames({"assets", "daysObserved", "population"});
+
+namespace
+{
+
+//! Number of past days observed by the fixed-dimension benchmarks
+const size_t fixedDaysObserved = 5;
+
+/*!
+ * Time the action selection of a binary controller for the observation of a
+ * single-asset task observing fixedDaysObserved past days.
+ */
+template<class PolicyT>
+void binaryGetActionBenchmark(benchmark::State &state, PolicyT const &policy,
+                              AssetAllocationTask const &task)
+{
+    RealVec observation = bench::makeObservation(task);
+    RealVec action(policy.getDimAction());
+    for (auto _ : state)
+    {
+        policy.getAction(observation, action);
+        benchmark::DoNotOptimize(action.memptr());
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+/*!
+ * Action selection of the binary controller with dynamic storage.
+ */
+static void BM_BinaryGetAction(benchmark::State &state)
+{
+    AssetAllocationTask task = bench::makeTask(1, fixedDaysObserved);
+    BinaryPolicy policy(task.getDimObservation());
+    binaryGetActionBenchmark(state, policy, task);
+}
+BENCHMARK(BM_BinaryGetAction);
+
+/*!
+ * Action selection of the binary controller with fixed-dimension storage.
+ */
+static void BM_FixedBinaryGetAction(benchmark::State &state)
+{
+    AssetAllocationTask task = bench::makeTask(1, fixedDaysObserved);
+    FixedBinaryPolicy<AssetAllocationTask::dimObservationFor(1, fixedDaysObserved), 1> policy;
+    binaryGetActionBenchmark(state, policy, task);
+}
+BENCHMARK(BM_FixedBinaryGetAction);
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "bench_common.h"
+#include <thesis/NormalSampler.h>
+#include <thesis/Philox.h>
+#include <random>
+
+/*!
+ * Draw a matrix of standard normal variates (argument) with one call to the
+ * bulk Box-Muller sampler.
+ */
+static void BM_FillStandardNormal(benchmark::State &state)
+{
+    Philox4x32 generator(42, RandomStream::Global);
+    arma::vec values(state.range(0));
+    for (auto _ : state)
+    {
+        fillStandardNormal(generator, values);
+        benchmark::DoNotOptimize(values.memptr());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FillStandardNormal)->RangeMultiplier(8)->Range(8, 32768)->ArgName("size");
+
+/*!
+ * Same draw with a scalar std::normal_distribution, for comparison.
+ */
+static void BM_NormalDistribution(benchmark::State &state)
+{
+    Philox4x32 generator(42, RandomStream::Global);
+    std::normal_distribution<double> normal;
+    arma::vec values(state.range(0));
+    for (auto _ : state)
+    {
+        for (double &value : values)
+            value = normal(generator);
+        benchmark::DoNotOptimize(values.memptr());
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_NormalDistribution)->RangeMultiplier(8)->Range(8, 32768)->ArgName("size");
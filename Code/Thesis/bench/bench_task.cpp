@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "bench_common.h"
+#include <thesis/BatchAssetAllocationTask.h>
+#include <thesis/BinaryPolicy.h>
+
+/*!
+ * Observation of the asset allocation task, i.e. the vector passed to the
+ * agent at each interaction.
+ */
+static void BM_TaskGetObservation(benchmark::State &state)
+{
+    AssetAllocationTask task = bench::makeTask(state.range(0), state.range(1));
+    arma::vec observation(task.getDimObservation());
+    for (auto _ : state)
+    {
+        task.getObservation(observation);
+        benchmark::DoNotOptimize(observation.memptr());
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TaskGetObservation)->Apply(bench::assetsDaysSweep);
+
+/*!
+ * One market step of the asset allocation task: perform an allocation and
+ * compute the reward. The task is reset when the series is exhausted.
+ */
+static void BM_TaskGetReward(benchmark::State &state)
+{
+    size_t numDaysObserved = state.range(1);
+    AssetAllocationTask task = bench::makeTask(state.range(0), numDaysObserved);
+    arma::vec allocation(task.getDimAction());
+    allocation.fill(1.0 / task.getDimAction());
+    size_t const numSteps = bench::numDays - numDaysObserved - 1;
+    size_t step = 0;
+    for (auto _ : state)
+    {
+        if (step == numSteps)
+        {
+            state.PauseTiming();
+            task.reset();
+            step = 0;
+            state.ResumeTiming();
+        }
+        task.performAction(allocation);
+        benchmark::DoNotOptimize(task.getReward());
+        ++step;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TaskGetReward)->Apply(bench::assetsDaysSweep);
+BENCHMARK(BM_TaskGetReward)
+    ->ArgsProduct({{100, 1000}, {0}})
+    ->ArgNames({"assets", "daysObserved"});
+
+namespace
+{
+
+//! Number of past days observed by the batch benchmarks
+const size_t batchDaysObserved = 5;
+
+//! Start dates of a batch of trajectories on the synthetic market
+std::vector<size_t> batchStartDates(size_t batchSize)
+{
+    std::vector<size_t> startDates(batchSize);
+    for (size_t k = 0; k < batchSize; ++k)
+        startDates[k] = k;
+    return startDates;
+}
+
+} // namespace
+
+/*!
+ * One interaction step of a batch of trajectories (second argument) with a
+ * binary controller, stepped one trajectory at a time on separate tasks.
+ */
+static void BM_SeparateTasksStep(benchmark::State &state)
+{
+    size_t const batchSize = state.range(1);
+    MarketEnvironment market(bench::makeMarketData(state.range(0)));
+    std::vector<AssetAllocationTask> tasks;
+    for (size_t startDate : batchStartDates(batchSize))
+    {
+        MarketEnvironment trajectoryMarket(market);
+        trajectoryMarket.setEvaluationInterval(startDate, bench::numDays - 1);
+        tasks.emplace_back(trajectoryMarket, bench::riskFreeRate, bench::deltaP,
+                           bench::deltaF, bench::deltaS, batchDaysObserved);
+    }
+    BinaryPolicy policy(tasks.front().getDimObservation());
+    arma::vec observation(policy.getDimObservation());
+    arma::vec allocation(tasks.front().getDimAction());
+    RealVec realObservation, action;
+    size_t const numSteps = bench::numDays - batchDaysObserved - batchSize;
+    size_t step = 0;
+    for (auto _ : state)
+    {
+        if (step == numSteps)
+        {
+            state.PauseTiming();
+            for (AssetAllocationTask &task : tasks)
+                task.reset();
+            step = 0;
+            state.ResumeTiming();
+        }
+        for (AssetAllocationTask &task : tasks)
+        {
+            task.getObservation(observation);
+            convertTo(observation, realObservation);
+            policy.getAction(realObservation, action);
+            allocation.fill(action(0));
+            task.performAction(allocation);
+            benchmark::DoNotOptimize(task.getReward());
+        }
+        ++step;
+    }
+    state.SetItemsProcessed(state.iterations() * batchSize);
+}
+BENCHMARK(BM_SeparateTasksStep)
+    ->ArgsProduct({{1, 10}, {1, 16, 256}})
+    ->ArgNames({"assets", "batch"});
+
+/*!
+ * One interaction step of a batch of trajectories (second argument) with a
+ * binary controller, stepped in lockstep by a BatchAssetAllocationTask.
+ */
+static void BM_BatchTaskStep(benchmark::State &state)
+{
+    size_t const batchSize = state.range(1);
+    MarketEnvironment market(bench::makeMarketData(state.range(0)));
+    BatchAssetAllocationTask task(market, batchStartDates(batchSize),
+                                  bench::riskFreeRate, bench::deltaP,
+                                  bench::deltaF, bench::deltaS, batchDaysObserved);
+    BinaryPolicy policy(task.getDimObservation());
+    arma::mat observations(task.getDimObservation(), batchSize);
+    arma::mat allocations(task.getDimAction(), batchSize);
+    arma::vec rewards(batchSize);
+    RealMat realObservations, actions;
+    size_t const numSteps = bench::numDays - batchDaysObserved - batchSize;
+    size_t step = 0;
+    for (auto _ : state)
+    {
+        if (step == numSteps)
+        {
+            state.PauseTiming();
+            task.reset();
+            step = 0;
+            state.ResumeTiming();
+        }
+        task.getObservations(observations);
+        convertTo(observations, realObservations);
+        policy.getBatchActions(realObservations, actions);
+        for (size_t k = 0; k < batchSize; ++k)
+            allocations.col(k).fill(actions(0, k));
+        task.performActions(allocations);
+        task.getRewards(rewards);
+        benchmark::DoNotOptimize(rewards.memptr());
+        ++step;
+    }
+    state.SetItemsProcessed(state.iterations() * batchSize);
+}
+BENCHMARK(BM_BatchTaskStep)
+    ->ArgsProduct({{1, 10}, {1, 16, 256}})
+    ->ArgNames({"assets", "batch"});
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+//-----------------|
+// Common includes |
+//-----------------|
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <chrono>
+#include <getpot.h>
+#include <thesis/MarketEnvironment.h>
+
+/*!
+ * Helper function that prints usage of the converter.
+ */
+void printHelp()
+{
+  std::cout << "USAGE: convert_returns [-h] -i inputFile -o outputFile" << std::endl
+            << "-h this help" << std::endl
+            << "-i absolute path to the CSV file containing the return series" << std::endl
+            << "-o absolute path to the binary file that will be written" << std::endl
+            << std::endl;
+}
+
+/*!
+ * Convert a CSV return series to the binary memory-mappable format read by
+ * MarketEnvironment, and check that the conversion preserves the data.
+ */
+int main(int argc, char** argv)
+{
+    GetPot cl(argc, argv);
+    if( cl.search(2, "-h", "--help") || !cl.search(1, "-i") || !cl.search(1, "-o") )
+    {
+      printHelp();
+      return 0;
+    }
+    const std::string inputFile = cl.follow("", "-i");
+    const std::string outputFile = cl.follow("", "-o");
+
+    try
+    {
+        // Read CSV file
+        auto start = std::chrono::steady_clock::now();
+        MarketEnvironment csvMarket(inputFile);
+        auto end = std::chrono::steady_clock::now();
+        std::cout << ".. Read " << csvMarket.getNumDays() << " days x "
+                  << csvMarket.getNumRiskyAssets() << " assets from CSV in "
+                  << std::chrono::duration<double, std::milli>(end - start).count()
+                  << " ms" << std::endl;
+
+        // Write binary file
+        csvMarket.save(outputFile);
+
+        // Map binary file and check the returns
+        start = std::chrono::steady_clock::now();
+        MarketEnvironment binaryMarket(outputFile);
+        end = std::chrono::steady_clock::now();
+        std::cout << ".. Mapped binary file in "
+                  << std::chrono::duration<double, std::milli>(end - start).count()
+                  << " ms" << std::endl;
+
+        bool identical = binaryMarket.getAssetsSymbols() == csvMarket.getAssetsSymbols() &&
+                         binaryMarket.getNumDays() == csvMarket.getNumDays();
+        for (size_t t = 0; identical && t < csvMarket.getNumDays(); ++t)
+        {
+            identical = arma::approx_equal(csvMarket.getState(), binaryMarket.getState(), "absdiff", 0.0);
+            csvMarket.performAction(arma::vec());
+            binaryMarket.performAction(arma::vec());
+        }
+        if (!identical)
+        {
+            std::cerr << "ERROR: binary file " << outputFile << " differs from " << inputFile << std::endl;
+            return 1;
+        }
+        std::cout << ".. Written " << outputFile << std::endl;
+    }
+    catch (std::exception const &e)
+    {
+        std::cerr << "ERROR: " << e.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
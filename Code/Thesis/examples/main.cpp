@@ -89,6 +89,8 @@ int main()
     size_t numEpochs = params.numEpochs;
     size_t numTrainingSteps = params.numTrainingSteps;
     size_t numTestSteps = params.numTestSteps;
+    size_t numThreads = params.numThreads;
+    unsigned int seed = params.seed;
 
     //-------------------|
     // 2) Initialization |
@@ -150,7 +152,10 @@ int main()
                                          numTrainingSteps,
                                          numTestSteps,
                                          outputDir,
-                                         debugDir);
+                                         debugDir,
+                                         numThreads,
+                                         seed,
+                                         BacktestLog::formatFromString(params.backtestFormat));
     std::cout << "done" << std::endl;
 
     //-------------------|
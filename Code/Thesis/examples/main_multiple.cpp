@@ -32,6 +32,7 @@
 #include <memory>
 #include <thesis/ExperimentParameters.h>
 #include <thesis/MarketEnvironment.h>
+#include <thesis/SyntheticMarketEnvironment.h>
 #include <thesis/AssetAllocationTask.h>
 #include <thesis/Agent.h>
 #include <thesis/AssetAllocationExperiment.h>
@@ -119,6 +120,8 @@ int main(int argc, char** argv)
     size_t numEpochs = params.numEpochs;
     size_t numTrainingSteps = params.numTrainingSteps;
     size_t numTestSteps = params.numTestSteps;
+    size_t numThreads = params.numThreads;
+    unsigned int seed = params.seed;
 
     //-------------------|
     // 2) Initialization |
@@ -129,9 +132,14 @@ int main(int argc, char** argv)
     // 2.1) Market and Task |
     //----------------------|
 
-	// Market
+	// Market, either historical or simulated on the fly
 	std::cout << ".. Market environment - ";
-	MarketEnvironment market(inputFile);
+	std::unique_ptr<MarketEnvironment> marketPtr;
+	if (params.market == "historical")
+		marketPtr.reset(new MarketEnvironment(inputFile));
+	else
+		marketPtr = makeSyntheticMarketEnvironment(params.market, params.numSyntheticDays, seed);
+	MarketEnvironment &market = *marketPtr;
     size_t startDate = 0;
 	size_t endDate = numDaysObserved + numTrainingSteps + numTestSteps - 1;
     market.setEvaluationInterval(startDate, endDate);
@@ -163,7 +171,11 @@ int main(int argc, char** argv)
                                                                 baselineLearningRate,
                                                                 criticLearningRate,
                                                                 actorLearningRate,
-                                                                lambda));
+                                                                lambda,
+                                                                params.covariance,
+                                                                params.covarianceRank,
+                                                                params.covarianceBlockSize,
+                                                                params.populationSize));
 
     // Pointer to Agent for poymorphic object handling
     std::unique_ptr<Agent> agentPtr = factory.make(algorithm);
@@ -180,7 +192,14 @@ int main(int argc, char** argv)
                                          numTrainingSteps,
                                          numTestSteps,
                                          outputDir,
-                                         debugDir);
+                                         debugDir,
+                                         numThreads,
+                                         seed,
+                                         BacktestLog::formatFromString(params.backtestFormat));
+    experiment.setCheckpointing(params.checkpointDir.empty() ? debugDir : params.checkpointDir,
+                                params.checkpointInterval);
+    experiment.setWarmStart(params.warmStart);
+    experiment.setActorLearner(params.numActorThreads, params.actorBatchSize);
     std::cout << "done" << std::endl;
 
     //-------------------|
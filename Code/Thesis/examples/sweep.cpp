@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+//-----------------|
+// Common includes |
+//-----------------|
+
+#include <iostream>
+#include <string>
+#include <getpot.h>
+#include <thesis/ExperimentParameters.h>
+#include <thesis/ParameterSweep.h>
+#include <thesis/WorkStealingPool.h>
+
+/*!
+ * Helper function that prints usage of the sweep executable.
+ */
+void printHelp()
+{
+  std::cout << "USAGE: sweep [-h] -p parametersFile -g gridFile -i inputFile -o outputDirectory -d debugDirectory" << std::endl
+            << "-h this help" << std::endl
+            << "-p absolute path to the file containing the base experiment parameters" << std::endl
+            << "-g absolute path to the file containing the grid of parameters and algorithms" << std::endl
+            << "-i absolute path to the file containing the return series" << std::endl
+            << "-o absolute path to the base directory where the output files will be written." << std::endl
+            << "-d absolute path to the base directory where the debug files will be written." << std::endl
+            << std::endl;
+}
+
+/*!
+ * Main function. It reads the base parameters and the grid from file, then
+ * runs all the jobs of the grid on a single pool of numThreads workers.
+ */
+
+int main(int argc, char** argv)
+{
+    GetPot cl(argc, argv);
+    if( cl.search(2, "-h", "--help") )
+    {
+      printHelp();
+      return 0;
+    }
+
+    std::cout << "----------------------------------------------" << std::endl;
+    std::cout << "-        Algorithmic Asset Allocation        -" << std::endl;
+    std::cout << "----------------------------------------------" << std::endl;
+    std::cout << std::endl;
+
+    // Get files with base parameter values and grid
+    const std::string parametersFilepath = cl.follow("~/Documents/University/6_Anno_Poli/7_Thesis/Data/Parameters/parameters.pot", "-p");
+    const std::string gridFilepath = cl.follow("~/Documents/University/6_Anno_Poli/7_Thesis/Data/Parameters/grid.pot", "-g");
+
+    // Read input file path
+    const std::string inputFile = cl.follow("~/Documents/University/6_Anno_Poli/7_Thesis/Data/Input/synthetic.csv", "-i");
+
+    // Read output and debug base directories
+    const std::string outputDir = cl.follow("~/Documents/University/6_Anno_Poli/7_Thesis/Data/Output/", "-o");
+    const std::string debugDir = cl.follow("~/Documents/University/6_Anno_Poli/7_Thesis/Data/Debug/", "-d");
+
+    // Read parameters and grid
+    const ExperimentParameters params(parametersFilepath, true);
+    ParameterSweep sweep(params, gridFilepath, inputFile, outputDir, debugDir);
+
+    // Run the sweep
+    WorkStealingPool pool(params.numThreads);
+    sweep.run(pool);
+
+	return 0;
+}
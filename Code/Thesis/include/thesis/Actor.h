@@ -23,6 +23,7 @@
 #ifndef ACTOR_H
 #define ACTOR_H
 
+#include <thesis/Precision.h>
 #include <armadillo>
 #include <memory>
 
@@ -46,7 +47,21 @@ class Actor
          * \param observation_ observation of the system
          * \return an action
          */
-        virtual arma::vec getAction(arma::vec const &observation_) const = 0;
+        RealVec getAction(RealVec const &observation_) const
+        {
+            RealVec action(getDimAction());
+            getAction(observation_, action);
+            return action;
+        }
+
+        /*!
+         * Select action given an observation of the system and write it in a
+         * preallocated vector.
+         * \param observation_ observation of the system
+         * \param action_ output action, resized if needed
+         */
+        virtual void getAction(RealVec const &observation_,
+                               RealVec &action_) const = 0;
 };
 
 
@@ -0,0 +1,82 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef ACTORLEARNERAGENT_H
+#define ACTORLEARNERAGENT_H
+
+#include <thesis/Agent.h>      /* Agent */
+#include <thesis/Precision.h>  /* RealVec */
+#include <armadillo>           /* arma::vec */
+
+/**
+ * ActorLearnerAgent is the interface of the agents that can be trained by an
+ * AsyncActorLearner, i.e. the actor-critic agents whose learning step only
+ * depends on a transition (O_t, A_t, R_{t+1}, O_{t+1}). The actor threads act
+ * with clones of the agent whose actor parameters are refreshed from the
+ * learner, while the learner replays the transitions they collected through
+ * the usual receive and learn methods, the action being passed with
+ * receiveBehaviourAction instead of being selected by getAction.
+ */
+
+class ActorLearnerAgent : public Agent
+{
+    public:
+        //! Virtual destructor
+        virtual ~ActorLearnerAgent() = default;
+
+        /*!
+         * Get the actor parameters, i.e. the policy snapshot published to the
+         * actor threads.
+         * \param parameters_ output parameters, resized if needed.
+         */
+        virtual void getActorParameters(RealVec &parameters_) const=0;
+
+        /*!
+         * Set the actor parameters from a policy snapshot.
+         * \param parameters_ actor parameters.
+         */
+        virtual void setActorParameters(RealVec const &parameters_)=0;
+
+        /*!
+         * Receive action A_t selected by another copy of the agent, e.g. by an
+         * actor thread, in place of calling getAction. The next learning step
+         * scores this action for the last observation received.
+         * \param action_ action performed on the system.
+         */
+        virtual void receiveBehaviourAction(arma::vec const &action_)=0;
+
+        /*!
+         * Check whether the agent can learn from the actions passed with
+         * receiveBehaviourAction, which requires the policy to score the
+         * actions selected by another copy of it.
+         * \return true if the agent can be trained asynchronously.
+         */
+        virtual bool supportsBehaviourActions() const=0;
+
+        /*!
+         * Reset the eligibility traces, e.g. when the next transitions do not
+         * follow the last ones on the same trajectory.
+         */
+        virtual void resetTraces()=0;
+};
+
+#endif /* end of include guard: ACTORLEARNERAGENT_H */
@@ -23,8 +23,10 @@
 #ifndef AGENT_H
 #define AGENT_H
 
+#include <thesis/Checkpoint.h>
 #include <armadillo>
 #include <memory>
+#include <stdexcept>
 
 /*!
  * An Agent is an entity capable of producing actions based on previous
@@ -66,7 +68,19 @@ class Agent
          * agent and an environment.
          * \return action action selected by the agent.
          */
-        virtual arma::vec getAction()=0;
+        arma::vec getAction()
+        {
+            arma::vec action(getDimAction());
+            getAction(action);
+            return action;
+        }
+
+        /*!
+         * Get action A_t in a preallocated vector. This is the
+         * allocation-free variant used in the interaction loop.
+         * \param action_ output action, resized if needed.
+         */
+        virtual void getAction(arma::vec &action_)=0;
 
         /*!
          * Receive reward R_{t+1} from the system. This reward will be typically
@@ -75,6 +89,31 @@ class Agent
          */
         virtual void receiveReward(double reward_)=0;
 
+        /*!
+         * Get the number of candidate actions selected by the agent at each
+         * step. Agents in population mode evaluate several policies on the
+         * same observation and perform the first candidate action.
+         * \return population size, 1 for agents without population mode.
+         */
+        virtual size_t getPopulationSize() const { return 1; }
+
+        /*!
+         * Get the candidate actions selected at the current step.
+         * \param actions_ output actions, one per column, resized if needed.
+         */
+        virtual void getPopulationActions(arma::mat &actions_) const
+        {
+            throw std::logic_error("Agent does not evaluate a population of policies");
+        }
+
+        /*!
+         * Receive the rewards R_{t+1} that the candidate actions would have
+         * earned on the last transition. The first one is the reward of the
+         * performed action, also passed to receiveReward.
+         * \param rewards_ rewards of the candidate actions.
+         */
+        virtual void receivePopulationRewards(arma::vec const &rewards_) {}
+
         /*!
          * Receive observation O_{t+1} of the system state after the transition
          * induced by the action selected by the agent. This observation is
@@ -103,6 +142,32 @@ class Agent
          * reset the agent before a new independent learning experiment starts.
          */
         virtual void reset()=0;
+
+        /*!
+         * Seed the random number generators used by the agent. Two agents
+         * seeded with the same value and fed with the same observations select
+         * the same sequence of actions. This is used to give each independent
+         * experiment its own reproducible random stream.
+         * \param seed_ seed of the random number generators.
+         */
+        virtual void seed(unsigned int seed_)=0;
+
+        /*!
+         * Write the learning state of the agent to a snapshot, i.e. everything
+         * that carries over from one epoch to the next: parameters, baselines,
+         * eligibility traces, learning rate schedules and random generators.
+         * Loading the snapshot into an agent with the same structure resumes
+         * the learning process exactly where it stopped.
+         * \param writer_ snapshot writer.
+         */
+        virtual void saveState(CheckpointWriter &writer_) const=0;
+
+        /*!
+         * Read the learning state of the agent from a snapshot written by
+         * saveState.
+         * \param reader_ snapshot reader.
+         */
+        virtual void loadState(CheckpointReader &reader_)=0;
 };
 
 #endif /* end of include guard: AGENT_H */
@@ -81,13 +81,15 @@ class ARAgent : public Agent
         //! Get action size
         virtual size_t getDimAction() const { return actor.getDimAction(); }
 
+        using Agent::getAction;
+
         /*!
          * Get action A_t to be performed on the system. This action will be
          * passed to a task object, which manages the interaction between an
          * agent and an environment.
-         * \return action action selected by the agent.
+         * \param action_ output action selected by the agent.
          */
-        virtual arma::vec getAction();
+        virtual void getAction(arma::vec &action_);
 
         /*!
          * Receive reward R_{t+1} from the system. This reward will be typically
@@ -125,6 +127,25 @@ class ARAgent : public Agent
          */
         virtual void reset();
 
+        /*!
+         * Seed the random number generators used by the agent.
+         * \param seed_ seed of the random number generators.
+         */
+        virtual void seed(unsigned int seed_);
+
+        /*!
+         * Write the baseline, the actor, the learning rates and the eligibility
+         * trace to a snapshot.
+         * \param writer_ snapshot writer
+         */
+        virtual void saveState(CheckpointWriter &writer_) const;
+
+        /*!
+         * Read the learning state from a snapshot written by saveState.
+         * \param reader_ snapshot reader
+         */
+        virtual void loadState(CheckpointReader &reader_);
+
     private:
         /*!
          * Average reward baseline. It simply consists of a moving average of
@@ -148,13 +169,17 @@ class ARAgent : public Agent
         double lambda;
 
         //! Cache vectors for the actor gradient.
-        arma::vec gradientActor;
+        RealVec gradientActor;
+
+        //! Cache vectors for the likelihood score and the actor parameters.
+        RealVec likelihoodScoreCache;
+        RealVec actorParameters;
 
         //! Cache variables for observations, action and reward.
-        arma::vec observation;
-        arma::vec action;
+        RealVec observation;
+        RealVec action;
         double reward;
-        arma::vec nextObservation;
+        RealVec nextObservation;
 };
 
 #endif // ARAGENT_H
@@ -23,10 +23,13 @@
 #ifndef ARACAGENT_H
 #define ARACAGENT_H
 
-#include <thesis/Agent.h>            /* Agent */
+#include <thesis/ActorLearnerAgent.h> /* ActorLearnerAgent */
 #include <thesis/StochasticActor.h>  /* StochasticActor */
 #include <thesis/Critic.h>           /* Critic */
 #include <thesis/LearningRate.h>     /* LearningRate */
+#include <thesis/BoltzmannPolicy.h>  /* BoltzmannPolicy */
+#include <thesis/PgpePolicy.h>       /* PGPEPolicy */
+#include <thesis/LinearRegressor.h>  /* LinearRegressor */
 #include <armadillo>                 /* arma::vec */
 #include <memory>                    /* std::unique_ptr */
 
@@ -37,9 +40,16 @@
  * policy gradient theorem where a parametric critic is used to estimate the
  * state-value function and reduce the variance of the gradient estimate. For
  * more information on the algorithm, please refer to the report.
+ *
+ * The agent is a template on the types of its actor and critic. ARACAgent
+ * composes any stochastic policy and function approximator through virtual
+ * calls, while the agents built by FactoryOfAgents, e.g. BoltzmannARACAgent,
+ * fix the concrete classes, so that the learning step calls them directly.
+ * All the variants share the same learning rule and produce the same results.
  */
 
-class ARACAgent : public Agent
+template<class ActorT, class CriticT>
+class BasicARACAgent final : public ActorLearnerAgent
 {
     public:
         /*!
@@ -54,21 +64,21 @@ class ARACAgent : public Agent
          * \param actorLearningRate_ learning rate used to update the actor.
          * \param lambda_ lambda factor for eligibility traces.
          */
-        ARACAgent(StochasticActor const & actor_,
-                  Critic const & critic_,
-                  LearningRate const & baselineLearningRate_,
-                  LearningRate const & criticLearningRate_,
-                  LearningRate const & actorLearningRate_,
-                  double lambda_=0.5);
+        BasicARACAgent(ActorT const & actor_,
+                       CriticT const & critic_,
+                       LearningRate const & baselineLearningRate_,
+                       LearningRate const & criticLearningRate_,
+                       LearningRate const & actorLearningRate_,
+                       double lambda_=0.5);
 
         /*!
          * Copy constructor.
          * \param other_ ARACAgent object to copy.
          */
-        ARACAgent(ARACAgent const & other_);
+        BasicARACAgent(BasicARACAgent const & other_);
 
         //! Default destructor
-        virtual ~ARACAgent() = default;
+        virtual ~BasicARACAgent() = default;
 
         /*!
          * Clone method.
@@ -90,13 +100,15 @@ class ARACAgent : public Agent
         //! Get action size
         virtual size_t getDimAction() const { return actor.getDimAction(); }
 
+        using Agent::getAction;
+
         /*!
          * Get action A_t to be performed on the system. This action will be
          * passed to a task object, which manages the interaction between an
          * agent and an environment.
-         * \return action action selected by the agent.
+         * \param action_ output action selected by the agent.
          */
-        virtual arma::vec getAction();
+        virtual void getAction(arma::vec &action_);
 
         /*!
          * Receive reward R_{t+1} from the system. This reward will be typically
@@ -114,6 +126,34 @@ class ARACAgent : public Agent
          */
         virtual void receiveNextObservation(arma::vec const &nextObservation_);
 
+        /*!
+         * Get the actor parameters published to the actor threads.
+         * \param parameters_ output parameters, resized if needed.
+         */
+        virtual void getActorParameters(RealVec &parameters_) const
+            { actor.getParameters(parameters_); }
+
+        /*!
+         * Set the actor parameters from a policy snapshot.
+         * \param parameters_ actor parameters.
+         */
+        virtual void setActorParameters(RealVec const &parameters_)
+            { actor.setParameters(parameters_); }
+
+        /*!
+         * Receive action A_t selected by an actor thread in place of calling
+         * getAction.
+         * \param action_ action performed on the system.
+         */
+        virtual void receiveBehaviourAction(arma::vec const &action_);
+
+        //! Check whether the actor can score the actions of an actor thread.
+        virtual bool supportsBehaviourActions() const
+            { return actor.supportsBehaviourScore(); }
+
+        //! Reset the eligibility traces of the critic and of the actor.
+        virtual void resetTraces();
+
         /*!
          * Learning step given previous experience. The agent modifies its
          * behavior to improve his performance on the task. This is the core of
@@ -134,6 +174,25 @@ class ARACAgent : public Agent
          */
         virtual void reset();
 
+        /*!
+         * Seed the random number generators used by the agent.
+         * \param seed_ seed of the random number generators.
+         */
+        virtual void seed(unsigned int seed_);
+
+        /*!
+         * Write the baseline, the critic, the actor, the learning rates and the
+         * eligibility traces to a snapshot.
+         * \param writer_ snapshot writer
+         */
+        virtual void saveState(CheckpointWriter &writer_) const;
+
+        /*!
+         * Read the learning state from a snapshot written by saveState.
+         * \param reader_ snapshot reader
+         */
+        virtual void loadState(CheckpointReader &reader_);
+
     private:
         /*!
          * Average reward baseline. It simply consists of a moving average of
@@ -146,12 +205,12 @@ class ARACAgent : public Agent
          * State-value function critic used to reduce the policy gradient
          * estimate variance.
          */
-        Critic critic;
+        CriticT critic;
 
         /*!
          * Stochastic actor used for selecting actions.
          */
-        StochasticActor actor;
+        ActorT actor;
 
         //! Learning rate used in the baseline update rule.
         std::unique_ptr<LearningRate> baselineLearningRatePtr;
@@ -166,14 +225,34 @@ class ARACAgent : public Agent
         double lambda;
 
         //! Cache vectors for the actor and the critic gradients.
-        arma::vec gradientCritic;
-        arma::vec gradientActor;
+        RealVec gradientCritic;
+        RealVec gradientActor;
+
+        //! Cache vectors for the score functions and the parameters.
+        RealVec criticGradientCache;
+        RealVec likelihoodScoreCache;
+        RealVec criticParameters;
+        RealVec actorParameters;
 
         //! Cache variables for observations, action and reward.
-        arma::vec observation;
-        arma::vec action;
+        RealVec observation;
+        RealVec action;
         double reward;
-        arma::vec nextObservation;
+        RealVec nextObservation;
+
+        //! True if the cached action was received from an actor thread.
+        bool behaviourAction;
 };
 
+//! ARAC agent on any stochastic policy and critic
+typedef BasicARACAgent<StochasticActor, Critic> ARACAgent;
+
+//! ARAC agent on a Boltzmann policy and a linear critic
+typedef BasicARACAgent<BasicStochasticActor<BoltzmannPolicy>,
+                       BasicCritic<LinearRegressor>> BoltzmannARACAgent;
+
+//! ARAC agent on a PGPE policy and a linear critic
+typedef BasicARACAgent<BasicStochasticActor<PGPEPolicy>,
+                       BasicCritic<LinearRegressor>> PGPEARACAgent;
+
 #endif // ARACAGENT_H
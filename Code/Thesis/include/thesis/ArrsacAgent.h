@@ -23,7 +23,7 @@
 #ifndef ARRSACAGENT_H
 #define ARRSACAGENT_H
 
-#include <thesis/Agent.h>
+#include <thesis/ActorLearnerAgent.h>
 #include <thesis/StochasticActor.h>
 #include <thesis/Critic.h>
 #include <thesis/LearningRate.h>
@@ -42,7 +42,7 @@
 
 // TODO: Implement also mean-variance optimization criterion. use templatization?
 
-class ARRSACAgent : public Agent
+class ARRSACAgent : public ActorLearnerAgent
 {
     public:
         /*!
@@ -91,13 +91,15 @@ class ARRSACAgent : public Agent
         //! Get action size
         virtual size_t getDimAction() const { return actor.getDimAction(); }
 
+        using Agent::getAction;
+
         /*!
          * Get action A_t to be performed on the system. This action will be
          * passed to a task object, which manages the interaction between an
          * agent and an environment.
-         * \return action action selected by the agent.
+         * \param action_ output action selected by the agent.
          */
-        virtual arma::vec getAction();
+        virtual void getAction(arma::vec &action_);
 
         /*!
          * Receive reward R_{t+1} from the system. This reward will be typically
@@ -115,6 +117,34 @@ class ARRSACAgent : public Agent
          */
         virtual void receiveNextObservation(arma::vec const &nextObservation_);
 
+        /*!
+         * Get the actor parameters published to the actor threads.
+         * \param parameters_ output parameters, resized if needed.
+         */
+        virtual void getActorParameters(RealVec &parameters_) const
+            { actor.getParameters(parameters_); }
+
+        /*!
+         * Set the actor parameters from a policy snapshot.
+         * \param parameters_ actor parameters.
+         */
+        virtual void setActorParameters(RealVec const &parameters_)
+            { actor.setParameters(parameters_); }
+
+        /*!
+         * Receive action A_t selected by an actor thread in place of calling
+         * getAction.
+         * \param action_ action performed on the system.
+         */
+        virtual void receiveBehaviourAction(arma::vec const &action_);
+
+        //! Check whether the actor can score the actions of an actor thread.
+        virtual bool supportsBehaviourActions() const
+            { return actor.supportsBehaviourScore(); }
+
+        //! Reset the eligibility trace of the Sharpe ratio gradient.
+        virtual void resetTraces();
+
         /*!
          * Learning step given previous experience. The agent modifies its
          * behavior to improve his performance on the task. This is the core of
@@ -135,6 +165,25 @@ class ARRSACAgent : public Agent
          */
         virtual void reset();
 
+        /*!
+         * Seed the random number generators used by the agent.
+         * \param seed_ seed of the random number generators.
+         */
+        virtual void seed(unsigned int seed_);
+
+        /*!
+         * Write the baselines, the critics, the actor, the learning rates and the
+         * eligibility traces to a snapshot.
+         * \param writer_ snapshot writer
+         */
+        virtual void saveState(CheckpointWriter &writer_) const;
+
+        /*!
+         * Read the learning state from a snapshot written by saveState.
+         * \param reader_ snapshot reader
+         */
+        virtual void loadState(CheckpointReader &reader_);
+
     private:
         /*!
          * Average reward baseline. It simply consists of a moving average of
@@ -180,17 +229,23 @@ class ARRSACAgent : public Agent
         double lambda;
 
         //! Cache vectors for the actor and the critic gradients.
-        arma::vec gradientCriticV;
-        arma::vec gradientCriticU;
-        arma::vec gradientActor;
-        arma::vec gradientSharpe;
+        RealVec gradientCriticV;
+        RealVec gradientCriticU;
+        RealVec gradientActor;
+        RealVec gradientSharpe;
+
+        //! Cache vector for the actor parameters.
+        RealVec actorParameters;
 
         //! Cache variables for observations, action and reward.
-        arma::vec observation;
-        arma::vec action;
+        RealVec observation;
+        RealVec action;
         double reward;
         double rewardSquared;
-        arma::vec nextObservation;
+        RealVec nextObservation;
+
+        //! True if the cached action was received from an actor thread.
+        bool behaviourAction;
 };
 
 #endif // ARRSACAGENT_H
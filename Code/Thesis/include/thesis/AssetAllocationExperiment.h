@@ -26,11 +26,18 @@
 #include <thesis/Experiment.h>
 #include <thesis/AssetAllocationTask.h>
 #include <thesis/Agent.h>
+#include <thesis/AsyncActorLearner.h>
 #include <thesis/BacktestLog.h>
+#include <thesis/Checkpoint.h>
+#include <thesis/PhaseTimer.h>
 #include <thesis/Statistics.h>
+#include <thesis/WorkStealingPool.h>
 #include <armadillo>
+#include <fstream>
+#include <functional>
 #include <memory>
 #include <string>
+#include <vector>
 
 
 /**
@@ -38,6 +45,37 @@
  * manages the interactions between the AssetAllocationTask and a trading agent
  * and is responsible for logging the strategy backtest performance for multiple
  * independent experiments.
+ *
+ * The task and the agent passed to the constructor are used as prototypes:
+ * each independent experiment runs on its own clones and on its own random
+ * stream, derived from the experiment seed and the experiment index. Hence the
+ * experiments can be executed concurrently on a thread pool and the results
+ * do not depend on the number of threads.
+ *
+ * In walk-forward mode, the full history of the market is sliced into rolling
+ * windows of numDaysObserved + numTrainingSteps + numTestSteps days, shifted
+ * by numTestSteps days, so that the test periods of consecutive windows are
+ * adjacent. Every window trains and tests a fresh agent independently, hence
+ * all the windows run concurrently, and the out-of-sample periods are then
+ * stitched into one continuous backtest per experiment.
+ *
+ * Long runs can be checkpointed: every checkpointInterval epochs, each
+ * experiment (or window) overwrites its snapshot, which stores the epoch
+ * reached, the agent learning state and its random generators. A run started
+ * again with the same parameters resumes each experiment from its snapshot and
+ * produces the same results as an uninterrupted run. Once the backtest of an
+ * experiment is written, its snapshot is marked as completed and the
+ * experiment is skipped on resume. Completed snapshots also hold the trained
+ * agents, which can warm-start new runs.
+ *
+ * Along with the backtest of each experiment, a one-line summary of its
+ * performance statistics (see StatisticsBacktest) is written to
+ * experimentN_summary.csv in the output directory.
+ *
+ * When the library is built with THESIS_PROFILING defined, the time spent in
+ * each phase of the interaction loop is written next to the convergence trace
+ * of each run, e.g. experimentN_profile.csv, with one line per epoch, one for
+ * the backtest and one for the whole run.
  */
 
 class AssetAllocationExperiment : public Experiment
@@ -55,6 +93,10 @@ class AssetAllocationExperiment : public Experiment
          * \param numTestSteps_ number of test steps per experiment.
          * \param outputDir_ directory where output files will be written
          * \param debugDir_ directory where debug files will be written
+         * \param numThreads_ number of threads running the experiments
+         *        (0 = number of hardware threads).
+         * \param seed_ seed of the random number generators.
+         * \param backtestFormat_ encoding of the backtest log files.
          */
         AssetAllocationExperiment(AssetAllocationTask const &task_,
                                   Agent const &agent_,
@@ -63,7 +105,10 @@ class AssetAllocationExperiment : public Experiment
                                   size_t const &numTrainingSteps_,
                                   size_t const &numTestSteps_,
                                   std::string const &outputDir_,
-                                  std::string const &debugDir_);
+                                  std::string const &debugDir_,
+                                  size_t const &numThreads_ = 1,
+                                  unsigned int seed_ = 0,
+                                  BacktestLog::Format backtestFormat_ = BacktestLog::Format::Csv);
 
         //! Copy constructor
         AssetAllocationExperiment(AssetAllocationExperiment const &other_);
@@ -74,18 +119,246 @@ class AssetAllocationExperiment : public Experiment
         //! Clone method
         virtual std::unique_ptr<Experiment> clone() const;
 
-        //! Run experiment
+        //! Run all the independent experiments
         void run();
 
+        //! Run all the independent experiments in walk-forward mode
+        void runWalkForward();
+
+        /*!
+         * Enable periodic snapshots of the learning process.
+         * \param checkpointDir_ directory where snapshot files will be written.
+         * \param checkpointInterval_ number of epochs between two snapshots
+         *        (0 = no snapshots).
+         */
+        void setCheckpointing(std::string const &checkpointDir_,
+                              size_t checkpointInterval_);
+
+        /*!
+         * Start the training of every experiment from the agent stored in a
+         * snapshot instead of a freshly initialized one. The agent keeps the
+         * learned parameters and learning rate schedules, while its random
+         * generators are seeded again for each experiment.
+         * \param filename_ path to the snapshot file ("" = no warm start).
+         */
+        void setWarmStart(std::string const &filename_);
+
+        /*!
+         * Run the independent experiments on a shared pool instead of a pool
+         * of numThreads threads owned by the experiment. This lets several
+         * experiments, e.g. the jobs of a parameter sweep, share the machine.
+         * \param pool_ shared pool, nullptr to use an own pool.
+         */
+        void setThreadPool(WorkStealingPool *pool_);
+
+        /*!
+         * Train the agent with an AsyncActorLearner instead of the synchronous
+         * interaction loop: numActorThreads_ actor threads roll out the task
+         * with a snapshot of the policy, while the experiment thread learns
+         * from their transitions. Each actor performs numTrainingSteps
+         * interactions per epoch. The training is not reproducible in this
+         * mode, while the backtest is still run synchronously.
+         * \param numActorThreads_ number of actor threads (0 = synchronous).
+         * \param actorBatchSize_ number of transitions per batch.
+         * \throw std::invalid_argument if the agent cannot learn from the
+         *        actions selected by the actor threads, e.g. PGPE agents.
+         */
+        void setActorLearner(size_t numActorThreads_, size_t actorBatchSize_);
+
+        /*!
+         * Run one synchronous training epoch on the task and agent owned by
+         * this object: reset the task and the convergence statistics, signal
+         * the new epoch to the agent and run the training steps. This is the
+         * epoch executed by run(), exposed for the benchmarks of the
+         * interaction loop.
+         */
+        void trainingEpoch();
+
+        /*!
+         * Run backtest steps on the task and agent owned by this object and
+         * insert their records in the backtest log, as done by run() after the
+         * training. Without an open output file the records only update the
+         * backtest statistics.
+         * \param numSteps_ number of backtest steps.
+         */
+        void backtestSteps(size_t numSteps_);
+
     private:
+        //! Out-of-sample records of a walk-forward window
+        struct WindowBacktest
+        {
+            arma::mat states;
+            arma::mat actions;
+            arma::vec rewards;
+        };
+
+        /*!
+         * Run independent jobs, on the shared pool if any, otherwise serially
+         * or on a thread pool of numThreads threads, and rethrow the first
+         * failure, if any.
+         * \param numJobs number of jobs.
+         * \param job function executing a job given its index.
+         */
+        void runJobs(size_t numJobs, std::function<void(size_t)> const &job) const;
+
+        /*!
+         * Run a single independent experiment, i.e. train the agent for
+         * numEpochs epochs and backtest it for numTestSteps steps. The task
+         * and the agent owned by this object are modified, hence the method is
+         * called on a copy of the prototype experiment.
+         * \param exp index of the experiment.
+         */
+        void runExperiment(size_t exp);
+
+        /*!
+         * Run a walk-forward window of an experiment, i.e. restrict the task
+         * to the window, train the agent on its first part and backtest it on
+         * the last numTestSteps days. Like runExperiment, the method is called
+         * on a copy of the prototype experiment.
+         * \param exp index of the experiment.
+         * \param window index of the window.
+         * \param backtest output out-of-sample records.
+         */
+        void runWindow(size_t exp, size_t window, WindowBacktest &backtest);
+
+        /*!
+         * Seed the random number generators, reset the agent and train it for
+         * numEpochs epochs, logging the convergence statistics. If a snapshot
+         * of the run exists, the training resumes from it.
+         * \param trainingSeed seed of the random number generators.
+         * \param name name of the run printed on the console.
+         * \param debugFilename path to the convergence debug file.
+         * \param checkpointFilename path to the snapshot file of the run
+         *        ("" = no snapshots).
+         */
+        void train(unsigned int trainingSeed,
+                   std::string const &name,
+                   std::string const &debugFilename,
+                   std::string const &checkpointFilename);
+
+        /*!
+         * Run one training epoch, with the actor threads of the asynchronous
+         * training if any, otherwise with the synchronous interaction loop.
+         * \param actorLearner actor threads, nullptr for synchronous training.
+         */
+        void trainingEpoch(AsyncActorLearner *actorLearner);
+
+        /*!
+         * Path to the snapshot file of a run, empty if checkpointing is
+         * disabled.
+         * \param runName name of the run, e.g. "experiment3".
+         * \return path to the snapshot file.
+         */
+        std::string checkpointPath(std::string const &runName) const;
+
+        /*!
+         * Write a snapshot of the learning process.
+         * \param filename path to the snapshot file.
+         * \param trainingSeed seed of the run, used to identify it.
+         * \param epochsCompleted number of completed epochs, numEpochs for a
+         *        completed run.
+         */
+        void saveCheckpoint(std::string const &filename,
+                            unsigned int trainingSeed,
+                            size_t epochsCompleted) const;
+
+        /*!
+         * Read the header of a snapshot and check that it belongs to the run.
+         * \param reader snapshot reader.
+         * \param trainingSeed seed of the run.
+         * \return number of completed epochs.
+         */
+        size_t readCheckpointHeader(CheckpointReader &reader,
+                                    unsigned int trainingSeed) const;
+
+        /*!
+         * Check if the snapshot of a run marks it as completed.
+         * \param filename path to the snapshot file ("" = no snapshot).
+         * \param trainingSeed seed of the run.
+         * \return true if the run was completed.
+         */
+        bool isCompleted(std::string const &filename,
+                         unsigned int trainingSeed) const;
+
+        /*!
+         * Restore the learning process from a snapshot.
+         * \param filename path to the snapshot file.
+         * \param trainingSeed seed of the run.
+         * \return number of completed epochs.
+         */
+        size_t loadCheckpoint(std::string const &filename,
+                              unsigned int trainingSeed);
+
+        /*!
+         * Select the interaction loop matching the dynamic type of the agent.
+         * The agents built by FactoryOfAgents run on a loop instantiated for
+         * their concrete type, whose calls are resolved at compile time, any
+         * other agent on the loop instantiated for the Agent interface.
+         */
+        void selectInteractionLoop();
+
+        /*!
+         * Select the interaction loop instantiated for a given agent type.
+         * \tparam AgentT concrete type of the agent, or Agent.
+         * \return true if the agent is of type AgentT.
+         */
+        template<class AgentT>
+        bool useInteractionLoop();
+
+        /*!
+         * Run the numTrainingSteps steps of a training epoch, each one made of
+         * an interaction and a learning step.
+         * \tparam AgentT concrete type of the agent, or Agent.
+         */
+        template<class AgentT>
+        void trainingSteps();
+
+        /*!
+         * One backtest step: interaction, learning and state caching.
+         * \tparam AgentT concrete type of the agent, or Agent.
+         */
+        template<class AgentT>
+        void testStep();
+
+        /*!
+         * Close the backtest log and write the summary of its statistics.
+         * \param exp index of the experiment.
+         */
+        void closeBacktest(size_t exp);
+
+        //! Write the timing of the backtest and of the run, if profiling.
+        void closeProfile();
+
+        /*!
+         * Seed of the random number generators used in a given experiment.
+         * \param exp index of the experiment.
+         * \return seed of the experiment.
+         */
+        unsigned int experimentSeed(size_t exp) const;
+
+        /*!
+         * Seed of the random number generators used in a walk-forward window.
+         * \param exp index of the experiment.
+         * \param window index of the window.
+         * \return seed of the window.
+         */
+        unsigned int windowSeed(size_t exp, size_t window) const;
+
+        //! Get the asset allocation task owned by the experiment.
+        AssetAllocationTask &getTask();
+
         /*!
          * One interaction agent-task, consisting of the following steps:
          * 1) the agent observes the current state of the system.
          * 2) the agent selects and perform an action.
          * 3) the environment evolves to the next state.
          * 4) the agent receives a numerical reward from the environment.
+         * \tparam AgentT concrete type of the agent, or Agent.
+         * \param task asset allocation task.
+         * \param agent learning agent.
          */
-        void oneInteraction();
+        template<class AgentT>
+        void oneInteraction(AssetAllocationTask &task, AgentT &agent);
 
         //! Experiment sizes
         size_t numExperiments;
@@ -93,6 +366,12 @@ class AssetAllocationExperiment : public Experiment
         size_t numTrainingSteps;
         size_t numTestSteps;
 
+        //! Number of threads used to run the experiments
+        size_t numThreads;
+
+        //! Seed of the random number generators
+        unsigned int seed;
+
         /*!
          * Data structure storing the information relevant for the analysis of
          * the backtest performances of the trading strategy.
@@ -109,12 +388,45 @@ class AssetAllocationExperiment : public Experiment
         arma::vec observationCache;
         arma::vec actionCache;
         double rewardCache;
+        arma::vec stateCache;
+
+        //! Cache variables for agents evaluating a population of policies
+        arma::mat populationActionsCache;
+        arma::vec populationRewardsCache;
 
         //! Output directory
         std::string outputDir;
 
         //! Debug directory
         std::string debugDir;
+
+        //! Snapshot directory and number of epochs between two snapshots
+        std::string checkpointDir;
+        size_t checkpointInterval;
+
+        //! Snapshot used to warm-start the agents
+        std::string warmStartFilename;
+
+        //! Shared pool running the experiments, if any
+        WorkStealingPool *poolPtr;
+
+        //! Number of actor threads and transitions per batch of the
+        //! asynchronous training, if any
+        size_t numActorThreads;
+        size_t actorBatchSize;
+
+        //! Interaction loop selected for the agent, see selectInteractionLoop
+        void (AssetAllocationExperiment::*trainingStepsPtr)();
+        void (AssetAllocationExperiment::*testStepPtr)();
+
+#ifdef THESIS_PROFILING
+        //! Time spent in each phase during the current epoch and the run
+        PhaseProfile epochProfile;
+        PhaseProfile runProfile;
+
+        //! Per-phase timing file of the current run
+        std::ofstream profileFile;
+#endif
 };
 
 #endif // ASSETALLOCATIONEXPERIMENT_H
@@ -25,6 +25,7 @@
 
 #include <thesis/Task.h>
 #include <thesis/MarketEnvironment.h>
+#include <thesis/PastStatesWindow.h>
 #include <armadillo>
 
 /**
@@ -39,7 +40,7 @@
 // Write class responsible for feature engineering, e.g. technical indicators,
 // deep auto-encoder, deep neural network for predicting risky-asset returns.
 
-class AssetAllocationTask : public Task
+class AssetAllocationTask final : public Task
 {
     public:
         /**
@@ -87,19 +88,32 @@ class AssetAllocationTask : public Task
         //! Get observation space size.
         virtual size_t getDimObservation() const { return dimObservation; }
 
+        /**
+         * Observation space size of a task on a market of numRiskyAssets_
+         * risky assets observing numDaysObserved_ past days, i.e. the
+         * risk-free rate, the past and current states and the allocation.
+         */
+        static constexpr size_t dimObservationFor(size_t numRiskyAssets_,
+                                                  size_t numDaysObserved_)
+            { return 1 + (numDaysObserved_ + 1) * numRiskyAssets_ + numRiskyAssets_; }
+
+        using Task::getObservation;
+
         /**
          * Provide state observation.
          * The agent observes the past numDaysObserved log-returns of the risky
          * assets, the risk-free rate and the current allocation.
-         * \return observation of the system state.
+         * \param observation_ output observation of the system state.
          */
-        virtual arma::vec getObservation() const;
+        virtual void getObservation(arma::vec &observation_) const;
 
         /**
          * Perform action.
          * Select new portfolio allocation on the risky assets. It is assumed
          * that the portfolio weight on the risk-free asset is 1 - sum(u_i).
          * \param action portfolio allocation.
+         * \throw std::invalid_argument if action has not one weight per
+         *        risky asset.
          */
         virtual void performAction(arma::vec const &action);
 
@@ -110,12 +124,32 @@ class AssetAllocationTask : public Task
          */
         virtual double getReward() const;
 
+        /**
+         * Provide the log-returns that a set of candidate allocations would
+         * have earned on the last transition, starting from the allocation
+         * held before the performed action. The market evolution does not
+         * depend on the allocation, hence these rewards are exact.
+         * \param actions_ candidate portfolio allocations, one per column.
+         * \param rewards_ output portfolio log-returns, resized if needed.
+         */
+        virtual void getRewards(arma::mat const &actions_,
+                                arma::vec &rewards_) const;
+
         //! Reset asset allocation task to initial condition.
         virtual void reset();
 
         //! Set evaluation interval for the allocation task
         void setEvaluationInterval(size_t startDate_, size_t endDate_);
 
+        //! Get total number of days in the market time series.
+        size_t getNumDays() const;
+
+        //! Get first day of the evaluation interval.
+        size_t getStartDate() const;
+
+        //! Get last day of the evaluation interval.
+        size_t getEndDate() const;
+
     private:
         //-----------------//
         // Private Methods //
@@ -130,12 +164,6 @@ class AssetAllocationTask : public Task
          */
         void initializeAllocationCache();
 
-        /**
-         * Compute the simple return for the portfolio allocation selected.
-         * \return portfolio simple return.
-         */
-        double computePortfolioSimpleReturn() const;
-
         //-----------------//
         // Private Members //
         //-----------------//
@@ -158,14 +186,11 @@ class AssetAllocationTask : public Task
         //! State space size.
         size_t dimState;
 
-        //! Past states size.
-        size_t dimPastStates;
-
         //! Observation space size.
         size_t dimObservation;
 
-        //! Past states cache vector.
-        mutable arma::vec pastStates;
+        //! Market states observed in the last numDaysObserved days.
+        mutable PastStatesWindow pastStates;
 
         //! Current state cache vector.
         mutable arma::vec currentState;
@@ -175,6 +200,9 @@ class AssetAllocationTask : public Task
 
         //! New allocation cache vector.
         mutable arma::vec newAllocation;
+
+        //! Allocation held before the last performed action.
+        mutable arma::vec previousAllocation;
 };
 
 #endif /* end of include guard: ASSETALLOCATIONTASK_H */
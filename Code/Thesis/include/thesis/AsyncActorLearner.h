@@ -0,0 +1,170 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef ASYNCACTORLEARNER_H
+#define ASYNCACTORLEARNER_H
+
+#include <thesis/ActorLearnerAgent.h>
+#include <thesis/AssetAllocationTask.h>
+#include <thesis/LockFreeQueue.h>
+#include <thesis/Precision.h>
+#include <armadillo>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * AsyncActorLearner trains an actor-critic agent with decoupled acting and
+ * learning. Several actor threads interact with their own copy of the task
+ * using a clone of the agent whose actor parameters are a snapshot of the
+ * learner ones, and push the transitions they collect in batches into a
+ * lock-free queue. The learner, which runs on the calling thread, replays the
+ * transitions on the agent in arrival order and publishes the updated actor
+ * parameters after each batch. The batches are recycled through a second
+ * lock-free queue, so that the epoch does not allocate transition storage.
+ *
+ * The actors act with parameters that may be a few batches old and the order
+ * in which the learner receives the batches depends on the scheduling of the
+ * threads, hence the results are not reproducible, unlike the synchronous
+ * interaction loop of AssetAllocationExperiment.
+ */
+
+class AsyncActorLearner
+{
+    public:
+        /*!
+         * Constructor.
+         * \param numActors_ number of actor threads.
+         * \param batchSize_ number of transitions per batch.
+         */
+        AsyncActorLearner(size_t numActors_, size_t batchSize_);
+
+        //! Deleted copy constructor: the learner owns the actor threads state.
+        AsyncActorLearner(AsyncActorLearner const &other_) = delete;
+
+        //! Deleted assignment operator.
+        AsyncActorLearner &operator=(AsyncActorLearner const &other_) = delete;
+
+        //! Get number of actor threads.
+        size_t getNumActors() const { return numActors; }
+
+        //! Get number of transitions per batch.
+        size_t getBatchSize() const { return batchSize; }
+
+        /*!
+         * Seed the random number generators of the actors. The actors of each
+         * epoch are seeded from seed_, the epoch and their index.
+         * \param seed_ seed of the actors.
+         */
+        void seed(unsigned int seed_);
+
+        /*!
+         * Run a training epoch. The first actor interacts with task_, the
+         * other ones with copies of it, and each actor performs numSteps_
+         * interactions. The k-th copy starts k * numSteps_ / numActors days
+         * later and wraps around to the start of the evaluation interval when
+         * it reaches the end of the training days. The first exception thrown
+         * by an actor or by the learner stops the epoch and is rethrown once
+         * the actors are joined.
+         * \param task_ task, reset by the caller.
+         * \param agent_ agent trained by the learner.
+         * \param numSteps_ number of interactions per actor.
+         * \param rewardCallback_ function called by the learner with the
+         *        reward of each transition, e.g. to gather statistics.
+         */
+        void runEpoch(AssetAllocationTask &task_,
+                      ActorLearnerAgent &agent_,
+                      size_t numSteps_,
+                      std::function<void(double)> const &rewardCallback_);
+
+    private:
+        //! Transitions collected by an actor, one per column
+        struct TransitionBatch
+        {
+            arma::mat observations;
+            arma::mat actions;
+            arma::vec rewards;
+            arma::mat nextObservations;
+            size_t size;
+
+            //! Index of the actor and start of a new trajectory of the actor
+            size_t actor;
+            bool newTrajectory;
+        };
+
+        //! Allocate the batches and fill the queue of free batches.
+        void initializeBatches(size_t dimObservation_, size_t dimAction_);
+
+        //! Main loop executed by each actor thread.
+        void actorLoop(size_t index_, AssetAllocationTask &task_, size_t numSteps_);
+
+        //! Replay a batch of transitions on the agent.
+        void learnBatch(TransitionBatch &batch_,
+                        ActorLearnerAgent &agent_,
+                        std::function<void(double)> const &rewardCallback_);
+
+        //! Publish the actor parameters of the agent to the actor threads.
+        void publish(ActorLearnerAgent const &agent_);
+
+        //! Stop the actors and record the first failure.
+        void fail(std::exception_ptr error_);
+
+        //! Number of actor threads and of transitions per batch
+        size_t numActors;
+        size_t batchSize;
+
+        //! Seed of the actors and number of epochs run
+        unsigned int actorsSeed;
+        size_t numEpochs;
+
+        //! Transition batches and queues of the free and of the full ones
+        std::vector<TransitionBatch> batches;
+        std::unique_ptr<LockFreeQueue<TransitionBatch *>> freeBatches;
+        std::unique_ptr<LockFreeQueue<TransitionBatch *>> fullBatches;
+
+        //! Agents and task copies of the actors of the current epoch
+        std::vector<std::unique_ptr<ActorLearnerAgent>> actorAgents;
+        std::vector<std::unique_ptr<AssetAllocationTask>> actorTasks;
+
+        //! Evaluation interval of the epoch and start offsets of the actors
+        size_t startDate;
+        size_t endDate;
+        std::vector<size_t> actorOffsets;
+
+        //! Last published actor parameters and their version
+        std::shared_ptr<RealVec const> snapshot;
+        std::atomic<size_t> snapshotVersion;
+        RealVec parametersCache;
+
+        //! Number of running actors and stop request
+        std::atomic<size_t> numRunningActors;
+        std::atomic<bool> stopping;
+
+        //! First failure of the epoch
+        std::mutex errorMutex;
+        std::exception_ptr error;
+};
+
+#endif // ASYNCACTORLEARNER_H
@@ -23,58 +23,121 @@
 #ifndef BACKTESTLOG_H
 #define BACKTESTLOG_H
 
+#include <thesis/ThreadPool.h>
+#include <thesis/Statistics.h>
 #include <armadillo>
-#include <ostream>
+#include <cstdio>
+#include <future>
+#include <string>
+#include <vector>
 
 /**
- * BacktestLog implements a simple data-structure that stores the relevant
- * information for the analysis of the backtest performances of the trading
- * strategy, i.e. the state of the system, the selected allocation and the
- * portfolio log-return.
+ * BacktestLog implements a streaming writer for the information relevant to
+ * the analysis of the backtest performances of the trading strategy, i.e. the
+ * state of the system, the selected allocation and the portfolio log-return.
+ *
+ * Records are collected in a bounded buffer. When the buffer is full, it is
+ * handed over to a background writer thread and a second buffer takes its
+ * place, so that the backtest loop does not wait for the disk unless the
+ * writer falls a full buffer behind. Two encodings are available:
+ *
+ *  - Csv: one line per record with a header, as read by the postprocessing
+ *    scripts. Values are printed with printf-style formatting in scientific
+ *    notation with 17 significant digits.
+ *  - Binary: magic number "THBKTBIN" (8 bytes), format version (uint32),
+ *    number of columns (uint32), size of the header string (uint64), the
+ *    comma-separated column names and then the records, each one stored as
+ *    contiguous doubles in native byte order.
+ *
+ * The performance statistics of the backtest are updated as the records are
+ * inserted, hence they are available when the file is closed without reading
+ * it back.
  */
 
 class BacktestLog
 {
-    friend std::ostream& operator<<(std::ostream &os, BacktestLog const &blog);
-
     public:
+        //! Output encoding.
+        enum class Format { Csv, Binary };
+
         /*!
          * Constructor
          * Initializes a backtest log given the sizes of the problem.
          * \param dimState_ size of the state space.
          * \param dimAction_ size of the action space.
-         * \param numRecords_ number of records that will be stored.
+         * \param bufferRecords_ number of records buffered before a flush.
+         * \param format_ output encoding.
          */
-        BacktestLog(size_t dimState_, size_t dimAction_, size_t numRecords_);
+        BacktestLog(size_t dimState_,
+                    size_t dimAction_,
+                    size_t bufferRecords_=1024,
+                    Format format_=Format::Csv);
+
+        //! Deleted copy constructor: a log owns its writer thread and file.
+        BacktestLog(BacktestLog const &other_) = delete;
+
+        //! Deleted assignment operator.
+        BacktestLog &operator=(BacktestLog const &other_) = delete;
 
-        //! Copy constructor.
-        BacktestLog(BacktestLog const &other_) = default;
+        //! Destructor. Close the output file, if any.
+        virtual ~BacktestLog();
 
-        //! Destructor.
-        virtual ~BacktestLog() = default;
+        //! Get output encoding.
+        Format getFormat() const { return format; }
+
+        //! Get the extension of the output files, e.g. ".csv".
+        std::string getFileExtension() const;
+
+        //! Get the statistics of the records inserted since the file was opened.
+        StatisticsBacktest const &getStatistics() const { return statistics; }
+
+        /*!
+         * Open a new output file and write the header. A previously opened
+         * file is closed first.
+         * \param filename path to the output file.
+         */
+        void open(std::string const &filename);
 
         /*!
          * Insert new record in the log.
          * \param state_ system state.
          * \param action_ action selected by the agent.
          * \param reward_ portfolio log-return.
+         * \throw std::invalid_argument if the state or the action do not
+         *        match the dimensions of the log.
          */
         void insertRecord(arma::vec const &state_,
                           arma::vec const &action_,
                           double const reward_);
 
         /*!
-         * Print the backtest log in a file at the given filepath.
-         * \param filename path to the output file.
+         * Write the buffered records, wait for the writer and close the output
+         * file. Errors of the background writer are rethrown here.
          */
-        void save(std::string filename);
+        void close();
 
-        //! Reset log to the initial state.
-        void reset();
+        /*!
+         * Parse an output encoding from its name, as read from a parameter
+         * file.
+         * \param name_ either "csv" or "binary".
+         * \return output encoding.
+         */
+        static Format formatFromString(std::string const &name_);
 
     private:
-        //! Matrix storing the data column-wise.
-        arma::mat history;
+        //! Hand the active buffer over to the writer thread.
+        void flush();
+
+        //! Wait for the pending write, rethrowing its errors.
+        void waitPendingWrite();
+
+        //! Encode and write records, executed by the writer thread.
+        void writeRecords(std::FILE *file_,
+                          arma::mat const &records_,
+                          size_t numRecords_);
+
+        //! Column names of the output file.
+        std::string header() const;
 
         //! Size of the state space.
         size_t dimState;
@@ -82,11 +145,28 @@ class BacktestLog
         //! Size of the action space.
         size_t dimAction;
 
-        //! Current index.
+        //! Output encoding.
+        Format format;
+
+        //! Records being filled and records being written, stored column-wise.
+        arma::mat activeRecords;
+        arma::mat writtenRecords;
+
+        //! Number of records in the active buffer.
         size_t currentIdx;
-};
 
-//! Output operator for the BacktestLog function.
-std::ostream& operator<<(std::ostream &os, BacktestLog const &blog);
+        //! Output file.
+        std::FILE *file;
+
+        //! Text encoding buffer, used by the writer thread only.
+        std::vector<char> textBuffer;
+
+        //! Background writer and its pending write.
+        ThreadPool writer;
+        std::future<void> pendingWrite;
+
+        //! Backtest statistics.
+        StatisticsBacktest statistics;
+};
 
 #endif // BACKTESTLOG_H
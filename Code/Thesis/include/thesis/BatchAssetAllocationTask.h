@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef BATCHASSETALLOCATIONTASK_H
+#define BATCHASSETALLOCATIONTASK_H
+
+#include <thesis/MarketEnvironment.h>
+#include <thesis/PastStatesWindow.h>
+#include <armadillo>
+#include <memory>
+#include <vector>
+
+/**
+ * BatchAssetAllocationTask advances a batch of K independent asset allocation
+ * trajectories in lockstep, e.g. the same market from different start dates
+ * or different simulated paths. Every trajectory follows exactly the dynamics
+ * of an AssetAllocationTask, which is the K = 1 case.
+ *
+ * The states, observations, allocations and rewards of the batch are stored
+ * in structure-of-arrays matrices with one column per trajectory, so that the
+ * observations are assembled with block copies, the rewards are computed by
+ * the fused portfolio return kernel on contiguous memory and the activations
+ * of a linear policy are a single matrix product across the whole batch (see
+ * Policy::getBatchActions).
+ */
+
+class BatchAssetAllocationTask
+{
+    public:
+        /**
+         * Constructor.
+         * Initialize a batch of trajectories on the same market, each one
+         * starting at its own date and ending at the market end date.
+         * \param market_ financial market environment
+         * \param startDates_ initial time step of each trajectory
+         * \param riskFreeRate_ risk-free rate available on the market
+         * \param deltaP_ proportional transaction costs
+         * \param deltaF_ fixed transaction costs
+         * \param deltaS_ short-selling fees
+         * \param numDaysObserved_ nb of days observed by the agent (today excl)
+         */
+        BatchAssetAllocationTask(MarketEnvironment const &market_,
+                                 std::vector<size_t> const &startDates_,
+                                 double riskFreeRate_,
+                                 double deltaP_,
+                                 double deltaF_,
+                                 double deltaS_,
+                                 size_t numDaysObserved_);
+
+        /**
+         * Constructor.
+         * Initialize a batch of trajectories, one per market environment, e.g.
+         * synthetic markets seeded differently. The markets must have the
+         * same number of risky assets.
+         * \param markets_ financial market environment of each trajectory
+         * \param riskFreeRate_ risk-free rate available on the market
+         * \param deltaP_ proportional transaction costs
+         * \param deltaF_ fixed transaction costs
+         * \param deltaS_ short-selling fees
+         * \param numDaysObserved_ nb of days observed by the agent (today excl)
+         */
+        BatchAssetAllocationTask(std::vector<std::unique_ptr<MarketEnvironment>> markets_,
+                                 double riskFreeRate_,
+                                 double deltaP_,
+                                 double deltaF_,
+                                 double deltaS_,
+                                 size_t numDaysObserved_);
+
+        //! Copy constructor. The market environments are cloned.
+        BatchAssetAllocationTask(BatchAssetAllocationTask const &other_);
+
+        //! Move constructor.
+        BatchAssetAllocationTask(BatchAssetAllocationTask &&other_) = default;
+
+        //! Destructor.
+        ~BatchAssetAllocationTask() = default;
+
+        //! Get number of trajectories K.
+        size_t getBatchSize() const { return markets.size(); }
+
+        //! Get observation space size of a trajectory.
+        size_t getDimObservation() const { return dimObservation; }
+
+        //! Get action space size of a trajectory.
+        size_t getDimAction() const { return dimState; }
+
+        //! Get number of days observed by the agent.
+        size_t getNumDaysObserved() const { return numDaysObserved; }
+
+        /**
+         * Provide the observations of the trajectories, with the same layout
+         * as AssetAllocationTask::getObservation.
+         * \param observations_ output observations, one per column, resized if
+         *        needed.
+         */
+        void getObservations(arma::mat &observations_) const;
+
+        /**
+         * Perform actions.
+         * Select the new portfolio allocations of the trajectories.
+         * \param actions_ portfolio allocations, one per column.
+         */
+        void performActions(arma::mat const &actions_);
+
+        /**
+         * Provide rewards.
+         * Move every trajectory to the next market state and compute the
+         * log-returns of the portfolios.
+         * \param rewards_ output portfolio log-returns, resized if needed.
+         */
+        void getRewards(arma::vec &rewards_);
+
+        //! Reset all the trajectories to their initial conditions.
+        void reset();
+
+        /**
+         * Seed the random number generators of the market environments. The
+         * seed of trajectory k is derived from seed_ and k.
+         * \param seed_ seed of the batch.
+         */
+        void seed(unsigned int seed_);
+
+    private:
+        //-----------------//
+        // Private Methods //
+        //-----------------//
+
+        //! Check the markets and allocate the batch matrices.
+        void initialize();
+
+        //! Initialize the past states window of every trajectory.
+        void initializeStatesCache();
+
+        //! Read the current state of every market in currentStates.
+        void readStates();
+
+        //! Advance every market to the next time step.
+        void advanceMarkets();
+
+        //-----------------//
+        // Private Members //
+        //-----------------//
+
+        //! Market environment of each trajectory.
+        std::vector<std::unique_ptr<MarketEnvironment>> markets;
+
+        //! Risk-free rate.
+        double riskFreeRate;
+
+        //! Proportional transaction costs.
+        double deltaP;
+
+        //! Fixed transaction costs.
+        double deltaF;
+
+        //! Short-selling fees.
+        double deltaS;
+
+        //! Number of past days observed.
+        size_t numDaysObserved;
+
+        //! State space size of a trajectory.
+        size_t dimState;
+
+        //! Observation space size of a trajectory.
+        size_t dimObservation;
+
+        /**
+         * Market states observed in the last numDaysObserved days, one column
+         * per trajectory. The trajectories move in lockstep, hence they share
+         * the circular buffer head.
+         */
+        PastStatesWindow pastStates;
+
+        //! Current states, one per column.
+        arma::mat currentStates;
+
+        //! Current allocations, one per column.
+        arma::mat currentAllocations;
+
+        //! New allocations, one per column.
+        arma::mat newAllocations;
+
+        //! Allocations held before the last performed actions, one per column.
+        arma::mat previousAllocations;
+};
+
+#endif /* end of include guard: BATCHASSETALLOCATIONTASK_H */
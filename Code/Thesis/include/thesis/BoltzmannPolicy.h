@@ -24,6 +24,7 @@
 #define BOLTZMANNEXPLORATIONPOLICY_H
 
 #include <thesis/StochasticPolicy.h>  /* StochasticPolicy */
+#include <thesis/Philox.h>            /* Philox4x32 */
 #include <armadillo>                  /* arma::vec */
 #include <vector>                     /* std::vector */
 #include <random>
@@ -35,7 +36,7 @@
  * Optimization 12 (2012).
  */
 
-class BoltzmannPolicy : public StochasticPolicy
+class BoltzmannPolicy final : public StochasticPolicy
 {
     public:
         /*!
@@ -44,10 +45,17 @@ class BoltzmannPolicy : public StochasticPolicy
          * space and a list of the possible actions that can be selected.
          * \param dimObservation_ dimension of the observation space
          * \param possibleActions_ vector of possible actions
+         * \throw std::invalid_argument if there are fewer than two actions.
          */
         BoltzmannPolicy(size_t dimObservation_,
                         std::vector<double> possibleActions_);
 
+        /*!
+         * Copy constructor for correct instantiation of polymorphic objects.
+         * The parameters views are rebound to the memory of the new object.
+         */
+        BoltzmannPolicy(BoltzmannPolicy const &other_);
+
         //! Default destructor
         virtual ~BoltzmannPolicy() = default;
 
@@ -63,40 +71,77 @@ class BoltzmannPolicy : public StochasticPolicy
          */
         virtual size_t getDimParameters() const { return dimParameters; }
 
+        using StochasticPolicy::getParameters;
+        using StochasticPolicy::getAction;
+        using StochasticPolicy::likelihoodScore;
+
         /*!
          * Get method for the policy parameters.
-         * \return parameters stored in an arma::vector
+         * \param parameters_ output parameters, resized if needed
          */
-        virtual arma::vec getParameters() const;
+        virtual void getParameters(RealVec &parameters_) const;
 
         /*!
          * Set method for the policy parameters.
          * \param parameters_ the new parameters stored in an arma::vector
          */
-        virtual void setParameters(arma::vec const &parameters_);
+        virtual void setParameters(RealVec const &parameters_);
 
         /*!
          * Given an observation, select an action accordind to the policy.
          * \param observation_ observation
-         * \return action
+         * \param action_ output action, resized if needed
          */
-        virtual arma::vec getAction(arma::vec const &observation_) const;
+        virtual void getAction(RealVec const &observation_,
+                               RealVec &action_) const;
 
         /*!
          * Evaluate the Likelihood score function at a given observation and
          * action.
          * \param observation_ observation
          * \param action_ action
-         * \return likelihood score evaluated at observation_ and action_
+         * \param likScore_ output likelihood score evaluated at observation_
+         *        and action_, resized if needed
+         */
+        virtual void likelihoodScore(RealVec const &observation_,
+                                     RealVec const &action_,
+                                     RealVec &likScore_) const;
+
+        /*!
+         * Evaluate the likelihood score of an action selected by another copy
+         * of the policy. The probabilities are computed for observation_
+         * instead of being taken from the last call to getAction.
+         * \param observation_ observation
+         * \param action_ action
+         * \param likScore_ output likelihood score, resized if needed
          */
-        virtual arma::vec likelihoodScore(arma::vec const &observation_,
-                                          arma::vec const &action_) const;
+        virtual void behaviourLikelihoodScore(RealVec const &observation_,
+                                              RealVec const &action_,
+                                              RealVec &likScore_) const;
 
         /*!
          * Reset policy to initial conditions.
          */
         virtual void reset();
 
+        /*!
+         * Seed the random number generator used by the policy.
+         * \param seed_ seed of the random number generator
+         */
+        virtual void seed(unsigned int seed_);
+
+        /*!
+         * Write the policy parameters and the generator state to a snapshot.
+         * \param writer_ snapshot writer
+         */
+        virtual void saveState(CheckpointWriter &writer_) const;
+
+        /*!
+         * Read the policy state from a snapshot written by saveState.
+         * \param reader_ snapshot reader
+         */
+        virtual void loadState(CheckpointReader &reader_);
+
     private:
         //! Virtual inner clone method
         virtual std::unique_ptr<Policy> cloneImpl() const;
@@ -104,6 +149,12 @@ class BoltzmannPolicy : public StochasticPolicy
         //! Initialize the Boltzmann policy parameters
         void initializeParameters();
 
+        /*!
+         * Compute the action probabilities and their cumulative sums from the
+         * cached activations with a numerically stable log-sum-exp softmax.
+         */
+        void computeProbabilities() const;
+
         //! Possible actions
         std::vector<double> possibleActions;
 
@@ -117,17 +168,33 @@ class BoltzmannPolicy : public StochasticPolicy
         size_t dimParameters;
 
         //! Policy parameters: Theta = [ theta_1 | thetha_2 | ... | theta_D ]
-        arma::mat parametersMat;
-        arma::vec parametersVec;  // Linearized matrix (shares memory)
+        RealMat parametersMat;
+        RealVec parametersVec;  // Linearized matrix (shares memory)
 
         /*!
          * Boltzmann probability distribution and random number generator
          * Need to be mutable because the generator state changes when
          * simulating an action.
          */
-        mutable std::mt19937 generator;
+        mutable Philox4x32 generator;
         mutable std::vector<double> boltzmannProbabilities;
 
+        /*!
+         * Cumulative action probabilities, used to sample an action by
+         * inversion without building a std::discrete_distribution per call.
+         */
+        mutable std::vector<double> cumulativeProbabilities;
+
+        /*!
+         * Index of the last action sampled by getAction, which spares the
+         * search among the possible actions in likelihoodScore.
+         */
+        mutable size_t lastActionIdx;
+
+        //! Cache vectors for features [1; observation] and activations
+        mutable RealVec features;
+        mutable RealVec activations;
+
         // TODO: Consider generic features of the input
 };
 
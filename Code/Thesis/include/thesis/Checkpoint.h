@@ -0,0 +1,154 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <thesis/Philox.h>
+#include <thesis/Precision.h>
+#include <armadillo>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+/**
+ * CheckpointWriter and CheckpointReader implement the binary snapshots used to
+ * resume an interrupted learning process and to warm-start new runs from
+ * trained agents. The objects that take part in a snapshot (agents, policies,
+ * critics, distributions and learning rates) write their state in a fixed
+ * order with saveState and read it back in the same order with loadState.
+ *
+ * A snapshot file starts with the magic number "THCKPT01" (8 bytes) followed
+ * by the format version (uint32). Scalars are stored as uint64 or double,
+ * vectors as their size (uint64) followed by their elements and generators as
+ * their key, sub-stream and position, all in native byte order.
+ */
+
+class CheckpointWriter
+{
+    public:
+        /*!
+         * Constructor.
+         * The snapshot is written to a temporary file, which replaces the
+         * target file only when commit is called. Hence an interruption while
+         * writing never corrupts the previous snapshot.
+         * \param filename_ path to the snapshot file.
+         */
+        explicit CheckpointWriter(std::string const &filename_);
+
+        //! Deleted copy constructor: a writer owns its file.
+        CheckpointWriter(CheckpointWriter const &other_) = delete;
+
+        //! Deleted assignment operator.
+        CheckpointWriter &operator=(CheckpointWriter const &other_) = delete;
+
+        //! Destructor. Discard the temporary file if the snapshot was not committed.
+        ~CheckpointWriter();
+
+        //! Write an unsigned integer.
+        void write(uint64_t value_);
+
+        //! Write a real number.
+        void write(double value_);
+
+        //! Write a vector, preceded by its size.
+        void write(arma::vec const &values_);
+
+        //! Write a single-precision vector, stored in double precision.
+        void write(arma::fvec const &values_);
+
+        //! Write the state of a random number generator.
+        void write(Philox4x32 const &generator_);
+
+        //! Close the temporary file and move it over the target file.
+        void commit();
+
+    private:
+        //! Write raw bytes, throwing on failure.
+        void writeBytes(void const *data_, size_t size_);
+
+        //! Path to the snapshot and to the temporary file.
+        std::string filename;
+        std::string temporaryFilename;
+
+        //! Temporary output file.
+        std::FILE *file;
+};
+
+class CheckpointReader
+{
+    public:
+        /*!
+         * Constructor.
+         * Open a snapshot file and check its header.
+         * \param filename_ path to the snapshot file.
+         */
+        explicit CheckpointReader(std::string const &filename_);
+
+        //! Deleted copy constructor: a reader owns its file.
+        CheckpointReader(CheckpointReader const &other_) = delete;
+
+        //! Deleted assignment operator.
+        CheckpointReader &operator=(CheckpointReader const &other_) = delete;
+
+        //! Destructor. Close the snapshot file.
+        ~CheckpointReader();
+
+        //! Read an unsigned integer.
+        void read(uint64_t &value_);
+
+        //! Read a real number.
+        void read(double &value_);
+
+        /*!
+         * Read a vector. The stored size must match the size of the output
+         * vector, i.e. the snapshot must come from an object with the same
+         * structure.
+         * \param values_ output vector.
+         */
+        void read(arma::vec &values_);
+
+        //! Read a single-precision vector written by either write method.
+        void read(arma::fvec &values_);
+
+        //! Read the state of a random number generator.
+        void read(Philox4x32 &generator_);
+
+        /*!
+         * Check if a snapshot file exists.
+         * \param filename_ path to the snapshot file.
+         * \return true if the file can be opened for reading.
+         */
+        static bool exists(std::string const &filename_);
+
+    private:
+        //! Read raw bytes, throwing on failure.
+        void readBytes(void *data_, size_t size_);
+
+        //! Path to the snapshot file.
+        std::string filename;
+
+        //! Input file.
+        std::FILE *file;
+};
+
+#endif // CHECKPOINT_H
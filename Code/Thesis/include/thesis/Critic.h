@@ -26,15 +26,19 @@
 #include <armadillo>
 #include <memory>
 #include <thesis/FunctionApproximator.h>
+#include <thesis/Checkpoint.h>
 
 /*!
  * Critic implements the generic interface of a critic for a state-value
  * function. It is based on the FunctionApproximator hierarchy by composition,
  * so that different function approximators can be easily used as the core of
- * critic.
+ * critic. As for the actor, the approximator type is a template parameter and a
+ * critic on a final class, e.g. BasicCritic<LinearRegressor>, calls it
+ * directly.
  */
 
-class Critic
+template<class ApproximatorT>
+class BasicCritic final
 {
     public:
         /*!
@@ -42,18 +46,18 @@ class Critic
          * Initialize a critic using a function approximator.
          * \param approximator_ function approximator
          */
-        Critic(FunctionApproximator const &approximator_)
-            : approximatorPtr(approximator_.clone()) {}
+        BasicCritic(ApproximatorT const &approximator_)
+            : approximatorPtr(static_cast<ApproximatorT *>(approximator_.clone().release())) {}
 
         /*!
          * Copy constructor.
          * \param rhs critic to copy
          */
-        Critic(Critic const &rhs)
-            : approximatorPtr(rhs.approximatorPtr->clone()) {}
+        BasicCritic(BasicCritic const &rhs)
+            : approximatorPtr(static_cast<ApproximatorT *>(rhs.approximatorPtr->clone().release())) {}
 
         //! Default destructor
-        virtual ~Critic() = default;
+        virtual ~BasicCritic() = default;
 
         /*!
          * Get method for the input dimention.
@@ -71,14 +75,21 @@ class Critic
          * Get method for the critic parameters.
          * \return parameters stored in an arma::vector
          */
-        arma::vec getParameters() const
+        RealVec getParameters() const
             { return approximatorPtr->getParameters(); }
 
+        /*!
+         * Get method for the critic parameters in a preallocated vector.
+         * \param parameters_ output parameters, resized if needed
+         */
+        void getParameters(RealVec &parameters_) const
+            { approximatorPtr->getParameters(parameters_); }
+
         /*!
          * Set method for the critic parameters.
          * \param parameters_ the new parameters stored in an arma::vector
          */
-        void setParameters(arma::vec const &parameters_)
+        void setParameters(RealVec const &parameters_)
             { approximatorPtr->setParameters(parameters_); }
 
         /*!
@@ -86,7 +97,7 @@ class Critic
          * \param observation_ observation
          * \return evaluation of the critic for this observation
          */
-        double evaluate(arma::vec &observation_) const
+        double evaluate(RealVec &observation_) const
             { return approximatorPtr->evaluate(observation_); }
 
         /*!
@@ -94,15 +105,38 @@ class Critic
          * \param observation_ observation
          * \return evaluation of the critic's gradient for this observation
          */
-        arma::vec gradient(arma::vec const &observation) const
+        RealVec gradient(RealVec const &observation) const
             { return approximatorPtr->gradient(observation); }
 
+        /*!
+         * Evaluate the critic's gradient in a preallocated vector.
+         * \param observation_ observation
+         * \param gradient_ output gradient, resized if needed
+         */
+        void gradient(RealVec const &observation, RealVec &gradient_) const
+            { approximatorPtr->gradient(observation, gradient_); }
+
         //! Reset critic to initial conditions
         void reset() { approximatorPtr->reset(); }
 
+        //! Write the critic parameters to a snapshot.
+        void saveState(CheckpointWriter &writer_) const
+            { writer_.write(getParameters()); }
+
+        //! Read the critic parameters from a snapshot.
+        void loadState(CheckpointReader &reader_)
+        {
+            RealVec parameters(getDimParameters());
+            reader_.read(parameters);
+            setParameters(parameters);
+        }
+
     private:
         //! Function approximator
-        std::unique_ptr<FunctionApproximator> approximatorPtr;
+        std::unique_ptr<ApproximatorT> approximatorPtr;
 };
 
+//! Critic on any function approximator
+typedef BasicCritic<FunctionApproximator> Critic;
+
 #endif // CRITIC_H
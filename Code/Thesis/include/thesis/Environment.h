@@ -53,6 +53,14 @@ class Environment
          */
         virtual arma::vec getState() const = 0;
 
+        /**
+         * Get system state in a preallocated vector. The default
+         * implementation calls getState(); environments used in the
+         * interaction loop override it to avoid heap allocations.
+         * \param state_ output system state, resized if needed.
+         */
+        virtual void getState(arma::vec &state_) const { state_ = getState(); }
+
         /**
          * Perform action on the system.
          * \param action portfolio allocation
@@ -77,6 +85,13 @@ class Environment
          * reached.
          */
         virtual void reset() = 0;
+
+        /**
+         * Seed the random number generators of a stochastic environment. The
+         * default implementation does nothing, as for historical markets.
+         * \param seed_ seed of the random number generators.
+         */
+        virtual void seed(unsigned int seed_) {}
 };
 
 #endif // ENVIRONMENT_H
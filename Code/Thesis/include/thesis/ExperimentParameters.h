@@ -46,6 +46,14 @@ class ExperimentParameters
         //! Default destructor.
         virtual ~ExperimentParameters() = default;
 
+        /*!
+         * Set a parameter from its name and textual value, as written in a
+         * parameter file.
+         * \param name_ name of the parameter, e.g. "deltaP".
+         * \param value_ value of the parameter, e.g. "0.001".
+         */
+        void setValue(std::string const &name_, std::string const &value_);
+
         /*!
          * Market parameters
          */
@@ -53,6 +61,12 @@ class ExperimentParameters
         //! Risk-free rate
         double riskFreeRate;
 
+        //! Market: historical (input file), artrend or cointegrated
+        std::string market;
+
+        //! Number of days of the simulated series of synthetic markets
+        size_t numSyntheticDays;
+
         /*!
          * Asset allocation task parameters
          */
@@ -88,6 +102,18 @@ class ExperimentParameters
         double alphaConstBaseline;
         double alphaExpBaseline;
 
+        //! Covariance structure of the NPGPE agents (full, triangular, diagonal, lowrank, block)
+        std::string covariance;
+
+        //! Rank of the low-rank covariance structure
+        size_t covarianceRank;
+
+        //! Block size of the block-diagonal covariance structure
+        size_t covarianceBlockSize;
+
+        //! Number of parameter samples evaluated at each step by the NPGPE agents
+        size_t populationSize;
+
         /*!
          * Experiment parameters
          */
@@ -103,6 +129,33 @@ class ExperimentParameters
 
         //! Number of test steps
         size_t numTestSteps;
+
+        //! Number of threads used to run the experiments (0 = all cores)
+        size_t numThreads;
+
+        //! Seed of the random number generators
+        unsigned int seed;
+
+        //! Encoding of the backtest log files (csv, binary)
+        std::string backtestFormat;
+
+        //! Backtest on rolling windows over the full history (0, 1)
+        bool walkForward;
+
+        //! Number of epochs between two snapshots of the learning process (0 = none)
+        size_t checkpointInterval;
+
+        //! Directory of the snapshots ("" = debug directory)
+        std::string checkpointDir;
+
+        //! Snapshot used to warm-start the agents ("" = none)
+        std::string warmStart;
+
+        //! Number of actor threads of the asynchronous training (0 = synchronous)
+        size_t numActorThreads;
+
+        //! Number of transitions per batch sent by the actor threads
+        size_t actorBatchSize;
 };
 
 /*!
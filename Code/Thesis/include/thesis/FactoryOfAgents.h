@@ -25,6 +25,7 @@
 
 #include <memory>
 #include <thesis/LearningRate.h>
+#include <thesis/ParameterCovariance.h>
 #include <thesis/Agent.h>
 #include <thesis/AracAgent.h>
 #include <thesis/ArAgent.h>
@@ -33,22 +34,31 @@
 #include <thesis/RiskSensitiveNpgpeAgent.h>
 
 /**
- * Simple factory class for creating different types of agent. The class is a
- * singleton and exploits Meyers' trick.
+ * Simple factory class for creating different types of agent. The instance
+ * method returns a process-wide factory exploiting Meyers' trick, while the
+ * public constructor builds independent factories, e.g. one per job of a
+ * parameter sweep.
  */
 
 class FactoryOfAgents
 {
     public:
         /*!
-         * instance method for creating a Singleton using Meyers' trick.
+         * instance method for creating a Singleton using Meyers' trick. The
+         * covariance arguments select the covariance structure of the NPGPE
+         * agents, see makeParameterCovariance, and populationSize_ the number
+         * of parameter samples they evaluate at each step.
          * @return a reference to the unique instance of a FactoryOfAgents object.
          */
         static FactoryOfAgents& instance(size_t const &dimObservation_,
                                          LearningRate const &baselineLearningRate_,
                                          LearningRate const &criticLearningRate_,
                                          LearningRate const &actorLearningRate_,
-                                         double const &lambda_);
+                                         double const &lambda_,
+                                         std::string const &covariance_="full",
+                                         size_t covarianceRank_=1,
+                                         size_t covarianceBlockSize_=1,
+                                         size_t populationSize_=1);
 
         /*!
          * make method for creating an agent of the given type.
@@ -57,31 +67,48 @@ class FactoryOfAgents
          */
         std::unique_ptr<Agent> make(std::string const &agentId) const;
 
-    private:
-        //! Standard constructor
-        FactoryOfAgents() = default;
-
-        //! Constructor
+        /*!
+         * Constructor of an independent factory, with the same arguments as
+         * the instance method.
+         */
         FactoryOfAgents(size_t const &dimObservation_,
                         LearningRate const &baselineLearningRate_,
                         LearningRate const &criticLearningRate_,
                         LearningRate const &actorLearningRate_,
-                        double const &lambda_);
-
-        FactoryOfAgents(FactoryOfAgents const &)=delete;
-        FactoryOfAgents& operator=(FactoryOfAgents const &)=delete;
+                        double const &lambda_,
+                        std::string const &covariance_,
+                        size_t covarianceRank_,
+                        size_t covarianceBlockSize_,
+                        size_t populationSize_);
 
         //! Default destructor
         virtual ~FactoryOfAgents() = default;
 
+    private:
+        //! Standard constructor
+        FactoryOfAgents() = default;
+
+        FactoryOfAgents(FactoryOfAgents const &)=delete;
+        FactoryOfAgents& operator=(FactoryOfAgents const &)=delete;
+
         //! Builder for ARAC agent
-        std::unique_ptr<ARACAgent> makeARACAgent() const;
+        std::unique_ptr<BoltzmannARACAgent> makeARACAgent() const;
 
         //! Builder for PGPE Agent
-        std::unique_ptr<ARACAgent> makePGPEAgent() const;
+        std::unique_ptr<PGPEARACAgent> makePGPEAgent() const;
 
         //! Builder for NPGPE agent
-        std::unique_ptr<NPGPEAgent> makeNPGPEAgent() const;
+        std::unique_ptr<Agent> makeNPGPEAgent() const;
+
+        //! Builder for NPGPE agent on a given controller
+        template<class PolicyT>
+        std::unique_ptr<BasicNPGPEAgent<PolicyT>> makeNPGPEAgent(PolicyT const &controller_) const;
+
+        /*!
+         * Builder for the long-short controller of the PGPE agents, of fixed
+         * dimension if compiled for the observation size, see FixedDimensions.h.
+         */
+        std::unique_ptr<Policy> makeController() const;
 
         //! Builder for RSARAC agent
         std::unique_ptr<ARRSACAgent> makeRSARACAgent() const;
@@ -97,6 +124,10 @@ class FactoryOfAgents
         std::unique_ptr<LearningRate> criticLearningRatePtr;
         std::unique_ptr<LearningRate> actorLearningRatePtr;
         double lambda;
+        std::string covariance;
+        size_t covarianceRank;
+        size_t covarianceBlockSize;
+        size_t populationSize;
 };
 
 
@@ -104,14 +135,21 @@ class FactoryOfAgentsForTwoAssetsProblem
 {
     public:
         /*!
-         * instance method for creating a Singleton using Meyers' trick.
+         * instance method for creating a Singleton using Meyers' trick. The
+         * covariance arguments select the covariance structure of the NPGPE
+         * agents, see makeParameterCovariance, and populationSize_ the number
+         * of parameter samples they evaluate at each step.
          * @return a reference to the unique instance of a FactoryOfAgentsForTwoAssetsProblem object.
          */
         static FactoryOfAgentsForTwoAssetsProblem& instance(size_t const &dimObservation_,
                                                             LearningRate const &baselineLearningRate_,
                                                             LearningRate const &criticLearningRate_,
                                                             LearningRate const &actorLearningRate_,
-                                                            double const &lambda_);
+                                                            double const &lambda_,
+                                                            std::string const &covariance_="full",
+                                                            size_t covarianceRank_=1,
+                                                            size_t covarianceBlockSize_=1,
+                                                            size_t populationSize_=1);
 
         /*!
          * make method for creating an agent of the given type.
@@ -120,34 +158,51 @@ class FactoryOfAgentsForTwoAssetsProblem
          */
         std::unique_ptr<Agent> make(std::string const &agentId) const;
 
-    private:
-        //! Standard constructor
-        FactoryOfAgentsForTwoAssetsProblem() = default;
-
-        //! Constructor
+        /*!
+         * Constructor of an independent factory, with the same arguments as
+         * the instance method.
+         */
         FactoryOfAgentsForTwoAssetsProblem(size_t const &dimObservation_,
                                            LearningRate const &baselineLearningRate_,
                                            LearningRate const &criticLearningRate_,
                                            LearningRate const &actorLearningRate_,
-                                           double const &lambda_);
-
-        FactoryOfAgentsForTwoAssetsProblem(FactoryOfAgents const &)=delete;
-        FactoryOfAgentsForTwoAssetsProblem& operator=(FactoryOfAgents const &)=delete;
+                                           double const &lambda_,
+                                           std::string const &covariance_,
+                                           size_t covarianceRank_,
+                                           size_t covarianceBlockSize_,
+                                           size_t populationSize_);
 
         //! Default destructor
         virtual ~FactoryOfAgentsForTwoAssetsProblem() = default;
 
+    private:
+        //! Standard constructor
+        FactoryOfAgentsForTwoAssetsProblem() = default;
+
+        FactoryOfAgentsForTwoAssetsProblem(FactoryOfAgents const &)=delete;
+        FactoryOfAgentsForTwoAssetsProblem& operator=(FactoryOfAgents const &)=delete;
+
         //! Builder for PGPE Agent
-        std::unique_ptr<ARACAgent> makePGPEAgent() const;
+        std::unique_ptr<PGPEARACAgent> makePGPEAgent() const;
 
         //! Builder for RSNPGPE Agent
         std::unique_ptr<RiskSensitiveNPGPEAgent> makeRSNPGPEAgent() const;
 
+        /*!
+         * Builder for the long-short controller of the PGPE agents, of fixed
+         * dimension if compiled for the observation size, see FixedDimensions.h.
+         */
+        std::unique_ptr<Policy> makeController() const;
+
         size_t dimObservation;
         std::unique_ptr<LearningRate> baselineLearningRatePtr;
         std::unique_ptr<LearningRate> criticLearningRatePtr;
         std::unique_ptr<LearningRate> actorLearningRatePtr;
         double lambda;
+        std::string covariance;
+        size_t covarianceRank;
+        size_t covarianceBlockSize;
+        size_t populationSize;
 };
 
 #endif // FACTORYOFAGENTS_H
@@ -0,0 +1,197 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef FIXEDBINARYPOLICY_H
+#define FIXEDBINARYPOLICY_H
+
+#include <thesis/Policy.h>
+#include <armadillo>        /* arma::vec::fixed */
+#include <algorithm>        /* std::min, std::max */
+#include <memory>           /* std::unique_ptr */
+#include <limits>           /* std::numeric_limits<double> */
+
+/*!
+ * FixedBinaryPolicy is the fixed-dimension counterpart of BinaryPolicy
+ * (DimAction = 1) and LongShortPolicy (DimAction = 2): the action is
+ *     a = sign( theta' * [1; observation] )
+ * and, for two assets, the opposite position is taken on the second one. The
+ * observation size is a compile-time constant, so that the parameters and the
+ * features are stored in the object instead of the heap and the loops over
+ * them have a constant trip count. The policy selects the same actions as its
+ * dynamic counterpart, from the same initial parameters.
+ */
+
+template<size_t DimObservation, size_t DimAction>
+class FixedBinaryPolicy final : public Policy
+{
+    static_assert(DimAction == 1 || DimAction == 2,
+                  "FixedBinaryPolicy trades one asset or two opposite positions");
+
+    public:
+        //! Size of the parameter vector
+        static const size_t dimParameters = DimObservation + 1;
+
+        /*!
+         * Constructor.
+         * Initialize a FixedBinaryPolicy object.
+         * \param paramMinValue_ parameters lower bound
+         * \param paramMaxValue_ parameters upper bound
+         */
+        FixedBinaryPolicy(double paramMinValue_=std::numeric_limits<double>::min(),
+                          double paramMaxValue_=std::numeric_limits<double>::max())
+            : Policy(DimObservation, DimAction),
+              paramMinValue(toRealBound(paramMinValue_)),
+              paramMaxValue(toRealBound(paramMaxValue_))
+        {
+            initializeParameters();
+        }
+
+        //! Default copy constructor
+        FixedBinaryPolicy(FixedBinaryPolicy const &other_) = default;
+
+        //! Default destructor.
+        virtual ~FixedBinaryPolicy() = default;
+
+        /*!
+         * Get policy parameters size, i.e. size of the parameter vector
+         * \return parameters size
+         */
+        virtual size_t getDimParameters() const { return dimParameters; }
+
+        using Policy::getParameters;
+        using Policy::getAction;
+        using Policy::getActions;
+
+        /*!
+         * Get method for the policy parameters.
+         * \param parameters_ output parameters, resized if needed
+         */
+        virtual void getParameters(RealVec &parameters_) const
+            { parameters_ = parameters; }
+
+        /*!
+         * Set method for the policy parameters. The parameters bounds are enforced.
+         * \param parameters_ the new parameters stored in an arma::vector
+         */
+        virtual void setParameters(RealVec const & parameters_)
+        {
+            for (size_t i = 0; i < dimParameters; ++i)
+                parameters(i) = std::min(std::max(parameters_(i), paramMinValue), paramMaxValue);
+        }
+
+        /*!
+         * Given an observation, select an action accordind to the policy.
+         * \param observation_ observation
+         * \param action_ output action, resized if needed
+         */
+        virtual void getAction(RealVec const & observation_,
+                               RealVec &action_) const
+        {
+            // Compute features
+            setFeatures(observation_);
+
+            // Compute action
+            Real activation = arma::dot(parameters, features);
+            action_.set_size(DimAction);
+            action_(0) = (activation > 0.0) ? 1.0 : -1.0;
+            if (DimAction == 2)
+                action_(1) = - action_(0);
+        }
+
+        /*!
+         * Given an observation, select the actions of a population of
+         * parameter vectors with a single matrix-vector product. The
+         * parameters bounds are enforced in place.
+         * \param observation_ observation
+         * \param parameters_ parameter vectors, one per column
+         * \param actions_ output actions, one per column, resized if needed
+         */
+        virtual void getActions(RealVec const & observation_,
+                                RealMat &parameters_,
+                                RealMat &actions_) const
+        {
+            // Enforce parameters bounds
+            parameters_.transform( [&](Real p) {
+                return std::min(std::max(p, paramMinValue), paramMaxValue); } );
+
+            // Compute features
+            setFeatures(observation_);
+
+            // Compute actions
+            activations = parameters_.t() * features;
+            actions_.set_size(DimAction, parameters_.n_cols);
+            for (size_t j = 0; j < parameters_.n_cols; ++j)
+            {
+                actions_(0, j) = (activations(j) > 0.0) ? 1.0 : -1.0;
+                if (DimAction == 2)
+                    actions_(1, j) = - actions_(0, j);
+            }
+        }
+
+        /*!
+         * Reset policy to initial conditions.
+         */
+        virtual void reset() { initializeParameters(); }
+
+    private:
+        //! Initialize FixedBinaryPolicy parameters
+        void initializeParameters()
+        {
+            parameters.randu();
+            parameters -= 0.5;
+            parameters *= 0.001;
+        }
+
+        //! Fill the features cache with [1; observation]
+        void setFeatures(RealVec const & observation_) const
+        {
+            features(0) = 1.0;
+            for (size_t i = 0; i < DimObservation; ++i)
+                features(i + 1) = observation_(i);
+        }
+
+        //! Policy parameters
+        RealVec::fixed<dimParameters> parameters;
+
+        /*!
+         * Parameters bounds.
+         * The parameters must lie in the interval [paramMinValue, paramMaxValue]
+         * This constraint can be useful to avoid divergence when modifying the
+         * parameters by gradient ascent in an optimization procedure.
+         */
+        Real paramMinValue;
+        Real paramMaxValue;
+
+        //! Features cache vector [1; observation]
+        mutable RealVec::fixed<dimParameters> features;
+
+        //! Activations cache vector for the batched evaluation
+        mutable RealVec activations;
+
+        //! Virtual inner clone method
+        virtual std::unique_ptr<Policy> cloneImpl() const
+        {
+            return std::unique_ptr<Policy>(new FixedBinaryPolicy(*this));
+        }
+};
+
+#endif // FIXEDBINARYPOLICY_H
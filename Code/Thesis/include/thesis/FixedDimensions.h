@@ -0,0 +1,57 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef FIXEDDIMENSIONS_H
+#define FIXEDDIMENSIONS_H
+
+#include <thesis/AssetAllocationTask.h>
+#include <thesis/FixedBinaryPolicy.h>
+#include <thesis/NpgpeAgent.h>
+
+/*!
+ * Fixed-dimension configurations compiled in the library. When the library is
+ * built with THESIS_FIXED_DAYS_OBSERVED defined, e.g. through the CMake cache
+ * variable of the same name, the factories use FixedBinaryPolicy controllers
+ * for the tasks on one or two risky assets observing that number of past
+ * days, and any other configuration falls back on the dynamic controllers.
+ */
+
+#ifdef THESIS_FIXED_DAYS_OBSERVED
+
+//! Observation size of the single-asset and two-assets fixed configurations
+static const size_t fixedSingleAssetDimObservation =
+    AssetAllocationTask::dimObservationFor(1, THESIS_FIXED_DAYS_OBSERVED);
+static const size_t fixedTwoAssetsDimObservation =
+    AssetAllocationTask::dimObservationFor(2, THESIS_FIXED_DAYS_OBSERVED);
+
+//! Long-short controller of a single risky asset
+typedef FixedBinaryPolicy<fixedSingleAssetDimObservation, 1> FixedSingleAssetPolicy;
+
+//! Long-short controller of two risky assets
+typedef FixedBinaryPolicy<fixedTwoAssetsDimObservation, 2> FixedTwoAssetsPolicy;
+
+//! NPGPE agent on the single-asset fixed controller
+typedef BasicNPGPEAgent<FixedSingleAssetPolicy> FixedNPGPEAgent;
+
+#endif // THESIS_FIXED_DAYS_OBSERVED
+
+#endif // FIXEDDIMENSIONS_H
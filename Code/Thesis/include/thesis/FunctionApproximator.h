@@ -23,6 +23,7 @@
 #ifndef FUNCTIONAPPROXIMATOR_H
 #define FUNCTIONAPPROXIMATOR_H
 
+#include <thesis/Precision.h>  /* RealVec, RealMat */
 #include <armadillo>  /* arma::vec */
 #include <memory>     /* std::unique_ptr */
 
@@ -71,27 +72,50 @@ class FunctionApproximator
          * Get method for the function approximator parameters.
          * \return parameters stored in an arma::vector
          */
-        virtual arma::vec getParameters() const = 0;
+        RealVec getParameters() const
+        {
+            RealVec parameters(getDimParameters());
+            getParameters(parameters);
+            return parameters;
+        }
+
+        /*!
+         * Get method for the parameters in a preallocated vector.
+         * \param parameters_ output parameters, resized if needed
+         */
+        virtual void getParameters(RealVec &parameters_) const = 0;
 
         /*!
          * Set method for the function approximator parameters.
          * \param parameters_ the new parameters stored in an arma::vector
          */
-        virtual void setParameters(arma::vec const &parameters_) = 0;
+        virtual void setParameters(RealVec const &parameters_) = 0;
 
         /*!
          * Evaluate the function approximator for a given input.
          * \param x input vector
          * \return evaluation of the function approximator in x
          */
-        virtual double evaluate(arma::vec const &x) const = 0;
+        virtual double evaluate(RealVec const &x) const = 0;
 
         /*!
          * Evaluate the function approximator gradient wrt the parameters.
          * \param x input vector
          * \return function approximator gradient evaluated in x
          */
-        virtual arma::vec gradient(arma::vec const &x) const = 0;
+        RealVec gradient(RealVec const &x) const
+        {
+            RealVec grad(getDimParameters());
+            gradient(x, grad);
+            return grad;
+        }
+
+        /*!
+         * Evaluate the gradient wrt the parameters in a preallocated vector.
+         * \param x input vector
+         * \param grad_ output gradient, resized if needed
+         */
+        virtual void gradient(RealVec const &x, RealVec &grad_) const = 0;
 
         //! Reset function approximator parameters to initial conditions
         virtual void reset() = 0;
@@ -24,6 +24,7 @@
 #define GAUSSIANDISTRIBUTION_H
 
 #include <thesis/ProbabilityDistribution.h>
+#include <thesis/Philox.h>
 #include <armadillo>  /* arma::vec */
 #include <memory>     /* std::unique_ptr */
 #include <fstream>
@@ -63,51 +64,77 @@ class GaussianDistribution : public ProbabilityDistribution
          */
         virtual size_t getDimParameters() const { return dimParameters; }
 
+        using ProbabilityDistribution::getParameters;
+        using ProbabilityDistribution::simulate;
+        using ProbabilityDistribution::likelihoodScore;
+
         /*!
          * Get method for the distribution parameters.
-         * \return parameters stored in an arma::vector
+         * \param parameters_ output parameters, resized if needed
          */
-        virtual arma::vec getParameters() const { return parameters; }
+        virtual void getParameters(RealVec &parameters_) const
+            { parameters_ = parameters; }
 
         /*!
          * Set method for the distribution parameters.
          * \param parameters_ the new parameters stored in an arma::vector
          */
-        virtual void setParameters(arma::vec const &parameters_)
+        virtual void setParameters(RealVec const &parameters_)
             { parameters = parameters_; }
 
         /*!
          * Simulate a realization of the probability distribution.
-         * \return realization of the probability distribution
+         * \param simulation_ output realization, resized if needed
          */
-        virtual arma::vec simulate() const;
+        virtual void simulate(RealVec &simulation_) const;
 
         /*!
          * Evaluate the Likelihood score of a given realization
          * \param output_ distribution realization
-         * \return likelihood score evaluated at output_
+         * \param likScore_ output likelihood score evaluated at output_,
+         *        resized if needed
          */
-        virtual arma::vec likelihoodScore(arma::vec const &output_) const;
+        virtual void likelihoodScore(RealVec const &output_,
+                                     RealVec &likScore_) const;
 
         /*!
          * Reset distribution to initial conditions.
          */
         virtual void reset();
 
+        /*!
+         * Seed the random number generator used by the distribution.
+         * \param seed_ seed of the random number generator
+         */
+        virtual void seed(unsigned int seed_);
+
+        /*!
+         * Write the mean, the standard deviations and the generator state to a
+         * snapshot.
+         * \param writer_ snapshot writer
+         */
+        virtual void saveState(CheckpointWriter &writer_) const;
+
+        /*!
+         * Read the distribution state from a snapshot written by saveState.
+         * \param reader_ snapshot reader
+         */
+        virtual void loadState(CheckpointReader &reader_);
+
     private:
 
         //! Initialize distribution parameters
         void initializeParameters();
 
         //! Parameters: [mu_1; ... ; mu_D; sigma_1; ... ; sigma_D]
-        arma::vec parameters;
+        RealVec parameters;
 
         //! Sizes
         size_t dimOutput;
         size_t dimParameters;
 
         //! Random number generator
-        mutable std::mt19937 generator;
+        mutable Philox4x32 generator;
 };
 
 #endif // GAUSSIANDISTRIBUTION_H
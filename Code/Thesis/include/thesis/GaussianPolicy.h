@@ -24,9 +24,9 @@
 #define GAUSSIANPOLICY_H
 
 #include <thesis/StochasticPolicy.h>
+#include <thesis/Philox.h>            /* Philox4x32 */
 #include <armadillo>                  /* arma::vec */
 #include <vector>                     /* std::vector */
-#include <random>                     /* std::normal_distribution */
 
 
 
@@ -50,6 +50,12 @@ class GaussianPolicy : public StochasticPolicy
         GaussianPolicy(size_t dimObservation_,
                        size_t dimAction_);
 
+        /*!
+         * Copy constructor for correct instantiation of polymorphic objects.
+         * The parameters views are rebound to the memory of the new object.
+         */
+        GaussianPolicy(GaussianPolicy const &other_);
+
         //! Default destructor
         virtual ~GaussianPolicy() = default;
 
@@ -65,40 +71,65 @@ class GaussianPolicy : public StochasticPolicy
          */
         virtual size_t getDimParameters() const { return dimParameters; }
 
+        using StochasticPolicy::getParameters;
+        using StochasticPolicy::getAction;
+        using StochasticPolicy::likelihoodScore;
+
         /*!
          * Get method for the policy parameters.
-         * \return parameters stored in an arma::vector
+         * \param parameters_ output parameters, resized if needed
          */
-        virtual arma::vec getParameters() const;
+        virtual void getParameters(RealVec &parameters_) const;
 
         /*!
          * Set method for the policy parameters.
          * \param parameters_ the new parameters stored in an arma::vector
          */
-        virtual void setParameters(arma::vec const &parameters_);
+        virtual void setParameters(RealVec const &parameters_);
 
         /*!
          * Given an observation, select an action accordind to the policy.
          * \param observation_ observation
-         * \return action
+         * \param action_ output action, resized if needed
          */
-        virtual arma::vec getAction(arma::vec const &observation_) const;
+        virtual void getAction(RealVec const &observation_,
+                               RealVec &action_) const;
 
         /*!
          * Evaluate the Likelihood score function at a given observation and
          * action.
          * \param observation_ observation
          * \param action_ action
-         * \return likelihood score evaluated at observation_ and action_
+         * \param likScore_ output likelihood score evaluated at observation_
+         *        and action_, resized if needed
          */
-        virtual arma::vec likelihoodScore(arma::vec const &observation_,
-                                          arma::vec const &action_) const;
+        virtual void likelihoodScore(RealVec const &observation_,
+                                     RealVec const &action_,
+                                     RealVec &likScore_) const;
 
         /*!
          * Reset policy to initial conditions.
          */
         virtual void reset();
 
+        /*!
+         * Seed the random number generator used by the policy.
+         * \param seed_ seed of the random number generator
+         */
+        virtual void seed(unsigned int seed_);
+
+        /*!
+         * Write the policy parameters and the generator state to a snapshot.
+         * \param writer_ snapshot writer
+         */
+        virtual void saveState(CheckpointWriter &writer_) const;
+
+        /*!
+         * Read the policy state from a snapshot written by saveState.
+         * \param reader_ snapshot reader
+         */
+        virtual void loadState(CheckpointReader &reader_);
+
     private:
         //! Virtual inner clone method
         virtual std::unique_ptr<Policy> cloneImpl() const;
@@ -110,14 +141,19 @@ class GaussianPolicy : public StochasticPolicy
         size_t dimParameters;
 
         //! Policy parameters: Theta = {psi, sigma}
-        arma::vec parameters;
-        arma::mat psiMat;      // mean parameters matrix (shares memory)
+        RealVec parameters;
+        RealMat psiMat;      // mean parameters matrix (shares memory)
 
         /*!
          * Random number generator. Need to be mutable because the generator
          * state changes when simulating an action.
          */
-        mutable std::mt19937 generator;
+        mutable Philox4x32 generator;
+
+        //! Cache vectors for features [1; observation], mean and action delta
+        mutable RealVec features;
+        mutable RealVec mean;
+        mutable RealVec deltaAction;
 };
 
 #endif // GAUSSIANPOLICY_H
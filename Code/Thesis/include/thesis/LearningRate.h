@@ -23,6 +23,7 @@
 #ifndef LEARNINGRATE_H
 #define LEARNINGRATE_H
 
+#include <thesis/Checkpoint.h>
 #include <math.h>  /* pow */
 #include <memory>  /* unique_ptr */
 
@@ -60,6 +61,18 @@ class LearningRate
          * Reset learning rate to initial conditions.
          */
         virtual void reset() = 0;
+
+        /**
+         * Write the current position in the schedule to a snapshot.
+         * \param writer_ snapshot writer
+         */
+        virtual void saveState(CheckpointWriter &writer_) const = 0;
+
+        /**
+         * Read the position in the schedule from a snapshot.
+         * \param reader_ snapshot reader
+         */
+        virtual void loadState(CheckpointReader &reader_) = 0;
 };
 
 /**
@@ -103,6 +116,17 @@ class ConstantLearningRate : public LearningRate
          */
         virtual void reset() { /* Nothing to do */ }
 
+        /**
+         * Write the learning rate state to a snapshot. A constant learning
+         * rate has no state.
+         */
+        virtual void saveState(CheckpointWriter &writer_) const { /* Nothing to do */ }
+
+        /**
+         * Read the learning rate state from a snapshot.
+         */
+        virtual void loadState(CheckpointReader &reader_) { /* Nothing to do */ }
+
     private:
         double learningRate;
 };
@@ -150,6 +174,16 @@ class DecayingLearningRate : public LearningRate
          */
         virtual void reset();
 
+        /**
+         * Write the current iteration and learning rate to a snapshot.
+         */
+        virtual void saveState(CheckpointWriter &writer_) const;
+
+        /**
+         * Read the current iteration and learning rate from a snapshot.
+         */
+        virtual void loadState(CheckpointReader &reader_);
+
     private:
         double learningRate;
         double c;
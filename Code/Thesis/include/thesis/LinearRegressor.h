@@ -34,7 +34,7 @@
  * Approximator abstract class.
  */
 
-class LinearRegressor : public FunctionApproximator
+class LinearRegressor final : public FunctionApproximator
 {
     public:
         /*!
@@ -60,31 +60,34 @@ class LinearRegressor : public FunctionApproximator
          */
         virtual size_t getDimParameters() const { return parameters.n_elem; }
 
+        using FunctionApproximator::getParameters;
+        using FunctionApproximator::gradient;
+
         /*!
          * Get method for the linear regressor parameters.
-         * \return parameters stored in an arma::vector
+         * \param parameters_ output parameters, resized if needed
          */
-        virtual arma::vec getParameters() const;
+        virtual void getParameters(RealVec &parameters_) const;
 
         /*!
          * Set method for the linear regressor parameters.
          * \param parameters_ the new parameters stored in an arma::vector
          */
-        virtual void setParameters(arma::vec const &parameters_);
+        virtual void setParameters(RealVec const &parameters_);
 
         /*!
          * Evaluate the linear regressor at a given input.
          * \param x input vector
          * \return evaluation of the linear regressor in x
          */
-        virtual double evaluate(arma::vec const &x) const;
+        virtual double evaluate(RealVec const &x) const;
 
         /*!
          * Evaluate the function approximator gradient wrt the parameters.
          * \param x input vector
-         * \return function approximator gradient evaluated in x
+         * \param grad_ output gradient evaluated in x, resized if needed
          */
-        virtual arma::vec gradient(arma::vec const &x) const;
+        virtual void gradient(RealVec const &x, RealVec &grad_) const;
 
         //! Reset linear regressor parameters to initial conditions
         virtual void reset();
@@ -94,7 +97,7 @@ class LinearRegressor : public FunctionApproximator
         void initializeParameters();
 
         //! Parameters
-        arma::vec parameters;
+        RealVec parameters;
 };
 
 #endif // LINEARREGRESSOR_H
@@ -0,0 +1,153 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef LOCKFREEQUEUE_H
+#define LOCKFREEQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * LockFreeQueue implements a bounded multi-producer multi-consumer FIFO queue
+ * on a ring buffer. Each slot carries a sequence number that tells producers
+ * and consumers whether it is free or full for the current lap, so that push
+ * and pop only need a compare-and-swap on the shared position and never block.
+ * When the queue is full (empty) push (pop) returns false and the caller
+ * decides whether to retry, yield or do something else.
+ *
+ * It is used by the asynchronous actor-learner to pass batches of transitions
+ * from the actor threads to the learner thread and back.
+ */
+
+template<typename T>
+class LockFreeQueue
+{
+    public:
+        /*!
+         * Constructor.
+         * \param capacity_ maximum number of elements, a power of two.
+         */
+        explicit LockFreeQueue(size_t capacity_)
+            : slots(capacity_),
+              mask(capacity_ - 1),
+              pushPosition(0),
+              popPosition(0)
+        {
+            if (capacity_ < 2 || (capacity_ & (capacity_ - 1)) != 0)
+                throw std::invalid_argument("LockFreeQueue: the capacity must be a power of two");
+            for (size_t i = 0; i < capacity_; ++i)
+                slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        //! Deleted copy constructor: the queue is shared by reference.
+        LockFreeQueue(LockFreeQueue const &other_) = delete;
+
+        //! Deleted assignment operator.
+        LockFreeQueue &operator=(LockFreeQueue const &other_) = delete;
+
+        /*!
+         * Append an element.
+         * \param value_ element.
+         * \return false if the queue is full.
+         */
+        bool push(T const &value_)
+        {
+            size_t position = pushPosition.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                Slot &slot = slots[position & mask];
+                size_t sequence = slot.sequence.load(std::memory_order_acquire);
+                std::ptrdiff_t lap = static_cast<std::ptrdiff_t>(sequence - position);
+                if (lap == 0)
+                {
+                    // Free slot: claim it
+                    if (pushPosition.compare_exchange_weak(position, position + 1,
+                                                           std::memory_order_relaxed))
+                    {
+                        slot.value = value_;
+                        slot.sequence.store(position + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (lap < 0)
+                    return false;
+                else
+                    position = pushPosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        /*!
+         * Remove the oldest element.
+         * \param value_ output element.
+         * \return false if the queue is empty.
+         */
+        bool pop(T &value_)
+        {
+            size_t position = popPosition.load(std::memory_order_relaxed);
+            for (;;)
+            {
+                Slot &slot = slots[position & mask];
+                size_t sequence = slot.sequence.load(std::memory_order_acquire);
+                std::ptrdiff_t lap = static_cast<std::ptrdiff_t>(sequence - (position + 1));
+                if (lap == 0)
+                {
+                    // Full slot: claim it
+                    if (popPosition.compare_exchange_weak(position, position + 1,
+                                                          std::memory_order_relaxed))
+                    {
+                        value_ = slot.value;
+                        slot.sequence.store(position + mask + 1, std::memory_order_release);
+                        return true;
+                    }
+                }
+                else if (lap < 0)
+                    return false;
+                else
+                    position = popPosition.load(std::memory_order_relaxed);
+            }
+        }
+
+    private:
+        //! Ring buffer slot
+        struct Slot
+        {
+            std::atomic<size_t> sequence;
+            T value;
+        };
+
+        //! Size of a cache line, used to keep the positions apart
+        static const size_t cacheLineSize = 64;
+
+        //! Ring buffer and index mask
+        std::vector<Slot> slots;
+        size_t const mask;
+
+        //! Positions of the next push and of the next pop, kept on separate
+        //! lines by the padding, which does not rely on over-aligned new
+        std::atomic<size_t> pushPosition;
+        char padding[cacheLineSize - sizeof(std::atomic<size_t>)];
+        std::atomic<size_t> popPosition;
+};
+
+#endif // LOCKFREEQUEUE_H
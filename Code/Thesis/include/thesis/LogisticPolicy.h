@@ -62,24 +62,29 @@ class LogisticPolicy : public Policy
          */
         virtual size_t getDimParameters() const { return dimParameters; }
 
+        using Policy::getParameters;
+        using Policy::getAction;
+
         /*!
          * Get method for the policy parameters.
-         * \return parameters stored in an arma::vector
+         * \param parameters_ output parameters, resized if needed
          */
-        virtual arma::vec getParameters() const { return parameters; }
+        virtual void getParameters(RealVec &parameters_) const
+            { parameters_ = parameters; }
 
         /*!
          * Set method for the policy parameters. The parameters bounds are enforced.
          * \param parameters_ the new parameters stored in an arma::vector
          */
-        virtual void setParameters(arma::vec const & parameters_);
+        virtual void setParameters(RealVec const & parameters_);
 
         /*!
          * Given an observation, select an action accordind to the policy.
          * \param observation_ observation
-         * \return action
+         * \param action_ output action, resized if needed
          */
-        virtual arma::vec getAction(arma::vec const & observation_) const;
+        virtual void getAction(RealVec const & observation_,
+                               RealVec &action_) const;
 
         /*!
          * Reset policy to initial conditions.
@@ -94,7 +99,7 @@ class LogisticPolicy : public Policy
         void initializeParameters();
 
         //! Policy parameters
-        arma::vec parameters;
+        RealVec parameters;
         size_t dimParameters;
 
         /*!
@@ -103,8 +108,11 @@ class LogisticPolicy : public Policy
          * This constraint can be useful to avoid divergence when modifying the
          * parameters by gradient ascent in an optimization procedure.
          */
-        double paramMinValue;
-        double paramMaxValue;
+        Real paramMinValue;
+        Real paramMaxValue;
+
+        //! Features cache vector [1; observation]
+        mutable RealVec features;
 };
 
 #endif // LOGISTICPOLICY_H
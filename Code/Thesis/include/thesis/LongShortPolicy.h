@@ -39,24 +39,42 @@ class LongShortPolicy: public Policy
          */
         virtual size_t getDimParameters() const { return dimParameters; }
 
+        using Policy::getParameters;
+        using Policy::getAction;
+        using Policy::getActions;
+
         /*!
          * Get method for the policy parameters.
-         * \return parameters stored in an arma::vector
+         * \param parameters_ output parameters, resized if needed
          */
-        virtual arma::vec getParameters() const { return parameters; }
+        virtual void getParameters(RealVec &parameters_) const
+            { parameters_ = parameters; }
 
         /*!
          * Set method for the policy parameters. The parameters bounds are enforced.
          * \param parameters_ the new parameters stored in an arma::vector
          */
-        virtual void setParameters(arma::vec const & parameters_);
+        virtual void setParameters(RealVec const & parameters_);
 
         /*!
          * Given an observation, select an action accordind to the policy.
          * \param observation_ observation
-         * \return action
+         * \param action_ output action, resized if needed
          */
-        virtual arma::vec getAction(arma::vec const & observation_) const;
+        virtual void getAction(RealVec const & observation_,
+                               RealVec &action_) const;
+
+        /*!
+         * Given an observation, select the actions of a population of
+         * parameter vectors with a single matrix-vector product. The
+         * parameters bounds are enforced in place.
+         * \param observation_ observation
+         * \param parameters_ parameter vectors, one per column
+         * \param actions_ output actions, one per column, resized if needed
+         */
+        virtual void getActions(RealVec const & observation_,
+                                RealMat &parameters_,
+                                RealMat &actions_) const;
 
         /*!
          * Reset policy to initial conditions.
@@ -68,7 +86,7 @@ class LongShortPolicy: public Policy
         void initializeParameters();
 
         //! Policy parameters
-        arma::vec parameters;
+        RealVec parameters;
         size_t dimParameters;
 
         /*!
@@ -77,8 +95,14 @@ class LongShortPolicy: public Policy
          * This constraint can be useful to avoid divergence when modifying the
          * parameters by gradient ascent in an optimization procedure.
          */
-        double paramMinValue;
-        double paramMaxValue;
+        Real paramMinValue;
+        Real paramMaxValue;
+
+        //! Features cache vector [1; observation]
+        mutable RealVec features;
+
+        //! Activations cache vector for the batched evaluation
+        mutable RealVec activations;
 
         //! Virtual inner clone method
         virtual std::unique_ptr<Policy> cloneImpl() const;
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef MARKETDATA_H
+#define MARKETDATA_H
+
+#include <thesis/MarketDataFile.h>
+#include <armadillo>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * MarketData is the read-only store of the historical log-return series of a
+ * financial market. It is shared through a std::shared_ptr<MarketData const>
+ * by all the copies of a MarketEnvironment, so that cloning an environment,
+ * a task or an experiment never copies the return series. The series is read
+ * either from a CSV file or from a memory-mapped binary file (see
+ * MarketDataFile).
+ */
+
+class MarketData
+{
+    public:
+        /**
+         * Constructor.
+         * Read the historical log-return series from an input file.
+         * \param inputFilePath path to the CSV or binary input file
+         */
+        explicit MarketData(std::string const &inputFilePath);
+
+        /**
+         * Constructor.
+         * Initialize the store from an in-memory return series.
+         * \param assetsSymbols_ assets ticker symbols
+         * \param assetsReturns_ log-returns of size numRiskyAssets x numDays
+         */
+        MarketData(std::vector<std::string> const &assetsSymbols_,
+                   arma::mat const &assetsReturns_);
+
+        //! Deleted copy constructor: the store is shared, not copied.
+        MarketData(MarketData const &other_) = delete;
+
+        //! Deleted assignment operator.
+        MarketData &operator=(MarketData const &other_) = delete;
+
+        //! Default destructor.
+        ~MarketData() = default;
+
+        //! Get assets ticker symbols.
+        std::vector<std::string> const &getAssetsSymbols() const { return assetsSymbols; }
+
+        //! Get total number of days in the time series.
+        size_t getNumDays() const { return numDays; }
+
+        //! Get number of risky assets available on the market.
+        size_t getNumRiskyAssets() const { return numRiskyAssets; }
+
+        /**
+         * Get log-return series.
+         * \return matrix of size numRiskyAssets x numDays.
+         */
+        arma::mat const &getAssetsReturns() const { return assetsReturns; }
+
+        /**
+         * Save the return series in the binary format.
+         * \param outputFilePath path to the output file
+         */
+        void save(std::string const &outputFilePath) const;
+
+    private:
+        /**
+         * Read the CSV input file.
+         * \param inputFilePath path to the input file
+         */
+        void readCsv(std::string const &inputFilePath);
+
+        //! Memory mapping of the binary input file, if any.
+        std::unique_ptr<MarketDataFile const> dataFilePtr;
+
+        //! Asset ticker symbols.
+        std::vector<std::string> assetsSymbols;
+
+        /**
+         * Log-return time series.
+         * The matrix is of size numRiskyAssets X numDays for faster slicing.
+         * For binary input files it uses the mapped memory in place.
+         */
+        arma::mat assetsReturns;
+
+        //! Total number of time steps.
+        size_t numDays;
+
+        //! Number of risky assets in the market.
+        size_t numRiskyAssets;
+};
+
+#endif // MARKETDATA_H
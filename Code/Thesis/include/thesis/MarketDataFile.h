@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef MARKETDATAFILE_H
+#define MARKETDATAFILE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <armadillo>
+
+/**
+ * MarketDataFile is a read-only memory mapping of a binary return-series file.
+ * The binary format is a compact alternative to the CSV input files, which
+ * allows the MarketEnvironment to use the log-returns in place, without
+ * parsing nor copying them. The file layout, in native byte order, is
+ *
+ *  - magic number "THRETBIN" (8 bytes),
+ *  - format version (uint32) and offset of the data block (uint32),
+ *  - number of days and number of risky assets (uint64),
+ *  - size of the symbols string (uint64),
+ *  - comma-separated assets symbols, padded with zeros,
+ *  - numRiskyAssets x numDays doubles stored column-wise, i.e. the log-returns
+ *    of one day are contiguous, starting at a 64-byte aligned offset.
+ */
+
+class MarketDataFile
+{
+    public:
+        /**
+         * Constructor.
+         * Map a binary return-series file in memory.
+         * \param filePath path to the binary file
+         */
+        explicit MarketDataFile(std::string const &filePath);
+
+        //! Deleted copy constructor: the object owns the mapping.
+        MarketDataFile(MarketDataFile const &other_) = delete;
+
+        //! Deleted assignment operator.
+        MarketDataFile &operator=(MarketDataFile const &other_) = delete;
+
+        //! Destructor. Unmap the file.
+        ~MarketDataFile();
+
+        //! Get assets ticker symbols.
+        std::vector<std::string> getAssetsSymbols() const { return assetsSymbols; }
+
+        //! Get total number of days in the time series.
+        size_t getNumDays() const { return numDays; }
+
+        //! Get number of risky assets.
+        size_t getNumRiskyAssets() const { return numRiskyAssets; }
+
+        /**
+         * Get pointer to the mapped log-returns, stored column-wise in a
+         * numRiskyAssets x numDays matrix. The memory is read-only.
+         */
+        double const *getReturns() const { return returns; }
+
+        /**
+         * Check whether a file is in the binary return-series format.
+         * \param filePath path to the file
+         * \return true if the file starts with the binary magic number
+         */
+        static bool isMarketDataFile(std::string const &filePath);
+
+        /**
+         * Write a return series in the binary format.
+         * \param filePath path to the output file
+         * \param assetsSymbols_ assets ticker symbols
+         * \param assetsReturns_ log-returns matrix of size numRiskyAssets x numDays
+         */
+        static void write(std::string const &filePath,
+                          std::vector<std::string> const &assetsSymbols_,
+                          arma::mat const &assetsReturns_);
+
+    private:
+        //! Assets ticker symbols.
+        std::vector<std::string> assetsSymbols;
+
+        //! Total number of time steps.
+        size_t numDays;
+
+        //! Number of risky assets.
+        size_t numRiskyAssets;
+
+        //! Mapped region.
+        void *mapping;
+        size_t mappingSize;
+
+        //! Log-returns inside the mapped region.
+        double const *returns;
+};
+
+#endif // MARKETDATAFILE_H
@@ -24,7 +24,9 @@
 #define MARKETENVIRONMENT_H
 
 #include <thesis/Environment.h>
+#include <thesis/MarketData.h>
 #include <armadillo>
+#include <memory>
 #include <vector>
 #include <string>
 
@@ -35,6 +37,9 @@
  * {0, 1, ... }. The 0-th asset is by assumption a risk-less asset whose price
  * grows at a risk-free rate. A trading system will interact with the market in
  * the asset allocation task.
+ *
+ * The time series are stored in a MarketData object shared by all the copies
+ * of the environment, which only own their time-step cursors.
  */
 
 class MarketEnvironment : public Environment
@@ -43,14 +48,21 @@ class MarketEnvironment : public Environment
         /**
          * Constructor.
          * Initialize the financial market reading the historical log-return
-         * series from an input file.
+         * series from an input file. The file is either a CSV file or a
+         * binary return-series file (see MarketDataFile), which is memory
+         * mapped and used in place.
          * \param inputFilePath path to the input file
-         * \param startDate_ initial time step
-         * \param endDate_ final time step
          */
         MarketEnvironment(std::string inputFilePath);
 
-        //! Default copy constructor.
+        /**
+         * Constructor.
+         * Initialize the financial market on an existing return series store.
+         * \param marketDataPtr_ shared read-only return series
+         */
+        MarketEnvironment(std::shared_ptr<MarketData const> marketDataPtr_);
+
+        //! Copy constructor. The return series are shared, not copied.
         MarketEnvironment(MarketEnvironment const &market_);
 
         //! Virtual destructor.
@@ -67,6 +79,12 @@ class MarketEnvironment : public Environment
          */
         virtual arma::vec getState() const;
 
+        /**
+         * Get system state in a preallocated vector.
+         * \param state_ output risky assets log-returns, resized if needed.
+         */
+        virtual void getState(arma::vec &state_) const;
+
         /**
          * Perform Action on the system.
          * Select a portfolio allocation for the I risky assets. The system
@@ -77,13 +95,17 @@ class MarketEnvironment : public Environment
         virtual void performAction(arma::vec const &action);
 
         //!Get assets ticker symbols.
-        std::vector<std::string> getAssetsSymbols() const { return assetsSymbols; }
+        virtual std::vector<std::string> getAssetsSymbols() const
+            { return marketDataPtr->getAssetsSymbols(); }
 
         //! Get total number of days in the time series.
-        size_t getNumDays() const { return numDays; }
+        virtual size_t getNumDays() const { return marketDataPtr->getNumDays(); }
 
         //! Get number of risky assets available on the market
-        size_t getNumRiskyAssets() const { return numRiskyAssets; }
+        size_t getNumRiskyAssets() const { return dimState; }
+
+        //! Get shared read-only return series, empty for generated markets.
+        std::shared_ptr<MarketData const> getMarketData() const { return marketDataPtr; }
 
         //! Get dimension of the state space.
         virtual size_t getDimState() const { return dimState; }
@@ -112,21 +134,26 @@ class MarketEnvironment : public Environment
         //! Reset market environment to initial condition.
         virtual void reset();
 
-    private:
-        //! Asset ticker symbols.
-        std::vector<std::string> assetsSymbols;
-
         /**
-         * Log-return time series.
-         * The matrix is of size numRiskyAssets X numDays for faster slicing.
+         * Save the return series in the binary format, which can be used as
+         * input file in place of the original CSV file.
+         * \param outputFilePath path to the output file
          */
-        arma::mat assetsReturns;
+        void save(std::string const &outputFilePath) const;
 
-        //! Total number of time steps.
-        size_t numDays;
+    protected:
+        /**
+         * Constructor.
+         * Initialize a financial market whose return series are generated
+         * by a derived class instead of being read from a MarketData store.
+         * \param numRiskyAssets_ number of risky assets
+         * \param numDays_ number of days of the evaluation interval
+         */
+        MarketEnvironment(size_t numRiskyAssets_, size_t numDays_);
 
-        //! Number of risky assets in the market.
-        size_t numRiskyAssets;
+    private:
+        //! Shared read-only log-return time series.
+        std::shared_ptr<MarketData const> marketDataPtr;
 
         //! State space dimension
         size_t dimState;
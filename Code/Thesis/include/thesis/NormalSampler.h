@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NORMALSAMPLER_H
+#define NORMALSAMPLER_H
+
+#include <thesis/Philox.h>
+#include <armadillo>
+#include <cstddef>
+
+/**
+ * Bulk sampling of standard normal variates from a Philox4x32 stream.
+ *
+ * Every 128-bit Philox block is turned into two uniforms with 53 random bits
+ * and then into two normal variates by the Box-Muller transform. The samples
+ * are produced in batches: the counter-based generator fills a buffer of
+ * blocks and the transform runs as a branch-free loop over the buffer, which
+ * replaces the per-scalar std::normal_distribution draws and their rejection
+ * loop.
+ *
+ * The position of the generator is first rounded up to a block boundary,
+ * hence a sample only depends on the key, the sub-stream and its block.
+ */
+
+/*!
+ * Fill an array with standard normal variates.
+ * \param generator_ random number generator, advanced past the used blocks.
+ * \param values_ output array.
+ * \param numValues_ number of values.
+ */
+void fillStandardNormal(Philox4x32 &generator_, double *values_, size_t numValues_);
+
+//! Fill an array of single-precision values with standard normal variates.
+void fillStandardNormal(Philox4x32 &generator_, float *values_, size_t numValues_);
+
+/*!
+ * Fill a matrix or a vector with standard normal variates.
+ * \param generator_ random number generator, advanced past the used blocks.
+ * \param values_ output matrix, whose size is preserved.
+ */
+template<typename eT>
+inline void fillStandardNormal(Philox4x32 &generator_, arma::Mat<eT> &values_)
+{
+    fillStandardNormal(generator_, values_.memptr(), values_.n_elem);
+}
+
+#endif // NORMALSAMPLER_H
@@ -25,8 +25,12 @@
 
 #include <thesis/Agent.h>
 #include <thesis/Policy.h>
+#include <thesis/BinaryPolicy.h>
 #include <thesis/Statistics.h>
 #include <thesis/LearningRate.h>
+#include <thesis/ParameterCovariance.h>
+#include <thesis/NpgpePopulation.h>
+#include <thesis/Philox.h>
 #include <memory>
 
 /*!
@@ -35,33 +39,62 @@
  * parameters. For further information on NPGPE, please refer to "Miyamae et Al. -
  * Natural Policy Gradient Methods with Parameter-based Exploration for Control
  * Tasks (2010)".
+ *
+ * The agent is a template on the type of the controller: NPGPEAgent holds any
+ * deterministic policy, while BinaryNPGPEAgent, built by FactoryOfAgents,
+ * calls the BinaryPolicy controller directly instead of through the virtual
+ * table.
  */
 
-class NPGPEAgent : public Agent
+template<class PolicyT>
+class BasicNPGPEAgent final : public Agent
 {
     public:
 
         /*!
          * Constructor.
-         * Initialize an NPGPEAgent given a deterministic policy.
+         * Initialize an NPGPEAgent given a deterministic policy, with a full
+         * covariance matrix of the parameter distribution.
          * \param policy_ deterministic controller.
          * \param baselineLearningRate_ learning rate for the reward baseline.
          * \param hyperparamsLearningRate_ learning rate for the hyperparameters.
          * \param discount_ discount factor
          */
-        NPGPEAgent(Policy const &policy_,
-                   LearningRate const &baselineLearningRate_,
-                   LearningRate const &hyperparamsLearningRate_,
-                   double lambda_);
+        BasicNPGPEAgent(PolicyT const &policy_,
+                        LearningRate const &baselineLearningRate_,
+                        LearningRate const &hyperparamsLearningRate_,
+                        double lambda_);
+
+        /*!
+         * Constructor.
+         * Initialize an NPGPEAgent given a deterministic policy and the
+         * structure of the covariance of the parameter distribution.
+         * \param policy_ deterministic controller.
+         * \param covariance_ covariance structure, e.g. DiagonalCovariance for
+         *        controllers with many parameters.
+         * \param baselineLearningRate_ learning rate for the reward baseline.
+         * \param hyperparamsLearningRate_ learning rate for the hyperparameters.
+         * \param lambda_ eligibility trace parameter
+         * \param populationSize_ number of parameter samples evaluated at each
+         *        step. With more than one sample, the controller must support
+         *        batched evaluation and the task must provide the rewards of
+         *        the candidate actions.
+         */
+        BasicNPGPEAgent(PolicyT const &policy_,
+                        ParameterCovariance const &covariance_,
+                        LearningRate const &baselineLearningRate_,
+                        LearningRate const &hyperparamsLearningRate_,
+                        double lambda_,
+                        size_t populationSize_=1);
 
         /*!
          * Copy constructor.
          * \param other_ NPGPEAgent to copy.
          */
-        NPGPEAgent(NPGPEAgent const &other_);
+        BasicNPGPEAgent(BasicNPGPEAgent const &other_);
 
         //! Default destructor.
-        virtual ~NPGPEAgent() = default;
+        virtual ~BasicNPGPEAgent() = default;
 
         //! Clone method for virtual copy constructor
         virtual std::unique_ptr<Agent> clone() const;
@@ -76,15 +109,17 @@ class NPGPEAgent : public Agent
          * \param observation system state observation.
          */
         virtual void receiveObservation(arma::vec const &observation_)
-            { observation = observation_; }
+            { convertTo(observation_, observation); }
+
+        using Agent::getAction;
 
         /*!
          * Get action A_t to be performed on the system. This action will be
          * passed to a task object, which manages the interaction between an
          * agent and an environment.
-         * \return action action selected by the agent.
+         * \param action_ output action selected by the agent.
          */
-        virtual arma::vec getAction();
+        virtual void getAction(arma::vec &action_);
 
         /*!
          * Receive reward R_{t+1} from the system. This reward will be typically
@@ -93,6 +128,25 @@ class NPGPEAgent : public Agent
          */
         virtual void receiveReward(double reward_) { reward = reward_; }
 
+        //! Get number of parameter samples evaluated at each step
+        virtual size_t getPopulationSize() const { return population.size(); }
+
+        /*!
+         * Get the actions selected by the parameter samples of the current
+         * step. The first one is the action returned by getAction.
+         * \param actions_ output actions, one per column, resized if needed.
+         */
+        virtual void getPopulationActions(arma::mat &actions_) const
+            { population.getActions(actions_); }
+
+        /*!
+         * Receive the rewards of the actions selected by the parameter
+         * samples of the current step.
+         * \param rewards_ rewards of the candidate actions.
+         */
+        virtual void receivePopulationRewards(arma::vec const &rewards_)
+            { population.receiveRewards(rewards_); }
+
         /*!
          * Receive observation O_{t+1} of the system state after the transition
          * induced by the action selected by the agent. NPGPE does not use this
@@ -121,37 +175,70 @@ class NPGPEAgent : public Agent
          */
         virtual void reset();
 
+        /*!
+         * Seed the random number generators used by the agent.
+         * \param seed_ seed of the random number generators.
+         */
+        virtual void seed(unsigned int seed_);
+
+        /*!
+         * Write the hyperparameters, the baseline, the eligibility traces, the
+         * learning rates and the generator states to a snapshot.
+         * \param writer_ snapshot writer
+         */
+        virtual void saveState(CheckpointWriter &writer_) const;
+
+        /*!
+         * Read the learning state from a snapshot written by saveState.
+         * \param reader_ snapshot reader
+         */
+        virtual void loadState(CheckpointReader &reader_);
+
     private:
 
         /*!
-         * Initialize the NPGPE agent parameters, i.e. the mean and the cholesky
-         * factor of the covariance matrix of the Gaussian parameter
-         * distribution.
+         * Initialize the NPGPE agent parameters, i.e. the mean and the factor
+         * of the covariance matrix of the Gaussian parameter distribution.
          */
         void initializeParameters();
 
+        /*!
+         * Sample the whole population of controller parameters, evaluate it on
+         * the current observation and return the action of the first sample.
+         * \param action_ output action.
+         */
+        void getPopulationAction(arma::vec &action_);
+
+        /*!
+         * Learning step in population mode. The current step contributes the
+         * average of the likelihood-weighted rewards of the population, while
+         * the eligibility trace follows the performed samples.
+         */
+        void learnPopulation();
+
         /*!
          * Deterministic controller.
          * A deterministic mapping from a state observation to an action.
          */
-        std::unique_ptr<Policy> policyPtr;
+        std::unique_ptr<PolicyT> policyPtr;
 
         //! Random number generator.
-        mutable std::mt19937 generator;
+        mutable Philox4x32 generator;
 
         /*!
-         * Parameter distribution. The controller parameters are sampled from a
-         * multi-variate Gaussian distribution, parametrized by the mean and the
-         * Cholesky factor of the covariance matrix.
+         * Structure of the covariance matrix of the parameter distribution. The
+         * controller parameters are sampled from a multi-variate Gaussian
+         * distribution, parametrized by the mean and a factor of the covariance
+         * matrix, whose structure is given by the covariance object.
          */
-        mutable std::normal_distribution<double> gaussianDistr;
+        std::unique_ptr<ParameterCovariance> covariancePtr;
 
         // Cache variable for the parameter simulation used in the learning.
-        arma::vec xi;
+        RealVec xi;
 
         //! Parameter distribution hyperparameters
-        arma::vec mean;
-        arma::mat choleskyFactor;  // Sigma = choleskyFactor * choleskyFactor'
+        RealVec mean;
+        RealVec covarianceFactor;
 
         /*!
          * Average reward baseline. It simply consists of a moving average of
@@ -170,13 +257,27 @@ class NPGPEAgent : public Agent
         double lambda;
 
         //! Gradient cache
-        arma::vec gradientMean;
-        arma::mat gradientChol;
+        RealVec gradientMean;
+        RealVec gradientFactor;
+
+        //! Cache variables for the controller parameters and likelihood score
+        RealVec policyParameters;
+        RealVec likelihoodMean;
+        RealVec likelihoodFactor;
+
+        //! Parameter samples evaluated at each step
+        NPGPEPopulation population;
 
         //! Cache variables
-        arma::vec observation;
-        arma::vec action;
+        RealVec observation;
+        RealVec action;
         double reward;
 };
 
+//! NPGPE agent on any deterministic controller
+typedef BasicNPGPEAgent<Policy> NPGPEAgent;
+
+//! NPGPE agent on a binary controller
+typedef BasicNPGPEAgent<BinaryPolicy> BinaryNPGPEAgent;
+
 #endif // NPGPEAGENT_H
@@ -24,6 +24,8 @@
 #define NPGPEPOLICY_H
 
 #include <thesis/StochasticPolicy.h>
+#include <thesis/ParameterCovariance.h>
+#include <thesis/Philox.h>
 #include <armadillo>  /* arma::vec */
 #include <memory>     /* std::unique_ptr */
 
@@ -40,13 +42,27 @@ class NPGPEPolicy : public StochasticPolicy
     public:
         /*!
          * Constructor.
-         * Initialize a NPGPEPolicy object given a deterministic controller.
+         * Initialize a NPGPEPolicy object given a deterministic controller,
+         * with a full covariance matrix with a triangular Cholesky factor.
          * \param policy_ deterministic controller
          * \param resamplingProbability_ probability of sampling new controller parameters
          */
         NPGPEPolicy(Policy const &policy_,
                     double resamplingProbability_=0.01);
 
+        /*!
+         * Constructor.
+         * Initialize a NPGPEPolicy object given a deterministic controller and
+         * the structure of the covariance of the parameter distribution. The
+         * policy parameters are the mean followed by the covariance factor.
+         * \param policy_ deterministic controller
+         * \param covariance_ covariance structure
+         * \param resamplingProbability_ probability of sampling new controller parameters
+         */
+        NPGPEPolicy(Policy const &policy_,
+                    ParameterCovariance const &covariance_,
+                    double resamplingProbability_=0.01);
+
         /*!
          * Copy constructor for correct instantiation of polymorphic objects.
          */
@@ -61,42 +77,81 @@ class NPGPEPolicy : public StochasticPolicy
          */
         virtual size_t getDimParameters() const { return dimHyperParameters; }
 
+        using StochasticPolicy::getParameters;
+        using StochasticPolicy::getAction;
+        using StochasticPolicy::likelihoodScore;
+
         /*!
          * Get method for the policy parameters.
-         * \return parameters stored in an arma::vector
+         * \param parameters_ output parameters, resized if needed
          */
-        virtual arma::vec getParameters() const
-            { return parameters; }
+        virtual void getParameters(RealVec &parameters_) const
+            { parameters_ = parameters; }
 
         /*!
          * Set method for the policy parameters.
          * \param parameters_ the new parameters stored in an arma::vector
          */
-        virtual void setParameters(arma::vec const &parameters_)
+        virtual void setParameters(RealVec const &parameters_)
             { parameters = parameters_; }
 
         /*!
          * Given an observation, select an action accordind to the policy.
          * \param observation_ observation
-         * \return action
+         * \param action_ output action, resized if needed
          */
-        virtual arma::vec getAction(arma::vec const &observation_) const;
+        virtual void getAction(RealVec const &observation_,
+                               RealVec &action_) const;
 
         /*!
          * Evaluate the Likelihood score function at a given observation and
          * action.
          * \param observation_ observation
          * \param action_ action
-         * \return likelihood score evaluated at observation_ and action_
+         * \param likScore_ output likelihood score evaluated at observation_
+         *        and action_, resized if needed
          */
-        virtual arma::vec likelihoodScore(arma::vec const &observation_,
-                                          arma::vec const &action_) const;
+        virtual void likelihoodScore(RealVec const &observation_,
+                                     RealVec const &action_,
+                                     RealVec &likScore_) const;
+
+        /*!
+         * The likelihood score depends on the controller parameters sampled
+         * by this copy of the policy, hence the actions selected by another
+         * copy cannot be scored.
+         * \throw std::logic_error
+         */
+        virtual void behaviourLikelihoodScore(RealVec const &observation_,
+                                              RealVec const &action_,
+                                              RealVec &likScore_) const;
+
+        //! The actions selected by another copy cannot be scored.
+        virtual bool supportsBehaviourScore() const { return false; }
 
         /*!
          * Reset policy to initial conditions.
          */
         virtual void reset();
 
+        /*!
+         * Seed the random number generator used by the policy.
+         * \param seed_ seed of the random number generator
+         */
+        virtual void seed(unsigned int seed_);
+
+        /*!
+         * Write the hyperparameters, the last parameter noise, the generator
+         * state and the current controller to a snapshot.
+         * \param writer_ snapshot writer
+         */
+        virtual void saveState(CheckpointWriter &writer_) const;
+
+        /*!
+         * Read the policy state from a snapshot written by saveState.
+         * \param reader_ snapshot reader
+         */
+        virtual void loadState(CheckpointReader &reader_);
+
     private:
         //! Initialize parameters
         void initializeParameters();
@@ -107,8 +162,8 @@ class NPGPEPolicy : public StochasticPolicy
         //! Deterministic controller
         std::unique_ptr<Policy> policyPtr;
 
-        //! Controller parameters distributions
-        mutable std::normal_distribution<double> gaussianDistr;
+        //! Structure of the covariance matrix of the parameter distribution
+        std::unique_ptr<ParameterCovariance> covariancePtr;
 
         //! Policy parameters size
         size_t dimParameters;
@@ -117,18 +172,21 @@ class NPGPEPolicy : public StochasticPolicy
         size_t dimHyperParameters;
 
         //! Parameters distribution parameters
-        arma::vec parameters;  // Shares memory with mean and cholFactor
-        arma::vec mean;
-        arma::mat cholFactor;
+        RealVec parameters;  // Shares memory with mean and covarianceFactor
+        RealVec mean;
+        RealVec covarianceFactor;
 
         //! Mutable cache variable for random policy parameters
-        mutable arma::vec xi;
+        mutable RealVec xi;
+
+        //! Mutable cache variable for controller parameters
+        mutable RealVec controllerParameters;
 
         //! Resampling probability
         double resamplingProbability;
 
         //! Random number generator
-        mutable std::mt19937 generator;
+        mutable Philox4x32 generator;
         mutable std::uniform_real_distribution<double> randDistr;
 };
 
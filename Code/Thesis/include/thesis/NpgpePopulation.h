@@ -0,0 +1,155 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef NPGPEPOPULATION_H
+#define NPGPEPOPULATION_H
+
+#include <thesis/Precision.h>  /* RealVec, RealMat */
+#include <thesis/ParameterCovariance.h>
+#include <thesis/Philox.h>
+#include <armadillo>
+#include <cstddef>
+
+/*!
+ * NPGPEPopulation holds the population of controller parameters sampled at
+ * each step by the NPGPE agents in population mode, together with the actions
+ * and the rewards of the samples. It implements the part of the population
+ * step shared by the agents: the sampling, the batched evaluation of the
+ * controller and the average of the weighted likelihood scores. The agents
+ * only differ in the weight given to the reward of a sample.
+ */
+
+class NPGPEPopulation
+{
+    public:
+
+        /*!
+         * Constructor.
+         * \param size_ number of parameter samples.
+         * \param covariance_ covariance structure of the parameter distribution.
+         * \param dimAction_ action size of the controller.
+         * \throw std::invalid_argument if the population is empty.
+         */
+        NPGPEPopulation(size_t size_,
+                        ParameterCovariance const &covariance_,
+                        size_t dimAction_);
+
+        //! Get number of parameter samples
+        size_t size() const { return populationSize; }
+
+        /*!
+         * Sample the controller parameters: w_j = mean + perturbation(F, xi_j).
+         * \param generator_ random number generator.
+         * \param covariance_ covariance structure of the parameter distribution.
+         * \param factor_ covariance factor F.
+         * \param mean_ mean of the parameter distribution.
+         */
+        void sample(Philox4x32 &generator_,
+                    ParameterCovariance const &covariance_,
+                    RealVec const &factor_,
+                    RealVec const &mean_);
+
+        /*!
+         * Evaluate the whole population at once on an observation.
+         * \param policy_ deterministic controller supporting batched evaluation.
+         * \param observation_ current observation.
+         * \param action_ output action of the first sample, i.e. the performed one.
+         */
+        template<class PolicyT>
+        void evaluate(PolicyT &policy_, RealVec const &observation_, arma::vec &action_)
+        {
+            policy_.getActions(observation_, parameters, actions);
+            RealVec const firstAction(actions.colptr(0), actions.n_rows, false, true);
+            convertTo(firstAction, action_);
+        }
+
+        /*!
+         * Get the actions selected by the samples of the current step.
+         * \param actions_ output actions, one per column, resized if needed.
+         */
+        void getActions(arma::mat &actions_) const { convertTo(actions, actions_); }
+
+        /*!
+         * Receive the rewards of the actions selected by the samples.
+         * \param rewards_ rewards of the candidate actions.
+         */
+        void receiveRewards(arma::vec const &rewards_) { rewards = rewards_; }
+
+        //! Get the rewards of the samples of the current step
+        arma::vec const &getRewards() const { return rewards; }
+
+        /*!
+         * Average the weighted likelihood scores of the population. Samples
+         * are visited backwards, so that the likelihood caches are left with
+         * the score of the performed sample.
+         * \param covariance_ covariance structure of the parameter distribution.
+         * \param factor_ covariance factor F.
+         * \param mean_ mean of the parameter distribution.
+         * \param weight_ weight of the score of a sample given its reward.
+         * \param likelihoodMean_ output score of the performed sample w.r.t. the mean.
+         * \param likelihoodFactor_ output score of the performed sample w.r.t. F.
+         */
+        template<class WeightT>
+        void averageScores(ParameterCovariance const &covariance_,
+                           RealVec const &factor_,
+                           RealVec const &mean_,
+                           WeightT const &weight_,
+                           RealVec &likelihoodMean_,
+                           RealVec &likelihoodFactor_)
+        {
+            gradientMean.zeros();
+            gradientFactor.zeros();
+            for (size_t j = populationSize; j-- > 0; )
+            {
+                RealVec sampleNoise(noise.colptr(j), noise.n_rows, false, true);
+                likelihoodMean_ = parameters.col(j);
+                likelihoodMean_ -= mean_;
+                covariance_.factorScore(factor_, sampleNoise, likelihoodMean_, likelihoodFactor_);
+                double const weight = weight_(rewards(j)) / populationSize;
+                gradientMean += weight * likelihoodMean_;
+                gradientFactor += weight * likelihoodFactor_;
+            }
+        }
+
+        //! Get the average score w.r.t. the mean computed by averageScores
+        RealVec const &getGradientMean() const { return gradientMean; }
+
+        //! Get the average score w.r.t. the factor computed by averageScores
+        RealVec const &getGradientFactor() const { return gradientFactor; }
+
+    private:
+
+        //! Number of parameter samples
+        size_t populationSize;
+
+        //! Population caches, one sample per column
+        RealMat noise;
+        RealMat parameters;
+        RealMat actions;
+        arma::vec rewards;
+
+        //! Average scores of the population
+        RealVec gradientMean;
+        RealVec gradientFactor;
+};
+
+#endif // NPGPEPOPULATION_H
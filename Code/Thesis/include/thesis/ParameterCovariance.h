@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PARAMETERCOVARIANCE_H
+#define PARAMETERCOVARIANCE_H
+
+#include <thesis/Precision.h>  /* RealVec, RealMat */
+#include <armadillo>  /* arma::vec */
+#include <memory>     /* unique_ptr */
+#include <string>
+
+/**
+ * ParameterCovariance is an abstract class which implements a generic interface
+ * for the structure of the covariance matrix of the Gaussian distribution used
+ * by the NPGPE algorithms to explore the controller parameter space. The
+ * distribution is parametrized by its mean and by a factor F of the covariance,
+ * stored as a flat vector. A parameter sample is obtained as
+ *
+ *     w = mean + perturbation(F, zeta),    zeta ~ N(0, I)
+ *
+ * where the perturbation is linear in zeta, and the structure defines the
+ * natural gradient of the log-likelihood with respect to F, computed in the
+ * local coordinates of the factor. The classes
+ * carry no state besides the dimensions, so that a single instance can be
+ * shared by the agents and the policies which own the factor.
+ */
+
+class ParameterCovariance
+{
+    public:
+        /**
+         * Constructor.
+         * \param dimParameters_ number of controller parameters.
+         */
+        ParameterCovariance(size_t dimParameters_)
+            : dimParameters(dimParameters_) {}
+
+        //! Destructor.
+        virtual ~ParameterCovariance() = default;
+
+        /**
+         * Clone method.
+         * the class is clonable to allow for polymorphic copy.
+         * \return unique_ptr pointing to new ParameterCovariance instance.
+         */
+        virtual std::unique_ptr<ParameterCovariance> clone() const = 0;
+
+        //! Number of controller parameters
+        size_t getDimParameters() const { return dimParameters; }
+
+        //! Size of the covariance factor F
+        virtual size_t getDimFactor() const = 0;
+
+        //! Size of the standard Gaussian noise zeta
+        virtual size_t getDimNoise() const { return dimParameters; }
+
+        /**
+         * Initialize the factor so that the covariance is scale_^2 * I.
+         * \param scale_ standard deviation of each controller parameter.
+         * \param factor_ output factor, resized if needed.
+         */
+        virtual void initializeFactor(double scale_, RealVec &factor_) const = 0;
+
+        /**
+         * Compute the perturbation of the controller parameters.
+         * \param factor_ covariance factor.
+         * \param noise_ standard Gaussian noise zeta.
+         * \param perturbation_ output perturbation, resized if needed.
+         */
+        virtual void perturbation(RealVec const &factor_,
+                                  RealVec const &noise_,
+                                  RealVec &perturbation_) const = 0;
+
+        /**
+         * Compute the natural likelihood score with respect to the factor.
+         * \param factor_ covariance factor.
+         * \param noise_ standard Gaussian noise zeta used for the sample.
+         * \param perturbation_ perturbation of the sample.
+         * \param factorScore_ output score, with the same layout as the factor.
+         *        It must already have size getDimFactor(), so that it can be a
+         *        view on a larger vector.
+         */
+        virtual void factorScore(RealVec const &factor_,
+                                 RealVec const &noise_,
+                                 RealVec const &perturbation_,
+                                 RealVec &factorScore_) const = 0;
+
+    protected:
+        //! Number of controller parameters
+        size_t dimParameters;
+};
+
+/**
+ * FullCovariance implements a full covariance matrix with a general d x d factor
+ * C stored column by column, which is the original NPGPE agents' scheme: the
+ * sample is w = mean + C * xi and the likelihood score is M * C', with
+ * M = triu(xi*xi') - (diag(xi*xi') + I) / 2. The factor starts diagonal but
+ * fills in from the second update. Memory is O(d^2) and each sample or score
+ * costs O(d^2).
+ */
+
+class FullCovariance : public ParameterCovariance
+{
+    public:
+        //! Constructor.
+        FullCovariance(size_t dimParameters_)
+            : ParameterCovariance(dimParameters_) {}
+
+        virtual std::unique_ptr<ParameterCovariance> clone() const;
+
+        virtual size_t getDimFactor() const
+            { return dimParameters * dimParameters; }
+
+        virtual void initializeFactor(double scale_, RealVec &factor_) const;
+
+        virtual void perturbation(RealVec const &factor_,
+                                  RealVec const &noise_,
+                                  RealVec &perturbation_) const;
+
+        virtual void factorScore(RealVec const &factor_,
+                                 RealVec const &noise_,
+                                 RealVec const &perturbation_,
+                                 RealVec &factorScore_) const;
+};
+
+/**
+ * TriangularCovariance implements a full covariance matrix Sigma = F' * F, where
+ * F is an upper triangular Cholesky factor stored column by column, which is the
+ * NPGPEPolicy convention. The sample is w = mean + F' * xi and the natural
+ * likelihood score is M * F, which is upper triangular as well, so that F stays
+ * triangular and half of each sample or score is skipped. Memory is O(d^2).
+ */
+
+class TriangularCovariance : public ParameterCovariance
+{
+    public:
+        //! Constructor.
+        TriangularCovariance(size_t dimParameters_)
+            : ParameterCovariance(dimParameters_) {}
+
+        virtual std::unique_ptr<ParameterCovariance> clone() const;
+
+        virtual size_t getDimFactor() const
+            { return dimParameters * dimParameters; }
+
+        virtual void initializeFactor(double scale_, RealVec &factor_) const;
+
+        virtual void perturbation(RealVec const &factor_,
+                                  RealVec const &noise_,
+                                  RealVec &perturbation_) const;
+
+        virtual void factorScore(RealVec const &factor_,
+                                 RealVec const &noise_,
+                                 RealVec const &perturbation_,
+                                 RealVec &factorScore_) const;
+};
+
+/**
+ * DiagonalCovariance implements a diagonal covariance matrix Sigma = diag(f)^2,
+ * i.e. independent exploration of each controller parameter. The natural
+ * likelihood score is f_i * (xi_i^2 - 1) / 2. Memory and time are O(d).
+ */
+
+class DiagonalCovariance : public ParameterCovariance
+{
+    public:
+        //! Constructor.
+        DiagonalCovariance(size_t dimParameters_)
+            : ParameterCovariance(dimParameters_) {}
+
+        virtual std::unique_ptr<ParameterCovariance> clone() const;
+
+        virtual size_t getDimFactor() const { return dimParameters; }
+
+        virtual void initializeFactor(double scale_, RealVec &factor_) const;
+
+        virtual void perturbation(RealVec const &factor_,
+                                  RealVec const &noise_,
+                                  RealVec &perturbation_) const;
+
+        virtual void factorScore(RealVec const &factor_,
+                                 RealVec const &noise_,
+                                 RealVec const &perturbation_,
+                                 RealVec &factorScore_) const;
+};
+
+/**
+ * LowRankCovariance implements a low-rank-plus-diagonal covariance matrix
+ * Sigma = diag(f)^2 + U * U', with U a d x k matrix. The factor stores f
+ * followed by U column by column, and the noise stores xi (d) followed by
+ * eta (k), so that w = mean + f .* xi + U * eta. With delta = w - mean, the
+ * natural likelihood score is (delta .* xi - f) / 2 for f and
+ * (delta * eta' - U) / 2 for U, i.e. the local-coordinate natural gradient
+ * projected onto the structure. Memory and time are O(d * k).
+ */
+
+class LowRankCovariance : public ParameterCovariance
+{
+    public:
+        /**
+         * Constructor.
+         * \param dimParameters_ number of controller parameters.
+         * \param rank_ rank k of the low-rank term.
+         */
+        LowRankCovariance(size_t dimParameters_, size_t rank_)
+            : ParameterCovariance(dimParameters_), rank(rank_) {}
+
+        virtual std::unique_ptr<ParameterCovariance> clone() const;
+
+        virtual size_t getDimFactor() const
+            { return dimParameters * (rank + 1); }
+
+        virtual size_t getDimNoise() const { return dimParameters + rank; }
+
+        /**
+         * Initialize f to scale_ and U to zero, so that the low-rank term
+         * starts flat and grows along the directions favoured by the gradient.
+         */
+        virtual void initializeFactor(double scale_, RealVec &factor_) const;
+
+        virtual void perturbation(RealVec const &factor_,
+                                  RealVec const &noise_,
+                                  RealVec &perturbation_) const;
+
+        virtual void factorScore(RealVec const &factor_,
+                                 RealVec const &noise_,
+                                 RealVec const &perturbation_,
+                                 RealVec &factorScore_) const;
+
+    private:
+        size_t rank;
+};
+
+/**
+ * BlockDiagonalCovariance implements a block-diagonal covariance matrix, i.e.
+ * independent groups of consecutive controller parameters, e.g. the weights
+ * associated with one asset. Each block has a TriangularCovariance structure; the
+ * factor stores the upper triangular blocks one after the other, the last
+ * block being smaller if blockSize does not divide d. Memory and time are
+ * O(d * blockSize).
+ */
+
+class BlockDiagonalCovariance : public ParameterCovariance
+{
+    public:
+        /**
+         * Constructor.
+         * \param dimParameters_ number of controller parameters.
+         * \param blockSize_ size of the diagonal blocks.
+         */
+        BlockDiagonalCovariance(size_t dimParameters_, size_t blockSize_);
+
+        virtual std::unique_ptr<ParameterCovariance> clone() const;
+
+        virtual size_t getDimFactor() const { return dimFactor; }
+
+        virtual void initializeFactor(double scale_, RealVec &factor_) const;
+
+        virtual void perturbation(RealVec const &factor_,
+                                  RealVec const &noise_,
+                                  RealVec &perturbation_) const;
+
+        virtual void factorScore(RealVec const &factor_,
+                                 RealVec const &noise_,
+                                 RealVec const &perturbation_,
+                                 RealVec &factorScore_) const;
+
+    private:
+        size_t blockSize;
+        size_t dimFactor;
+};
+
+/**
+ * Create a covariance structure from its name, as read from a parameter file.
+ * \param type_ one of "full", "triangular", "diagonal", "lowrank" and "block".
+ * \param dimParameters_ number of controller parameters.
+ * \param rank_ rank of the "lowrank" structure.
+ * \param blockSize_ block size of the "block" structure.
+ * \return unique_ptr pointing to the new ParameterCovariance instance.
+ */
+std::unique_ptr<ParameterCovariance> makeParameterCovariance(std::string const &type_,
+                                                             size_t dimParameters_,
+                                                             size_t rank_=1,
+                                                             size_t blockSize_=1);
+
+#endif // PARAMETERCOVARIANCE_H
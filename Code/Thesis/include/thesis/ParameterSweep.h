@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PARAMETERSWEEP_H
+#define PARAMETERSWEEP_H
+
+#include <thesis/ExperimentParameters.h>
+#include <thesis/MarketData.h>
+#include <thesis/WorkStealingPool.h>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * ParameterSweep runs the asset allocation experiments of a grid of parameter
+ * values and learning algorithms in a single process. The grid is read from a
+ * file with one axis per line,
+ *
+ *     algorithm = ARAC PGPE NPGPE
+ *     deltaP = 0.0 0.001 0.002
+ *     # comment
+ *
+ * where the algorithm axis lists the agents identifiers and every other axis
+ * the values of an ExperimentParameters field, which override the base
+ * parameters. A job is run for each combination of values.
+ *
+ * Jobs are written in the layout of the experiment launcher, i.e. to
+ * outputBaseDir/experimentCode/algorithm/ and debugBaseDir/experimentCode/algorithm/,
+ * where the experiment code describes the market, the risk attitude of the
+ * algorithm (RS_ or RN_), the transaction costs, the number of days observed
+ * and the other swept parameters.
+ *
+ * The historical return series is loaded once and shared by all the jobs.
+ * Jobs and their independent experiments run as nested loops on the same
+ * work-stealing pool, so that the whole grid is balanced across the workers.
+ */
+
+class ParameterSweep
+{
+    public:
+        /*!
+         * Constructor.
+         * \param baseParams_ parameters shared by all the jobs.
+         * \param gridFile_ path of the file describing the grid.
+         * \param inputFile_ path of the historical return series.
+         * \param outputBaseDir_ base directory of the output files.
+         * \param debugBaseDir_ base directory of the debug files.
+         */
+        ParameterSweep(ExperimentParameters const &baseParams_,
+                       std::string const &gridFile_,
+                       std::string const &inputFile_,
+                       std::string const &outputBaseDir_,
+                       std::string const &debugBaseDir_);
+
+        //! Default destructor.
+        virtual ~ParameterSweep() = default;
+
+        //! Get number of jobs in the grid.
+        size_t getNumJobs() const { return jobs.size(); }
+
+        /*!
+         * Run all the jobs of the grid.
+         * \param pool_ pool executing the jobs and their experiments.
+         */
+        void run(WorkStealingPool &pool_) const;
+
+    private:
+        //! Parameters, algorithm and swept values of a job
+        struct Job
+        {
+            ExperimentParameters params;
+            std::string algorithm;
+            std::vector<std::pair<std::string, std::string>> sweptValues;
+        };
+
+        //! Read the grid file and build the cartesian product of its axes.
+        void readGrid(std::string const &gridFile_);
+
+        //! Run a single job.
+        void runJob(Job const &job_, WorkStealingPool &pool_) const;
+
+        //! Experiment code of a job, as built by the experiment launcher.
+        std::string experimentCode(Job const &job_, size_t numRiskyAssets_) const;
+
+        //! Check whether an algorithm is risk-sensitive (RS_) or not (RN_).
+        static bool isRiskSensitive(std::string const &algorithm_);
+
+        //! Base parameters
+        ExperimentParameters baseParams;
+
+        //! Jobs of the grid
+        std::vector<Job> jobs;
+
+        //! Input file and output base directories
+        std::string inputFile;
+        std::string outputBaseDir;
+        std::string debugBaseDir;
+
+        //! Historical return series, shared by the jobs
+        std::shared_ptr<MarketData const> historicalDataPtr;
+};
+
+#endif // PARAMETERSWEEP_H
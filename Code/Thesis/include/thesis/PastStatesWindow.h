@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PASTSTATESWINDOW_H
+#define PASTSTATESWINDOW_H
+
+#include <armadillo>
+
+/**
+ * PastStatesWindow keeps the market states observed in the last
+ * numDaysObserved days by one or more trajectories moving in lockstep, and
+ * assembles the observations received by the agents. It is shared by
+ * AssetAllocationTask, which is the single trajectory case, and by
+ * BatchAssetAllocationTask.
+ *
+ * The states of each trajectory are stored in a column of a circular buffer
+ * in which every state is stored twice, at slot i and i + numDaysObserved, so
+ * that the window starting at the oldest state is always contiguous and a new
+ * state is pushed without shifting the older ones.
+ */
+
+class PastStatesWindow
+{
+    public:
+        /**
+         * Constructor.
+         * \param dimState_ state space size of a trajectory.
+         * \param numDaysObserved_ number of past days observed.
+         * \param numTrajectories_ number of trajectories.
+         */
+        PastStatesWindow(size_t dimState_,
+                         size_t numDaysObserved_,
+                         size_t numTrajectories_ = 1);
+
+        //! Get past states size of a trajectory.
+        size_t getDimPastStates() const { return dimPastStates; }
+
+        /**
+         * Observation space size of a trajectory, given the size of the
+         * allocation.
+         * \param dimAllocation_ number of allocation weights.
+         */
+        size_t getDimObservation(size_t dimAllocation_) const
+            { return 1 + dimPastStates + dimState + dimAllocation_; }
+
+        //! Empty the window, before pushing numDaysObserved new states.
+        void clear() { head = 0; }
+
+        /**
+         * Push the states of the trajectories in the window, discarding the
+         * oldest ones. The cost is O(dimState) per trajectory, independently
+         * of numDaysObserved.
+         * \param states_ market states, one per column.
+         */
+        void push(arma::mat const &states_);
+
+        /**
+         * Assemble the observations of the trajectories, i.e. the risk-free
+         * rate, the past states from the oldest to the most recent one, the
+         * current states and the current allocations.
+         * \param riskFreeRate_ risk-free rate.
+         * \param states_ current market states, one per column.
+         * \param allocations_ current allocations, one per column.
+         * \param observations_ output observations, one per column, resized
+         *        if needed.
+         */
+        void getObservations(double riskFreeRate_,
+                             arma::mat const &states_,
+                             arma::mat const &allocations_,
+                             arma::mat &observations_) const;
+
+    private:
+        //! State space size of a trajectory.
+        size_t dimState;
+
+        //! Number of past days observed.
+        size_t numDaysObserved;
+
+        //! Past states size of a trajectory.
+        size_t dimPastStates;
+
+        //! Circular buffers of the past states, one per column.
+        arma::mat pastStates;
+
+        //! Slot of the oldest state in the circular buffers.
+        size_t head;
+};
+
+#endif /* end of include guard: PASTSTATESWINDOW_H */
@@ -26,6 +26,7 @@
 #include <thesis/StochasticPolicy.h>
 #include <thesis/Policy.h>
 #include <thesis/ProbabilityDistribution.h>
+#include <thesis/Philox.h>
 #include <memory>
 #include <random>
 
@@ -36,7 +37,7 @@
  * Parameter-exloring policy gradients (2010)".
  */
 
-class PGPEPolicy : public StochasticPolicy
+class PGPEPolicy final : public StochasticPolicy
 {
     public:
         /*!
@@ -66,42 +67,81 @@ class PGPEPolicy : public StochasticPolicy
         virtual size_t getDimParameters() const
             { return distributionPtr->getDimParameters(); }
 
+        using StochasticPolicy::getParameters;
+        using StochasticPolicy::getAction;
+        using StochasticPolicy::likelihoodScore;
+
         /*!
          * Get method for the policy parameters.
-         * \return parameters stored in an arma::vector
+         * \param parameters_ output parameters, resized if needed
          */
-        virtual arma::vec getParameters() const
-            { return distributionPtr->getParameters(); }
+        virtual void getParameters(RealVec &parameters_) const
+            { distributionPtr->getParameters(parameters_); }
 
         /*!
          * Set method for the policy parameters.
          * \param parameters_ the new parameters stored in an arma::vector
          */
-        virtual void setParameters(arma::vec const &parameters_)
+        virtual void setParameters(RealVec const &parameters_)
             { distributionPtr->setParameters(parameters_); }
 
         /*!
          * Given an observation, select an action accordind to the policy.
          * \param observation_ observation
-         * \return action
+         * \param action_ output action, resized if needed
          */
-        virtual arma::vec getAction(arma::vec const &observation_) const;
+        virtual void getAction(RealVec const &observation_,
+                               RealVec &action_) const;
 
         /*!
          * Evaluate the Likelihood score function at a given observation and
          * action.
          * \param observation_ observation
          * \param action_ action
-         * \return likelihood score evaluated at observation_ and action_
+         * \param likScore_ output likelihood score evaluated at observation_
+         *        and action_, resized if needed
+         */
+        virtual void likelihoodScore(RealVec const &observation_,
+                                     RealVec const &action_,
+                                     RealVec &likScore_) const;
+
+        /*!
+         * The likelihood score depends on the controller parameters sampled
+         * by this copy of the policy, hence the actions selected by another
+         * copy cannot be scored.
+         * \throw std::logic_error
          */
-        virtual arma::vec likelihoodScore(arma::vec const &observation_,
-                                          arma::vec const &action_) const;
+        virtual void behaviourLikelihoodScore(RealVec const &observation_,
+                                              RealVec const &action_,
+                                              RealVec &likScore_) const;
+
+        //! The actions selected by another copy cannot be scored.
+        virtual bool supportsBehaviourScore() const { return false; }
 
         /*!
          * Reset policy to initial conditions.
          */
         virtual void reset();
 
+        /*!
+         * Seed the random number generators used by the policy.
+         * \param seed_ seed of the random number generators
+         */
+        virtual void seed(unsigned int seed_);
+
+        /*!
+         * Write the generator state, the current controller and the parameter
+         * distribution to a snapshot.
+         * \param writer_ snapshot writer
+         */
+        virtual void saveState(CheckpointWriter &writer_) const;
+
+        /*!
+         * Read the policy state from a snapshot written by saveState.
+         * \param reader_ snapshot reader
+         */
+        virtual void loadState(CheckpointReader &reader_);
+
     private:
         //! Virtual inner clone method
         virtual std::unique_ptr<Policy> cloneImpl() const;
@@ -116,8 +156,11 @@ class PGPEPolicy : public StochasticPolicy
         double resamplingProbability;
 
         //! Random number generator
-        mutable std::mt19937 generator;
+        mutable Philox4x32 generator;
         mutable std::uniform_real_distribution<double> randDistr;
+
+        //! Cache vector for the controller parameters
+        mutable RealVec controllerParameters;
 };
 
 #endif // PGPEPOLICY_H
@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PHASETIMER_H
+#define PHASETIMER_H
+
+#include <array>
+#include <chrono>
+#include <ostream>
+#include <string>
+
+/**
+ * PhaseProfile accumulates the wall-clock time spent in, and the number of
+ * calls to, each phase of the agent-task interaction loop. It is filled by
+ * ScopedPhaseTimer objects, which are declared through the THESIS_TIME_PHASE
+ * macro so that they are compiled out unless THESIS_PROFILING is defined.
+ */
+
+class PhaseProfile
+{
+    public:
+        //! Phases of the experiment loop.
+        enum Phase
+        {
+            Observation,    //!< observation build and delivery to the agent
+            Action,         //!< action selection by the agent
+            Reward,         //!< task evolution, transaction costs and rewards
+            Learn,          //!< learning step of the agent
+            Stats,          //!< convergence statistics
+            Logging,        //!< backtest log, debug file and console output
+            Checkpoint,     //!< snapshots of the learning process
+            NumPhases
+        };
+
+        //! Clock used to time the phases.
+        typedef std::chrono::steady_clock Clock;
+
+        //! Constructor.
+        PhaseProfile() { reset(); }
+
+        /*!
+         * Record a call to a phase.
+         * \param phase_ phase of the loop.
+         * \param elapsed_ time spent in the call.
+         */
+        void add(Phase phase_, Clock::duration elapsed_)
+        {
+            elapsed[phase_] += elapsed_;
+            ++calls[phase_];
+        }
+
+        //! Add the time and calls recorded by another profile.
+        void merge(PhaseProfile const &other_);
+
+        //! Reset times and calls to zero.
+        void reset();
+
+        //! Comma-separated column names, time in seconds and calls per phase.
+        static std::string header();
+
+        //! Write time in seconds and calls per phase, comma-separated.
+        void write(std::ostream &os) const;
+
+    private:
+        std::array<Clock::duration, NumPhases> elapsed;
+        std::array<size_t, NumPhases> calls;
+};
+
+/**
+ * ScopedPhaseTimer adds the lifetime of the object to a phase of a profile.
+ */
+
+class ScopedPhaseTimer
+{
+    public:
+        /*!
+         * Constructor. Start timing.
+         * \param profile_ profile to update.
+         * \param phase_ phase being timed.
+         */
+        ScopedPhaseTimer(PhaseProfile &profile_, PhaseProfile::Phase phase_)
+            : profile(profile_), phase(phase_), start(PhaseProfile::Clock::now())
+        {
+            /* Nothing to do */
+        }
+
+        ScopedPhaseTimer(ScopedPhaseTimer const &other_) = delete;
+        ScopedPhaseTimer &operator=(ScopedPhaseTimer const &other_) = delete;
+
+        //! Destructor. Stop timing and update the profile.
+        ~ScopedPhaseTimer()
+        {
+            profile.add(phase, PhaseProfile::Clock::now() - start);
+        }
+
+    private:
+        PhaseProfile &profile;
+        PhaseProfile::Phase phase;
+        PhaseProfile::Clock::time_point start;
+};
+
+/*!
+ * Time the rest of the enclosing scope as a phase of a profile, e.g.
+ * THESIS_TIME_PHASE(profile, Learn). Expands to nothing unless the library is
+ * built with THESIS_PROFILING defined.
+ */
+#ifdef THESIS_PROFILING
+#define THESIS_PHASE_TIMER_NAME_(line) phaseTimer##line
+#define THESIS_PHASE_TIMER_NAME(line) THESIS_PHASE_TIMER_NAME_(line)
+#define THESIS_TIME_PHASE(profile, phase) \
+    ScopedPhaseTimer THESIS_PHASE_TIMER_NAME(__LINE__)(profile, PhaseProfile::phase)
+#else
+#define THESIS_TIME_PHASE(profile, phase) ((void)0)
+#endif
+
+#endif // PHASETIMER_H
@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PHILOX_H
+#define PHILOX_H
+
+#include <cstdint>
+
+/**
+ * Identifiers of the random streams of the stochastic components. Together
+ * with the seed, they form the key of a Philox4x32 generator, so that the
+ * components of an experiment draw from independent streams.
+ */
+
+namespace RandomStream
+{
+    enum Component : uint32_t
+    {
+        Agent = 1,
+        Policy = 2,
+        Distribution = 3,
+        Environment = 4,
+        Global = 5
+    };
+}
+
+/**
+ * Philox4x32 implements the Philox-4x32-10 counter-based random number
+ * generator of Salmon et al., "Parallel random numbers: as easy as 1, 2, 3"
+ * (2011). The output is a bijection, parametrized by a 64-bit key, of a
+ * 128-bit counter, hence there is no state to advance:
+ *
+ *  - key: (seed, component), e.g. the experiment seed and the RandomStream
+ *    of the component drawing the numbers;
+ *  - counter: (position, step), where the step selects an independent
+ *    sub-stream, e.g. a time step or a block of days, and the position is the
+ *    index of the next 128-bit block within the sub-stream.
+ *
+ * Any stream and any position in a stream are reached in O(1), which makes
+ * the draws independent of the scheduling of the work across threads. The
+ * class satisfies the UniformRandomBitGenerator requirements and can be used
+ * with the distributions of the standard library.
+ */
+
+class Philox4x32
+{
+    public:
+        typedef uint32_t result_type;
+
+        /*!
+         * Constructor.
+         * \param seed_ seed, first word of the key.
+         * \param component_ component, second word of the key.
+         * \param step_ sub-stream.
+         */
+        explicit Philox4x32(uint32_t seed_=0,
+                            uint32_t component_=0,
+                            uint64_t step_=0)
+            { seed(seed_, component_, step_); }
+
+        //! Smallest generated value.
+        static constexpr result_type min() { return 0u; }
+
+        //! Largest generated value.
+        static constexpr result_type max() { return 0xFFFFFFFFu; }
+
+        /*!
+         * Set the key and move to the beginning of a sub-stream.
+         * \param seed_ seed, first word of the key.
+         * \param component_ component, second word of the key.
+         * \param step_ sub-stream.
+         */
+        void seed(uint32_t seed_, uint32_t component_=0, uint64_t step_=0)
+        {
+            key[0] = seed_;
+            key[1] = component_;
+            setStep(step_);
+        }
+
+        /*!
+         * Move to the beginning of a sub-stream in O(1).
+         * \param step_ sub-stream.
+         */
+        void setStep(uint64_t step_)
+        {
+            step = step_;
+            position = 0;
+            cachedBlock = invalidBlock;
+        }
+
+        //! Skip the next numValues values in O(1).
+        void discard(unsigned long long numValues) { position += numValues; }
+
+        //! Generate the next 32-bit value.
+        result_type operator()()
+        {
+            uint64_t const block = position >> 2;
+            if (block != cachedBlock)
+            {
+                uint32_t counter[4] = {static_cast<uint32_t>(block),
+                                       static_cast<uint32_t>(block >> 32),
+                                       static_cast<uint32_t>(step),
+                                       static_cast<uint32_t>(step >> 32)};
+                generateBlock(counter, key, output);
+                cachedBlock = block;
+            }
+            return output[position++ & 3u];
+        }
+
+        //! Get seed, first word of the key.
+        uint32_t getSeed() const { return key[0]; }
+
+        //! Get component, second word of the key.
+        uint32_t getComponent() const { return key[1]; }
+
+        //! Get current sub-stream.
+        uint64_t getStep() const { return step; }
+
+        //! Get number of values drawn from the current sub-stream.
+        uint64_t getPosition() const { return position; }
+
+        /*!
+         * Move to a position of the current sub-stream in O(1).
+         * \param position_ number of values drawn from the sub-stream.
+         */
+        void setPosition(uint64_t position_) { position = position_; }
+
+        //! Two generators are equal if they will produce the same values.
+        bool operator==(Philox4x32 const &other_) const
+        {
+            return key[0] == other_.key[0] && key[1] == other_.key[1] &&
+                   step == other_.step && position == other_.position;
+        }
+
+        bool operator!=(Philox4x32 const &other_) const { return !(*this == other_); }
+
+        /*!
+         * Philox-4x32-10 bijection.
+         * \param counter_ 128-bit counter.
+         * \param key_ 64-bit key.
+         * \param output_ 128-bit output.
+         */
+        static void generateBlock(uint32_t const counter_[4],
+                                  uint32_t const key_[2],
+                                  uint32_t output_[4])
+        {
+            uint32_t c0 = counter_[0], c1 = counter_[1], c2 = counter_[2], c3 = counter_[3];
+            uint32_t k0 = key_[0], k1 = key_[1];
+            for (unsigned int round = 0; round < 10; ++round)
+            {
+                uint64_t const product0 = static_cast<uint64_t>(multiplier0) * c0;
+                uint64_t const product1 = static_cast<uint64_t>(multiplier1) * c2;
+                uint32_t const hi0 = static_cast<uint32_t>(product0 >> 32);
+                uint32_t const lo0 = static_cast<uint32_t>(product0);
+                uint32_t const hi1 = static_cast<uint32_t>(product1 >> 32);
+                uint32_t const lo1 = static_cast<uint32_t>(product1);
+                c0 = hi1 ^ c1 ^ k0;
+                c1 = lo1;
+                c2 = hi0 ^ c3 ^ k1;
+                c3 = lo0;
+                k0 += weyl0;
+                k1 += weyl1;
+            }
+            output_[0] = c0;
+            output_[1] = c1;
+            output_[2] = c2;
+            output_[3] = c3;
+        }
+
+    private:
+        //! Round multipliers and Weyl sequence increments of the key.
+        static constexpr uint32_t multiplier0 = 0xD2511F53u;
+        static constexpr uint32_t multiplier1 = 0xCD9E8D57u;
+        static constexpr uint32_t weyl0 = 0x9E3779B9u;
+        static constexpr uint32_t weyl1 = 0xBB67AE85u;
+
+        //! Marker of an empty output cache.
+        static constexpr uint64_t invalidBlock = ~static_cast<uint64_t>(0);
+
+        //! Key: seed and component.
+        uint32_t key[2];
+
+        //! Sub-stream and position in the sub-stream.
+        uint64_t step;
+        uint64_t position;
+
+        //! Last generated block and its index in the sub-stream.
+        uint32_t output[4];
+        uint64_t cachedBlock;
+};
+
+#endif // PHILOX_H
@@ -23,9 +23,12 @@
 #ifndef POLICY_H
 #define POLICY_H
 
+#include <thesis/Checkpoint.h>  /* CheckpointWriter, CheckpointReader */
+#include <thesis/Precision.h>  /* RealVec, RealMat */
 #include <armadillo>  /* arma::vec */
 #include <memory>     /* std::unique_ptr */
 #include <assert.h>   /* assert */
+#include <stdexcept>  /* std::logic_error */
 
 /**
  * Policy is a pure abstract class that provides a generic interface for a
@@ -83,26 +86,123 @@ class Policy
          * Get method for the policy parameters.
          * \return parameters stored in an arma::vector
          */
-        virtual arma::vec getParameters() const = 0;
+        RealVec getParameters() const
+        {
+            RealVec parameters(getDimParameters());
+            getParameters(parameters);
+            return parameters;
+        }
+
+        /*!
+         * Get method for the policy parameters in a preallocated vector.
+         * \param parameters_ output parameters, resized if needed
+         */
+        virtual void getParameters(RealVec &parameters_) const = 0;
 
         /*!
          * Set method for the policy parameters.
          * \param parameters_ the new parameters stored in an arma::vector
          */
-        virtual void setParameters(arma::vec const &parameters_) = 0;
+        virtual void setParameters(RealVec const &parameters_) = 0;
 
         /*!
          * Given an observation, select an action accordind to the policy.
          * \param observation_ observation
          * \return action
          */
-        virtual arma::vec getAction(arma::vec const & observation_) const = 0;
+        RealVec getAction(RealVec const & observation_) const
+        {
+            RealVec action(dimAction);
+            getAction(observation_, action);
+            return action;
+        }
+
+        /*!
+         * Given an observation, select an action according to the policy and
+         * write it in a preallocated vector. This is the allocation-free
+         * variant used in the interaction loop.
+         * \param observation_ observation
+         * \param action_ output action, resized if needed
+         */
+        virtual void getAction(RealVec const & observation_,
+                               RealVec &action_) const = 0;
+
+        /*!
+         * Given an observation, evaluate the policy for a population of
+         * parameter vectors at once, as if each of them had been passed to
+         * setParameters before calling getAction. The parameter vectors are
+         * projected in place onto the admissible set, e.g. the parameter
+         * bounds. Only policies used as controllers of parameter-exploring
+         * agents need to implement it.
+         * \param observation_ observation
+         * \param parameters_ parameter vectors, one per column
+         * \param actions_ output actions, one per column, resized if needed
+         */
+        virtual void getActions(RealVec const & observation_,
+                                RealMat &parameters_,
+                                RealMat &actions_) const
+        {
+            throw std::logic_error("Policy does not support batched evaluation");
+        }
+
+        /*!
+         * Given a batch of observations, e.g. of the trajectories of a
+         * BatchAssetAllocationTask, select an action for each of them. The
+         * default implementation calls getAction column by column; linear
+         * policies compute the activations of the whole batch with a single
+         * matrix product.
+         * \param observations_ observations, one per column
+         * \param actions_ output actions, one per column, resized if needed
+         */
+        virtual void getBatchActions(RealMat const & observations_,
+                                     RealMat &actions_) const
+        {
+            actions_.set_size(dimAction, observations_.n_cols);
+            RealVec action(dimAction);
+            for (size_t k = 0; k < observations_.n_cols; ++k)
+            {
+                getAction(observations_.col(k), action);
+                actions_.col(k) = action;
+            }
+        }
 
         /*!
          * Reset policy to initial conditions.
          */
         virtual void reset() = 0;
 
+        /*!
+         * Seed the random number generators used by the policy. Deterministic
+         * policies do not use random numbers, hence the default implementation
+         * does nothing.
+         * \param seed_ seed of the random number generators
+         */
+        virtual void seed(unsigned int seed_) {}
+
+        /*!
+         * Write the policy state to a snapshot. Deterministic policies are
+         * fully described by their parameters, which the default
+         * implementation writes.
+         * \param writer_ snapshot writer
+         */
+        virtual void saveState(CheckpointWriter &writer_) const
+        {
+            RealVec parameters(getDimParameters());
+            getParameters(parameters);
+            writer_.write(parameters);
+        }
+
+        /*!
+         * Read the policy state from a snapshot written by saveState.
+         * \param reader_ snapshot reader
+         */
+        virtual void loadState(CheckpointReader &reader_)
+        {
+            RealVec parameters(getDimParameters());
+            reader_.read(parameters);
+            setParameters(parameters);
+        }
+
     protected:
         /*!
          * checkedClone method for converting the unique pointer to Policy
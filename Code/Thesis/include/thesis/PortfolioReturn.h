@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PORTFOLIORETURN_H
+#define PORTFOLIORETURN_H
+
+#include <algorithm>    /* std::max */
+#include <cmath>        /* std::abs */
+#include <cstddef>      /* size_t */
+#include <limits>       /* std::numeric_limits */
+
+/**
+ * Fused kernel of the portfolio simple return shared by the asset allocation
+ * tasks. A single pass over the allocations computes the trading P&L, the
+ * proportional, fixed and short-selling costs and, if UpdateAllocation is
+ * set, the allocation weights drifted by the market transition, which still
+ * have to be normalized by the portfolio gross return.
+ *
+ * The partial sums are accumulated in independent lanes and the loop body is
+ * branch-free, so that the compiler can vectorize the reductions.
+ */
+
+//! Number of accumulators of the portfolio return reductions.
+static const size_t portfolioReturnLanes = 4;
+
+/**
+ * Compute the simple return for a portfolio allocation selected over a given
+ * allocation, on a market transition.
+ * \param numAssets_ number of risky assets.
+ * \param assetReturns_ simple returns of the risky assets.
+ * \param riskFreeRate_ risk-free rate.
+ * \param deltaP_ proportional transaction costs.
+ * \param deltaF_ fixed transaction costs.
+ * \param deltaS_ short-selling fees.
+ * \param newAllocation_ portfolio allocation selected.
+ * \param currentAllocation_ portfolio allocation held before the trade.
+ * \param driftedAllocation_ output drifted allocation weights.
+ * \return portfolio simple return.
+ */
+template<bool UpdateAllocation>
+inline double computePortfolioSimpleReturn(size_t numAssets_,
+                                           double const *assetReturns_,
+                                           double riskFreeRate_,
+                                           double deltaP_,
+                                           double deltaF_,
+                                           double deltaS_,
+                                           double const *newAllocation_,
+                                           double const *currentAllocation_,
+                                           double *driftedAllocation_)
+{
+    static_assert(portfolioReturnLanes == 4, "the lanes are reduced pairwise");
+
+    // Partial sums of the excess trading P&L, of the turnover and of the short
+    // positions weight
+    double excessPL[portfolioReturnLanes] = {};
+    double turnover[portfolioReturnLanes] = {};
+    double shortPositionsWeight[portfolioReturnLanes] = {};
+    double maxTrade = 0.0;
+    auto accumulate = [&](size_t i, size_t lane)
+    {
+        double const weight = newAllocation_[i];
+        double const trade = std::abs(weight - currentAllocation_[i]);
+        excessPL[lane] += weight * (assetReturns_[i] - riskFreeRate_);
+        turnover[lane] += trade;
+        shortPositionsWeight[lane] += std::max(-weight, 0.0);
+        maxTrade = std::max(maxTrade, trade);
+        if (UpdateAllocation)
+            driftedAllocation_[i] = weight * (1.0 + assetReturns_[i]);
+    };
+    size_t i = 0;
+    for (; i + portfolioReturnLanes <= numAssets_; i += portfolioReturnLanes)
+        for (size_t lane = 0; lane < portfolioReturnLanes; ++lane)
+            accumulate(i + lane, lane);
+    for (size_t lane = 0; i < numAssets_; ++i, ++lane)
+        accumulate(i, lane);
+    auto reduce = [](double const *lanes)
+        { return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]); };
+
+    // Proportional transaction costs
+    double proportionTransactionCosts = deltaP_ * reduce(turnover);
+
+    // Fixed transaction costs, charged if any weight changed
+    double fixedTransactionCosts = deltaF_ *
+        (maxTrade > std::numeric_limits<double>::epsilon());
+
+    // Short-selling fees
+    double shortTransactionCosts = deltaS_ * reduce(shortPositionsWeight);
+
+    // Trading profit & loss
+    double tradingPL = riskFreeRate_ + reduce(excessPL);
+
+    // Compute simple portfolio return
+    return tradingPL
+         - proportionTransactionCosts
+         - fixedTransactionCosts
+         - shortTransactionCosts;
+}
+
+#endif // PORTFOLIORETURN_H
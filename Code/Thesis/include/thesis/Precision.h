@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef PRECISION_H
+#define PRECISION_H
+
+#include <algorithm>  /* std::min, std::max */
+#include <limits>     /* std::numeric_limits */
+#include <armadillo>
+
+/*!
+ * Scalar type of the learning stack, i.e. of the parameters, gradients and
+ * caches of the policies, critics, parameter distributions and agents. The
+ * library computes in double precision by default, and in single precision
+ * when it is built with THESIS_SINGLE_PRECISION defined, which halves the
+ * memory traffic and doubles the SIMD width on large parameter vectors.
+ *
+ * The tasks, the market data and the Agent interface stay in double
+ * precision, as well as the running averages that accumulate many small
+ * increments, e.g. the reward baselines: the agents convert the observations
+ * and the actions at the interface.
+ */
+
+#ifdef THESIS_SINGLE_PRECISION
+typedef float Real;
+#else
+typedef double Real;
+#endif
+
+//! Vector and matrix of the learning stack scalar type
+typedef arma::Col<Real> RealVec;
+typedef arma::Mat<Real> RealMat;
+
+/*!
+ * Copy a vector or a matrix into a preallocated one of another scalar type,
+ * resizing it if needed. It is a plain copy when the scalar types match.
+ * \param from_ input values
+ * \param to_ output values
+ */
+template<typename eT>
+inline void convertTo(arma::Mat<eT> const &from_, arma::Mat<eT> &to_)
+{
+    to_ = from_;
+}
+
+template<typename eT1, typename eT2>
+inline void convertTo(arma::Mat<eT1> const &from_, arma::Mat<eT2> &to_)
+{
+    to_.set_size(from_.n_rows, from_.n_cols);
+    for (arma::uword i = 0; i < from_.n_elem; ++i)
+        to_[i] = static_cast<eT2>(from_[i]);
+}
+
+/*!
+ * Narrow a bound, e.g. a parameters bound, to the learning stack scalar type.
+ * Bounds beyond the largest finite Real saturate to it.
+ * \param value_ bound in double precision
+ * \return bound in the learning stack precision
+ */
+inline Real toRealBound(double value_)
+{
+    double const maxValue = std::numeric_limits<Real>::max();
+    return static_cast<Real>(std::min(std::max(value_, -maxValue), maxValue));
+}
+
+#endif // PRECISION_H
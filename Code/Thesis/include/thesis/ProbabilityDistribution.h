@@ -23,6 +23,8 @@
 #ifndef PROBABILITYDISTRIBUTION_H
 #define PROBABILITYDISTRIBUTION_H
 
+#include <thesis/Checkpoint.h>  /* CheckpointWriter, CheckpointReader */
+#include <thesis/Precision.h>  /* RealVec, RealMat */
 #include <armadillo>  /* arma::vec */
 #include <memory>     /* std::unique_ptr */
 
@@ -60,31 +62,84 @@ class ProbabilityDistribution
          * Get method for the distribution parameters.
          * \return parameters stored in an arma::vector
          */
-        virtual arma::vec getParameters() const = 0;
+        RealVec getParameters() const
+        {
+            RealVec parameters(getDimParameters());
+            getParameters(parameters);
+            return parameters;
+        }
+
+        /*!
+         * Get method for the distribution parameters in a preallocated vector.
+         * \param parameters_ output parameters, resized if needed
+         */
+        virtual void getParameters(RealVec &parameters_) const = 0;
 
         /*!
          * Set method for the distribution parameters.
          * \param parameters_ the new parameters stored in an arma::vector
          */
-        virtual void setParameters(arma::vec const &parameters_) = 0;
+        virtual void setParameters(RealVec const &parameters_) = 0;
 
         /*!
          * Simulate a realization of the probability distribution.
          * \return realization of the probability distribution
          */
-        virtual arma::vec simulate() const = 0;
+        RealVec simulate() const
+        {
+            RealVec simulation(getDimOutput());
+            simulate(simulation);
+            return simulation;
+        }
+
+        /*!
+         * Simulate a realization in a preallocated vector.
+         * \param simulation_ output realization, resized if needed
+         */
+        virtual void simulate(RealVec &simulation_) const = 0;
 
         /*!
          * Evaluate the Likelihood score of a given realization
          * \param output_ distribution realization
          * \return likelihood score evaluated at output_
          */
-        virtual arma::vec likelihoodScore(arma::vec const &output_) const = 0;
+        RealVec likelihoodScore(RealVec const &output_) const
+        {
+            RealVec likScore(getDimParameters());
+            likelihoodScore(output_, likScore);
+            return likScore;
+        }
+
+        /*!
+         * Evaluate the Likelihood score in a preallocated vector.
+         * \param output_ distribution realization
+         * \param likScore_ output likelihood score, resized if needed
+         */
+        virtual void likelihoodScore(RealVec const &output_,
+                                     RealVec &likScore_) const = 0;
 
         /*!
          * Reset distribution to initial conditions.
          */
         virtual void reset() = 0;
+
+        /*!
+         * Seed the random number generator used to simulate the distribution.
+         * \param seed_ seed of the random number generator
+         */
+        virtual void seed(unsigned int seed_) = 0;
+
+        /*!
+         * Write the parameters and the generator state to a snapshot.
+         * \param writer_ snapshot writer
+         */
+        virtual void saveState(CheckpointWriter &writer_) const = 0;
+
+        /*!
+         * Read the distribution state from a snapshot written by saveState.
+         * \param reader_ snapshot reader
+         */
+        virtual void loadState(CheckpointReader &reader_) = 0;
 };
 
 #endif // PROBABILITYDISTRIBUTION_H
@@ -27,6 +27,9 @@
 #include <thesis/Policy.h>
 #include <thesis/Statistics.h>
 #include <thesis/LearningRate.h>
+#include <thesis/ParameterCovariance.h>
+#include <thesis/NpgpePopulation.h>
+#include <thesis/Philox.h>
 #include <memory>
 
 /*!
@@ -42,7 +45,8 @@ class RiskSensitiveNPGPEAgent : public Agent
 
         /*!
          * Constructor.
-         * Initialize aRiskSensitiveNPGPEAgent given a deterministic policy.
+         * Initialize aRiskSensitiveNPGPEAgent given a deterministic policy, with a
+         * full covariance matrix of the parameter distribution.
          * \param policy_ deterministic controller.
          * \param learningRate learning rate object.
          * \param discount_ discount factor
@@ -52,6 +56,28 @@ class RiskSensitiveNPGPEAgent : public Agent
                                 LearningRate const &hyperparamsLearningRate_,
                                 double lambda_);
 
+        /*!
+         * Constructor.
+         * Initialize a RiskSensitiveNPGPEAgent given a deterministic policy and the
+         * structure of the covariance of the parameter distribution.
+         * \param policy_ deterministic controller.
+         * \param covariance_ covariance structure, e.g. DiagonalCovariance for
+         *        controllers with many parameters.
+         * \param baselineLearningRate_ learning rate for the reward baseline.
+         * \param hyperparamsLearningRate_ learning rate for the hyperparameters.
+         * \param lambda_ eligibility trace parameter
+         * \param populationSize_ number of parameter samples evaluated at each
+         *        step. With more than one sample, the controller must support
+         *        batched evaluation and the task must provide the rewards of
+         *        the candidate actions.
+         */
+        RiskSensitiveNPGPEAgent(Policy const &policy_,
+                                ParameterCovariance const &covariance_,
+                                LearningRate const &baselineLearningRate_,
+                                LearningRate const &hyperparamsLearningRate_,
+                                double lambda_,
+                                size_t populationSize_=1);
+
         /*!
          * Copy constructor.
          * \param other_ RiskSensitiveNPGPEAgent to copy.
@@ -74,15 +100,17 @@ class RiskSensitiveNPGPEAgent : public Agent
          * \param observation system state observation.
          */
         virtual void receiveObservation(arma::vec const &observation_)
-            { observation = observation_; }
+            { convertTo(observation_, observation); }
+
+        using Agent::getAction;
 
         /*!
          * Get action A_t to be performed on the system. This action will be
          * passed to a task object, which manages the interaction between an
          * agent and an environment.
-         * \return action action selected by the agent.
+         * \param action_ output action selected by the agent.
          */
-        virtual arma::vec getAction();
+        virtual void getAction(arma::vec &action_);
 
         /*!
          * Receive reward R_{t+1} from the system. This reward will be typically
@@ -91,6 +119,25 @@ class RiskSensitiveNPGPEAgent : public Agent
          */
         virtual void receiveReward(double reward_) { reward = reward_; }
 
+        //! Get number of parameter samples evaluated at each step
+        virtual size_t getPopulationSize() const { return population.size(); }
+
+        /*!
+         * Get the actions selected by the parameter samples of the current
+         * step. The first one is the action returned by getAction.
+         * \param actions_ output actions, one per column, resized if needed.
+         */
+        virtual void getPopulationActions(arma::mat &actions_) const
+            { population.getActions(actions_); }
+
+        /*!
+         * Receive the rewards of the actions selected by the parameter
+         * samples of the current step.
+         * \param rewards_ rewards of the candidate actions.
+         */
+        virtual void receivePopulationRewards(arma::vec const &rewards_)
+            { population.receiveRewards(rewards_); }
+
         /*!
          * Receive observation O_{t+1} of the system state after the transition
          * induced by the action selected by the agent. NPGPE does not use this
@@ -119,16 +166,48 @@ class RiskSensitiveNPGPEAgent : public Agent
          */
         virtual void reset();
 
+        /*!
+         * Seed the random number generators used by the agent.
+         * \param seed_ seed of the random number generators.
+         */
+        virtual void seed(unsigned int seed_);
+
+        /*!
+         * Write the hyperparameters, the baselines, the eligibility traces, the
+         * learning rates and the generator states to a snapshot.
+         * \param writer_ snapshot writer
+         */
+        virtual void saveState(CheckpointWriter &writer_) const;
+
+        /*!
+         * Read the learning state from a snapshot written by saveState.
+         * \param reader_ snapshot reader
+         */
+        virtual void loadState(CheckpointReader &reader_);
+
     private:
 
         /*!
-         * Initialize the NPGPE agent parameters, i.e. the mean and the cholesky
-         * factor of the covariance matrix of the Gaussian parameter
-         * distribution.
+         * Initialize the NPGPE agent parameters, i.e. the mean and the factor
+         * of the covariance matrix of the Gaussian parameter distribution.
          */
 
         void initializeParameters();
 
+        /*!
+         * Sample the whole population of controller parameters, evaluate it on
+         * the current observation and return the action of the first sample.
+         * \param action_ output action.
+         */
+        void getPopulationAction(arma::vec &action_);
+
+        /*!
+         * Learning step in population mode. The current step contributes the
+         * average of the likelihood-weighted rewards of the population, while
+         * the eligibility trace follows the performed samples.
+         */
+        void learnPopulation();
+
         /*!
          * Deterministic controller.
          * A deterministic mapping from a state observation to an action.
@@ -136,21 +215,22 @@ class RiskSensitiveNPGPEAgent : public Agent
         std::unique_ptr<Policy> policyPtr;
 
         //! Random number generator.
-        mutable std::mt19937 generator;
+        mutable Philox4x32 generator;
 
         /*!
-         * Parameter distribution. The controller parameters are sampled from a
-         * multi-variate Gaussian distribution, parametrized by the mean and the
-         * Cholesky factor of the covariance matrix.
+         * Structure of the covariance matrix of the parameter distribution. The
+         * controller parameters are sampled from a multi-variate Gaussian
+         * distribution, parametrized by the mean and a factor of the covariance
+         * matrix, whose structure is given by the covariance object.
          */
-        mutable std::normal_distribution<double> gaussianDistr;
+        std::unique_ptr<ParameterCovariance> covariancePtr;
 
         // Cache variable for the parameter simulation used in the learning.
-        arma::vec xi;
+        RealVec xi;
 
         //! Parameter distribution hyperparameters
-        arma::vec mean;
-        arma::mat choleskyFactor;  // Sigma = choleskyFactor * choleskyFactor'
+        RealVec mean;
+        RealVec covarianceFactor;
 
         /*!
          * Average reward baseline, i.e. a moving average of the past reward
@@ -165,8 +245,16 @@ class RiskSensitiveNPGPEAgent : public Agent
         double squareRewardBaseline;
 
         //! Gradient cache
-        arma::vec gradientMean;
-        arma::mat gradientChol;
+        RealVec gradientMean;
+        RealVec gradientFactor;
+
+        //! Cache variables for the controller parameters and likelihood score
+        RealVec policyParameters;
+        RealVec likelihoodMean;
+        RealVec likelihoodFactor;
+
+        //! Parameter samples evaluated at each step
+        NPGPEPopulation population;
 
         //! Learning rate for the baseline
         std::unique_ptr<LearningRate> baselineLearningRatePtr;
@@ -178,8 +266,8 @@ class RiskSensitiveNPGPEAgent : public Agent
         double lambda;
 
         // Cache variables
-        arma::vec observation;
-        arma::vec action;
+        RealVec observation;
+        RealVec action;
         double reward;
 };
 
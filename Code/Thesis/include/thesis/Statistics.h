@@ -23,6 +23,8 @@
 #ifndef STATISTICS_H
 #define STATISTICS_H
 
+#include <armadillo>
+#include <string>
 #include <vector>
 #include <memory>
 
@@ -184,5 +186,81 @@ class StatisticsExperiment : public Statistics
         StatisticsAverage averageSquareReward;
 };
 
+/**
+ * StatisticsBacktest gathers the performance measures of a backtest from the
+ * stream of portfolio log-returns and allocations, in constant time per step
+ * with respect to the length of the backtest:
+ *
+ *  - cumulative return, i.e. exp(sum of log-returns) - 1;
+ *  - maximum drawdown of the wealth from its running peak, as a negative
+ *    fraction, and the longest number of steps spent below a previous peak;
+ *  - average turnover, i.e. the L1 norm of the change of the risky
+ *    allocations between consecutive steps;
+ *  - Sharpe and Sortino ratios of the log-returns, not annualized, the latter
+ *    using the downside deviation below zero;
+ *  - hit rate, i.e. the fraction of steps with a positive log-return.
+ *
+ * The ratios whose denominator vanishes are reported as zero.
+ */
+
+class StatisticsBacktest : public Statistics
+{
+    public:
+        //! Constructor.
+        StatisticsBacktest();
+
+        //! Copy constructor.
+        StatisticsBacktest(StatisticsBacktest const &other_) = default;
+
+        //! Destructor.
+        virtual ~StatisticsBacktest() = default;
+
+        //! Clone method for polymorphic copy.
+        virtual std::unique_ptr<Statistics> clone() const;
+
+        /**
+         * Update statistics with a new portfolio log-return.
+         * \param result portfolio log-return
+         */
+        virtual void dumpOneResult(double result);
+
+        /**
+         * Update statistics with a new backtest step.
+         * \param allocation_ allocation in the risky assets
+         * \param result portfolio log-return
+         */
+        void dumpOneRecord(arma::vec const &allocation_, double result);
+
+        /**
+         * Compute backtest statistics.
+         * \return cumulative return, maximum drawdown, maximum drawdown
+         *         duration, average turnover, Sharpe ratio, Sortino ratio and
+         *         hit rate, in the order given by names().
+         */
+        virtual std::vector<std::vector<double>> getStatistics() const;
+
+        //! Reset statistics gatherer to initial conditions.
+        virtual void reset();
+
+        //! Comma-separated names of the statistics.
+        static std::string names();
+
+    private:
+        size_t nResults;
+        double meanReward;
+        double sumSquareDeviation;
+        double sumSquareDownside;
+        size_t nPositive;
+
+        double logWealth;
+        double peakLogWealth;
+        double minDrawdown;
+        size_t drawdownDuration;
+        size_t maxDrawdownDuration;
+
+        arma::vec previousAllocation;
+        double sumTurnover;
+};
+
 
 #endif // STATISTICS_H
@@ -32,9 +32,15 @@
  * A StochasticActor is the stochastic policy employed by an Agent for selecting
  * an action given an observation of the system. The class is based on the
  * StochasticPolicy hierarchy by virtual composition.
+ *
+ * The policy type is a template parameter: StochasticActor holds any
+ * StochasticPolicy, while an actor on a final policy class, e.g.
+ * BasicStochasticActor<BoltzmannPolicy>, calls the policy methods directly
+ * instead of through the virtual table.
  */
 
-class StochasticActor : public Actor
+template<class PolicyT>
+class BasicStochasticActor final : public Actor
 {
     public:
         /*!
@@ -42,18 +48,18 @@ class StochasticActor : public Actor
          * Initialize a stochastic actor given a stochastic policy.
          * \param policy_ stochastic policy polymorphic object.
          */
-        StochasticActor(StochasticPolicy const &policy_)
-            : policyPtr(policy_.clone()) {}
+        BasicStochasticActor(PolicyT const &policy_)
+            : policyPtr(static_cast<PolicyT *>(policy_.clone().release())) {}
 
         /*!
          * Copy constructor
          * \param actor_ another stochastic actor
          */
-        StochasticActor(StochasticActor const &actor_)
-            : policyPtr(actor_.policyPtr->clone()) {}
+        BasicStochasticActor(BasicStochasticActor const &actor_)
+            : policyPtr(static_cast<PolicyT *>(actor_.policyPtr->clone().release())) {}
 
         //! Default destructor
-        virtual ~StochasticActor() = default;
+        virtual ~BasicStochasticActor() = default;
 
         /*!
          * Get observation size, i.e. size of the observation vector.
@@ -77,23 +83,33 @@ class StochasticActor : public Actor
          * Get method for the actor's parameters.
          * \return parameters stored in an arma::vector
          */
-        arma::vec getParameters() const
+        RealVec getParameters() const
             { return policyPtr->getParameters(); }
 
+        /*!
+         * Get method for the actor's parameters in a preallocated vector.
+         * \param parameters_ output parameters, resized if needed
+         */
+        void getParameters(RealVec &parameters_) const
+            { policyPtr->getParameters(parameters_); }
+
         /*!
          * Set method for the actor's parameters.
          * \param parameters_ the new parameters stored in an arma::vector
          */
-        void setParameters(arma::vec const &parameters)
+        void setParameters(RealVec const &parameters)
             { policyPtr->setParameters(parameters); }
 
+        using Actor::getAction;
+
         /*!
          * Given an observation, select an action accordind to the policy.
          * \param observation_ observation
-         * \return action
+         * \param action_ output action, resized if needed
          */
-        arma::vec getAction(arma::vec const &observation) const
-            { return policyPtr->getAction(observation); }
+        virtual void getAction(RealVec const &observation,
+                               RealVec &action_) const
+            { policyPtr->getAction(observation, action_); }
 
         /*!
          * Evaluate the Likelihood score function at a given observation and
@@ -102,18 +118,60 @@ class StochasticActor : public Actor
          * \param action_ action
          * \return likelihood score evaluated at observation_ and action_
          */
-        arma::vec likelihoodScore(arma::vec const &observation,
-                                  arma::vec const &action) const
+        RealVec likelihoodScore(RealVec const &observation,
+                                  RealVec const &action) const
             { return policyPtr->likelihoodScore(observation, action); }
 
+        /*!
+         * Evaluate the Likelihood score function in a preallocated vector.
+         * \param observation_ observation
+         * \param action_ action
+         * \param likScore_ output likelihood score, resized if needed
+         */
+        void likelihoodScore(RealVec const &observation,
+                             RealVec const &action,
+                             RealVec &likScore_) const
+            { policyPtr->likelihoodScore(observation, action, likScore_); }
+
+        /*!
+         * Evaluate the Likelihood score function of an action selected by
+         * another copy of the actor, see StochasticPolicy.
+         * \param observation_ observation
+         * \param action_ action
+         * \param likScore_ output likelihood score, resized if needed
+         */
+        void behaviourLikelihoodScore(RealVec const &observation,
+                                      RealVec const &action,
+                                      RealVec &likScore_) const
+            { policyPtr->behaviourLikelihoodScore(observation, action, likScore_); }
+
+        //! Check whether the actions selected by another copy can be scored.
+        bool supportsBehaviourScore() const
+            { return policyPtr->supportsBehaviourScore(); }
+
         /*!
          * Reset stochatic actor to initial conditions.
          */
         void reset() { policyPtr->reset(); }
 
+        /*!
+         * Seed the random number generators of the stochastic policy.
+         * \param seed_ seed of the random number generators
+         */
+        void seed(unsigned int seed_) { policyPtr->seed(seed_); }
+
+        //! Write the state of the stochastic policy to a snapshot.
+        void saveState(CheckpointWriter &writer_) const { policyPtr->saveState(writer_); }
+
+        //! Read the state of the stochastic policy from a snapshot.
+        void loadState(CheckpointReader &reader_) { policyPtr->loadState(reader_); }
+
     private:
         //! Stochastic policy employed by the agent
-        std::unique_ptr<StochasticPolicy> policyPtr;
+        std::unique_ptr<PolicyT> policyPtr;
 };
 
+//! Stochastic actor on any stochastic policy
+typedef BasicStochasticActor<StochasticPolicy> StochasticActor;
+
 #endif // STOCHASTICACTOR_H
@@ -57,39 +57,53 @@ class StochasticPolicy : public Policy
         }
 
         /*!
-         * Get policy parameters size, i.e. size of the parameter vector
-         * \return parameters size
-         */
-        virtual size_t getDimParameters() const = 0;
-
-        /*!
-         * Get method for the policy parameters.
-         * \return parameters stored in an arma::vector
+         * Evaluate the Likelihood score function at a given observation and
+         * action.
+         * \param observation_ observation
+         * \param action_ action
+         * \return likelihood score evaluated at observation_ and action_
          */
-        virtual arma::vec getParameters() const = 0;
+        RealVec likelihoodScore(RealVec const &observation_,
+                                  RealVec const &action_) const
+        {
+            RealVec likScore(getDimParameters());
+            likelihoodScore(observation_, action_, likScore);
+            return likScore;
+        }
 
         /*!
-         * Set method for the policy parameters.
-         * \param parameters_ the new parameters stored in an arma::vector
+         * Evaluate the Likelihood score function at a given observation and
+         * action and write it in a preallocated vector.
+         * \param observation_ observation
+         * \param action_ action
+         * \param likScore_ output likelihood score, resized if needed
          */
-        virtual void setParameters(arma::vec const &parameters_) = 0;
+        virtual void likelihoodScore(RealVec const &observation_,
+                                     RealVec const &action_,
+                                     RealVec &likScore_) const = 0;
 
         /*!
-         * Given an observation, select an action accordind to the policy.
+         * Evaluate the likelihood score of an action selected by another copy
+         * of the policy, e.g. by an actor thread of an asynchronous
+         * actor-learner, so that the caches filled by getAction on this copy
+         * cannot be reused. The default implementation calls likelihoodScore.
          * \param observation_ observation
-         * \return action
+         * \param action_ action
+         * \param likScore_ output likelihood score, resized if needed
          */
-        virtual arma::vec getAction(arma::vec const &observation_) const = 0;
+        virtual void behaviourLikelihoodScore(RealVec const &observation_,
+                                              RealVec const &action_,
+                                              RealVec &likScore_) const
+        {
+            likelihoodScore(observation_, action_, likScore_);
+        }
 
         /*!
-         * Evaluate the Likelihood score function at a given observation and
-         * action.
-         * \param observation_ observation
-         * \param action_ action
-         * \return likelihood score evaluated at observation_ and action_
+         * Check whether behaviourLikelihoodScore can score the actions selected
+         * by another copy of the policy.
+         * \return true by default.
          */
-        virtual arma::vec likelihoodScore(arma::vec const &observation_,
-                                          arma::vec const &action_) const = 0;
+        virtual bool supportsBehaviourScore() const { return true; }
 
         /*!
          * Reset policy to initial conditions.
@@ -0,0 +1,296 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef SYNTHETICMARKETENVIRONMENT_H
+#define SYNTHETICMARKETENVIRONMENT_H
+
+#include <thesis/MarketEnvironment.h>
+#include <thesis/Philox.h>
+#include <armadillo>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+/**
+ * SyntheticMarketEnvironment is the base class of the financial markets whose
+ * return series are simulated on the fly instead of being read from a file.
+ * The returns are generated in blocks of blockSize days from a random stream
+ * determined by the path seed, hence the series has no length limit apart
+ * from numDays and the memory footprint is a single block.
+ *
+ * The noise of each block is drawn from its own sub-stream of a counter-based
+ * generator, keyed by the path seed and the block index. Dates only move
+ * forward during an epoch: when the environment is reset, the path is
+ * replayed from a snapshot of the process state taken at the beginning of the
+ * block containing the start date, so that every epoch observes the same
+ * path, as for historical markets. Seeding the environment draws a new path.
+ */
+
+class SyntheticMarketEnvironment : public MarketEnvironment
+{
+    public:
+        /**
+         * Constructor.
+         * \param numRiskyAssets_ number of risky assets
+         * \param numDays_ number of days of the simulated series
+         * \param dimNoise_ number of standard normal draws per day
+         * \param dimProcess_ size of the state of the simulated process
+         * \param blockSize_ number of days generated at once
+         * \param seed_ seed of the path
+         */
+        SyntheticMarketEnvironment(size_t numRiskyAssets_,
+                                   size_t numDays_,
+                                   size_t dimNoise_,
+                                   size_t dimProcess_,
+                                   size_t blockSize_,
+                                   unsigned int seed_);
+
+        //! Virtual destructor.
+        virtual ~SyntheticMarketEnvironment() = default;
+
+        /**
+         * Get system state.
+         * \return current time step risky assets returns.
+         */
+        virtual arma::vec getState() const;
+
+        /**
+         * Get system state in a preallocated vector.
+         * \param state_ output risky assets returns, resized if needed.
+         */
+        virtual void getState(arma::vec &state_) const;
+
+        //! Get assets ticker symbols.
+        virtual std::vector<std::string> getAssetsSymbols() const = 0;
+
+        //! Get total number of days of the simulated series.
+        virtual size_t getNumDays() const { return numDays; }
+
+        //! Get number of days generated at once.
+        size_t getBlockSize() const { return blockSize; }
+
+        //! Reset market environment to the start date of the same path.
+        virtual void reset();
+
+        /**
+         * Draw a new path.
+         * \param seed_ seed of the path.
+         */
+        virtual void seed(unsigned int seed_);
+
+    protected:
+        /**
+         * Initialize the state of the simulated process at the first day.
+         * \param process_ output process state.
+         */
+        virtual void initializeProcess(arma::vec &process_) const = 0;
+
+        /**
+         * Generate a block of returns.
+         * \param noise_ standard normal draws, one column per day.
+         * \param process_ process state, updated to the end of the block.
+         * \param returns_ output risky assets returns, one column per day.
+         */
+        virtual void generateBlock(arma::mat const &noise_,
+                                   arma::vec &process_,
+                                   arma::mat &returns_) const = 0;
+
+    private:
+        //! Process state at the beginning of a block.
+        struct PathCursor
+        {
+            arma::vec process;
+            size_t nextBlockStart;
+            bool valid;
+        };
+
+        //! Generate the block containing a given date.
+        void seekBlock(size_t date) const;
+
+        //! Rewind the path to the first day.
+        void restartPath() const;
+
+        //! Total number of days.
+        size_t numDays;
+
+        //! Number of days generated at once.
+        size_t blockSize;
+
+        //! Seed of the path.
+        unsigned int pathSeed;
+
+        //! Current position in the path and snapshot at the start date block.
+        mutable PathCursor cursor;
+        mutable PathCursor anchor;
+
+        //! Random number generator.
+        mutable Philox4x32 generator;
+
+        //! Current block of returns and its first day.
+        mutable arma::mat returnsBlock;
+        mutable size_t blockStart;
+        mutable bool blockValid;
+
+        //! Noise cache.
+        mutable arma::mat noiseBlock;
+};
+
+/**
+ * ArTrendMarketEnvironment simulates the synthetic series of Moody & Saffell,
+ * "Learning to trade via direct reinforcement" (2001), i.e. random walks of
+ * the log-prices with an autoregressive trend
+ *
+ *      p_t = p_{t-1} + beta_{t-1} + sigma * epsilon_t
+ *      beta_t = alpha * beta_{t-1} + nu_t
+ *
+ * for independent risky assets. The Python generator rescales the log-prices
+ * by their range over the whole path, which is not available when the path is
+ * streamed, hence they are rescaled by the fixed factor logPriceScale, the
+ * typical range of a 10000 days path.
+ */
+
+class ArTrendMarketEnvironment : public SyntheticMarketEnvironment
+{
+    public:
+        /**
+         * Constructor.
+         * \param numDays_ number of days of the simulated series
+         * \param numRiskyAssets_ number of independent risky assets
+         * \param alpha_ autoregressive coefficient of the trend
+         * \param sigma_ volatility of the log-price increments
+         * \param logPriceScale_ rescaling factor of the log-prices
+         * \param blockSize_ number of days generated at once
+         * \param seed_ seed of the path
+         */
+        ArTrendMarketEnvironment(size_t numDays_,
+                                 size_t numRiskyAssets_=1,
+                                 double alpha_=0.9,
+                                 double sigma_=10.0,
+                                 double logPriceScale_=2000.0,
+                                 size_t blockSize_=256,
+                                 unsigned int seed_=0);
+
+        //! Virtual destructor.
+        virtual ~ArTrendMarketEnvironment() = default;
+
+        //! Clone method for polymorphic composition.
+        virtual std::unique_ptr<Environment> clone() const;
+
+        //! Get assets ticker symbols.
+        virtual std::vector<std::string> getAssetsSymbols() const;
+
+    protected:
+        //! The trend starts at zero.
+        virtual void initializeProcess(arma::vec &process_) const;
+
+        //! Generate a block of returns.
+        virtual void generateBlock(arma::mat const &noise_,
+                                   arma::vec &process_,
+                                   arma::mat &returns_) const;
+
+    private:
+        //! Model parameters.
+        double alpha;
+        double sigma;
+        double logPriceScale;
+};
+
+/**
+ * CointegratedMarketEnvironment simulates two risky assets whose log-prices
+ * are driven by correlated geometric Brownian motions plus a mean-reverting
+ * Ornstein-Uhlenbeck spread on the second asset
+ *
+ *      log S^1_t = log S^1_{t-1} - sigma_1^2 dt / 2 + sigma_1 sqrt(dt) W^1_t
+ *      log S^2_t = log S^2_{t-1} - sigma_2^2 dt / 2 + sigma_2 sqrt(dt) W^2_t
+ *                  + gamma_t - gamma_{t-1}
+ *      gamma_t = exp(-theta dt) gamma_{t-1} + sigma_gamma sqrt((1 - exp(-2 theta dt)) / (2 theta)) Z_t
+ *
+ * where W^1 and W^2 have correlation rho, as in generate_cointegrated_series.py.
+ */
+
+class CointegratedMarketEnvironment : public SyntheticMarketEnvironment
+{
+    public:
+        /**
+         * Constructor.
+         * \param numDays_ number of days of the simulated series
+         * \param sigma1_ volatility of the first asset
+         * \param sigma2_ volatility of the second asset
+         * \param sigmaSpread_ volatility of the spread
+         * \param theta_ mean-reversion rate of the spread
+         * \param rho_ correlation between the two assets
+         * \param dt_ sampling period in years
+         * \param blockSize_ number of days generated at once
+         * \param seed_ seed of the path
+         */
+        CointegratedMarketEnvironment(size_t numDays_,
+                                      double sigma1_=0.20,
+                                      double sigma2_=0.15,
+                                      double sigmaSpread_=0.20,
+                                      double theta_=0.15,
+                                      double rho_=0.8,
+                                      double dt_=1.0/365,
+                                      size_t blockSize_=256,
+                                      unsigned int seed_=0);
+
+        //! Virtual destructor.
+        virtual ~CointegratedMarketEnvironment() = default;
+
+        //! Clone method for polymorphic composition.
+        virtual std::unique_ptr<Environment> clone() const;
+
+        //! Get assets ticker symbols.
+        virtual std::vector<std::string> getAssetsSymbols() const;
+
+    protected:
+        //! The spread starts at zero.
+        virtual void initializeProcess(arma::vec &process_) const;
+
+        //! Generate a block of returns.
+        virtual void generateBlock(arma::mat const &noise_,
+                                   arma::vec &process_,
+                                   arma::mat &returns_) const;
+
+    private:
+        //! Discretized model parameters.
+        double drift1;
+        double drift2;
+        double vol1;
+        double vol2;
+        double rho;
+        double spreadDecay;
+        double spreadVol;
+};
+
+/**
+ * Create a synthetic market from its name, as read from a parameter file.
+ * \param type_ either "artrend" or "cointegrated".
+ * \param numDays_ number of days of the simulated series.
+ * \param seed_ seed of the path.
+ * \return unique_ptr pointing to the new market environment.
+ */
+std::unique_ptr<MarketEnvironment> makeSyntheticMarketEnvironment(std::string const &type_,
+                                                                  size_t numDays_,
+                                                                  unsigned int seed_=0);
+
+#endif // SYNTHETICMARKETENVIRONMENT_H
@@ -26,6 +26,7 @@
 #include <thesis/Environment.h>     /* Environment */
 #include <armadillo>                /* arma::vec */
 #include <memory>                   /* std::unique_ptr */
+#include <stdexcept>                /* std::logic_error */
 
 /**
  * Generic interface for a reinforcement learning task. The Task specifies what
@@ -70,7 +71,19 @@ class Task
          * the system.
          * \return observation of the state.
          */
-        virtual arma::vec getObservation () const = 0;
+        arma::vec getObservation () const
+        {
+            arma::vec observation(getDimObservation());
+            getObservation(observation);
+            return observation;
+        }
+
+        /**
+         * Provide an observation of the state in a preallocated vector. This
+         * is the allocation-free variant used in the interaction loop.
+         * \param observation_ output observation, resized if needed.
+         */
+        virtual void getObservation (arma::vec &observation_) const = 0;
 
         /**
          * Perform action.
@@ -87,6 +100,20 @@ class Task
          */
         virtual double getReward () const = 0;
 
+        /**
+         * Provide the rewards that a set of candidate actions would have
+         * earned on the last transition, starting from the same state as the
+         * performed action. It must be called after getReward and it is used
+         * by agents that evaluate a population of policies at each step.
+         * \param actions_ candidate actions, one per column.
+         * \param rewards_ output rewards, resized if needed.
+         */
+        virtual void getRewards (arma::mat const &actions_,
+                                 arma::vec &rewards_) const
+        {
+            throw std::logic_error("Task does not provide the rewards of candidate actions");
+        }
+
         /**
          * Reset task to the initial conditions. This method is used in
          * episodic tasks to reset the environment when a terminal state is
@@ -94,6 +121,12 @@ class Task
          */
         virtual void reset() = 0;
 
+        /**
+         * Seed the random number generators of the underlying environment.
+         * \param seed_ seed of the random number generators.
+         */
+        void seed(unsigned int seed_) { environmentPtr->seed(seed_); }
+
     protected:
 
         /**
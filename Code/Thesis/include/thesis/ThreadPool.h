@@ -0,0 +1,97 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <vector>
+
+/**
+ * ThreadPool implements a fixed-size pool of worker threads consuming a FIFO
+ * queue of tasks. It is used to run independent experiments concurrently. Each
+ * submitted task returns a std::future, so that exceptions thrown by a worker
+ * are propagated to the thread that waits for the result.
+ */
+
+class ThreadPool
+{
+    public:
+        /*!
+         * Constructor.
+         * Start the worker threads.
+         * \param numThreads_ number of worker threads. If zero, the number of
+         *        hardware threads is used.
+         */
+        explicit ThreadPool(size_t numThreads_);
+
+        //! Deleted copy constructor: a pool owns its threads.
+        ThreadPool(ThreadPool const &other_) = delete;
+
+        //! Deleted assignment operator.
+        ThreadPool &operator=(ThreadPool const &other_) = delete;
+
+        /*!
+         * Destructor.
+         * Wait for the queued tasks to be completed and join the workers.
+         */
+        ~ThreadPool();
+
+        //! Get number of worker threads
+        size_t getNumThreads() const { return workers.size(); }
+
+        /*!
+         * Submit a task to the pool.
+         * \param task_ callable object without arguments.
+         * \return future used to wait for the task completion.
+         */
+        std::future<void> submit(std::function<void()> task_);
+
+        /*!
+         * Number of hardware threads available on the machine, or 1 if it
+         * cannot be detected.
+         */
+        static size_t hardwareConcurrency();
+
+    private:
+        //! Main loop executed by each worker.
+        void workerLoop();
+
+        //! Worker threads
+        std::vector<std::thread> workers;
+
+        //! Pending tasks
+        std::queue<std::packaged_task<void()>> tasks;
+
+        //! Synchronization variables
+        std::mutex queueMutex;
+        std::condition_variable queueCondition;
+        bool stopping;
+};
+
+#endif // THREADPOOL_H
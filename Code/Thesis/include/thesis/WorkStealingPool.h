@@ -0,0 +1,129 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef WORKSTEALINGPOOL_H
+#define WORKSTEALINGPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * WorkStealingPool implements a pool of worker threads for nested parallel
+ * loops. Each worker owns a double-ended queue of tasks: it pushes and pops
+ * its own tasks at the back, while idle workers steal the oldest tasks from
+ * the front of the other queues.
+ *
+ * A thread waiting in parallelFor executes queued tasks instead of blocking,
+ * hence a task can run a parallel loop of its own on the same pool. This is
+ * used by the parameter sweep, whose jobs run their independent experiments
+ * as nested loops, so that the whole grid is balanced across the workers.
+ */
+
+class WorkStealingPool
+{
+    public:
+        /*!
+         * Constructor.
+         * Start the worker threads.
+         * \param numThreads_ number of worker threads. If zero, the number of
+         *        hardware threads is used.
+         */
+        explicit WorkStealingPool(size_t numThreads_);
+
+        //! Deleted copy constructor: a pool owns its threads.
+        WorkStealingPool(WorkStealingPool const &other_) = delete;
+
+        //! Deleted assignment operator.
+        WorkStealingPool &operator=(WorkStealingPool const &other_) = delete;
+
+        /*!
+         * Destructor.
+         * Wait for the queued tasks to be completed and join the workers.
+         */
+        ~WorkStealingPool();
+
+        //! Get number of worker threads
+        size_t getNumThreads() const { return workers.size(); }
+
+        /*!
+         * Run job(0), ..., job(numJobs_ - 1) on the pool and wait for their
+         * completion. The calling thread executes queued tasks while waiting.
+         * The first exception thrown by a job is rethrown once all the jobs
+         * are completed.
+         * \param numJobs_ number of jobs.
+         * \param job_ function executing a job given its index.
+         */
+        void parallelFor(size_t numJobs_, std::function<void(size_t)> const &job_);
+
+    private:
+        //! Task queue owned by a worker
+        struct WorkerQueue
+        {
+            std::mutex mutex;
+            std::deque<std::function<void()>> tasks;
+        };
+
+        /*!
+         * Queue a task, on the queue of the calling worker if any, otherwise
+         * on the queues of the workers in turn.
+         */
+        void push(std::function<void()> task_);
+
+        /*!
+         * Execute one queued task, taken from the back of the own queue or
+         * stolen from the front of another one.
+         * \param self_ index of the calling worker, getNumThreads() for a
+         *        thread outside the pool.
+         * \return false if no task was found.
+         */
+        bool runOne(size_t self_);
+
+        //! Wake up the threads waiting for tasks or for a loop to complete.
+        void notifyAll();
+
+        //! Main loop executed by each worker.
+        void workerLoop(size_t index_);
+
+        //! Index of the calling thread in this pool, getNumThreads() if none.
+        size_t currentIndex() const;
+
+        //! Worker queues and threads
+        std::vector<std::unique_ptr<WorkerQueue>> queues;
+        std::vector<std::thread> workers;
+
+        //! Number of queued tasks and queue receiving the next external task
+        std::atomic<size_t> numQueued;
+        std::atomic<size_t> nextQueue;
+
+        //! Synchronization variables of the idle threads
+        std::mutex sleepMutex;
+        std::condition_variable sleepCondition;
+        bool stopping;
+};
+
+#endif // WORKSTEALINGPOOL_H
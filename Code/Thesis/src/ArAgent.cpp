@@ -10,6 +10,8 @@ ARAgent::ARAgent(StochasticActor const & actor_,
       actorLearningRatePtr(actorLearningRate_.clone()),
       lambda(lambda_),
       gradientActor(actor.getDimParameters(), arma::fill::zeros),
+      likelihoodScoreCache(actor.getDimParameters()),
+      actorParameters(actor.getDimParameters()),
       observation(actor_.getDimObservation()),
       action(actor_.getDimAction()),
       nextObservation(actor_.getDimObservation())
@@ -24,6 +26,8 @@ ARAgent::ARAgent(ARAgent const & other_)
       actorLearningRatePtr(other_.actorLearningRatePtr->clone()),
       lambda(other_.lambda),
       gradientActor(other_.gradientActor),
+      likelihoodScoreCache(other_.likelihoodScoreCache),
+      actorParameters(other_.actorParameters),
       observation(other_.observation),
       action(other_.action),
       reward(other_.reward),
@@ -39,13 +43,13 @@ std::unique_ptr<Agent> ARAgent::clone() const
 
 void ARAgent::receiveObservation(arma::vec const &observation_)
 {
-    observation = observation_;
+    convertTo(observation_, observation);
 }
 
-arma::vec ARAgent::getAction()
+void ARAgent::getAction(arma::vec &action_)
 {
-    action = actor.getAction(observation);
-    return action;
+    actor.getAction(observation, action);
+    convertTo(action, action_);
 }
 
 void ARAgent::receiveReward(double reward_)
@@ -55,7 +59,7 @@ void ARAgent::receiveReward(double reward_)
 
 void ARAgent::receiveNextObservation(arma::vec const &nextObservation_)
 {
-    nextObservation = nextObservation_;
+    convertTo(nextObservation_, nextObservation);
 }
 
 void ARAgent::learn()
@@ -66,9 +70,13 @@ void ARAgent::learn()
 
     // 2) Update actor
     double alphaActor = actorLearningRatePtr->get();
-    gradientActor = lambda * gradientActor + actor.likelihoodScore(observation, action);
+    actor.likelihoodScore(observation, action, likelihoodScoreCache);
+    gradientActor *= lambda;
+    gradientActor += likelihoodScoreCache;
     gradientActor /= arma::norm(gradientActor, 2);
-    actor.setParameters(actor.getParameters() + alphaActor * (reward - averageReward) * gradientActor);
+    actor.getParameters(actorParameters);
+    actorParameters += alphaActor * (reward - averageReward) * gradientActor;
+    actor.setParameters(actorParameters);
 }
 
 void ARAgent::newEpoch()
@@ -86,3 +94,26 @@ void ARAgent::reset()
     gradientActor.zeros();
 }
 
+void ARAgent::seed(unsigned int seed_)
+{
+    actor.seed(seed_);
+}
+
+void ARAgent::saveState(CheckpointWriter &writer_) const
+{
+    writer_.write(averageReward);
+    actor.saveState(writer_);
+    baselineLearningRatePtr->saveState(writer_);
+    actorLearningRatePtr->saveState(writer_);
+    writer_.write(gradientActor);
+}
+
+void ARAgent::loadState(CheckpointReader &reader_)
+{
+    reader_.read(averageReward);
+    actor.loadState(reader_);
+    baselineLearningRatePtr->loadState(reader_);
+    actorLearningRatePtr->loadState(reader_);
+    reader_.read(gradientActor);
+}
+
@@ -2,12 +2,13 @@
 #include <math.h>  /* sqrt */
 #include <iostream>
 
-ARACAgent::ARACAgent(StochasticActor const & actor_,
-                     Critic const & critic_,
-                     LearningRate const & baselineLearningRate_,
-                     LearningRate const & criticLearningRate_,
-                     LearningRate const & actorLearningRate_,
-                     double lambda_)
+template<class ActorT, class CriticT>
+BasicARACAgent<ActorT, CriticT>::BasicARACAgent(ActorT const & actor_,
+                                                CriticT const & critic_,
+                                                LearningRate const & baselineLearningRate_,
+                                                LearningRate const & criticLearningRate_,
+                                                LearningRate const & actorLearningRate_,
+                                                double lambda_)
     : actor(actor_),
       critic(critic_),
       averageReward(0.0),
@@ -17,14 +18,20 @@ ARACAgent::ARACAgent(StochasticActor const & actor_,
       lambda(lambda_),
       gradientCritic(critic.getDimParameters(), arma::fill::zeros),
       gradientActor(actor.getDimParameters(), arma::fill::zeros),
+      criticGradientCache(critic.getDimParameters()),
+      likelihoodScoreCache(actor.getDimParameters()),
+      criticParameters(critic.getDimParameters()),
+      actorParameters(actor.getDimParameters()),
       observation(actor_.getDimObservation()),
       action(actor_.getDimAction()),
-      nextObservation(actor_.getDimObservation())
+      nextObservation(actor_.getDimObservation()),
+      behaviourAction(false)
 {
     /* Nothing to do */
 }
 
-ARACAgent::ARACAgent(ARACAgent const & other_)
+template<class ActorT, class CriticT>
+BasicARACAgent<ActorT, CriticT>::BasicARACAgent(BasicARACAgent const & other_)
     : actor(other_.actor),
       critic(other_.critic),
       averageReward(other_.averageReward),
@@ -34,41 +41,60 @@ ARACAgent::ARACAgent(ARACAgent const & other_)
       lambda(other_.lambda),
       gradientActor(other_.gradientActor),
       gradientCritic(other_.gradientCritic),
+      criticGradientCache(other_.criticGradientCache),
+      likelihoodScoreCache(other_.likelihoodScoreCache),
+      criticParameters(other_.criticParameters),
+      actorParameters(other_.actorParameters),
       observation(other_.observation),
       action(other_.action),
       reward(other_.reward),
-      nextObservation(other_.nextObservation)
+      nextObservation(other_.nextObservation),
+      behaviourAction(other_.behaviourAction)
 {
     /* Nothing to do */
 }
 
-std::unique_ptr<Agent> ARACAgent::clone() const
+template<class ActorT, class CriticT>
+std::unique_ptr<Agent> BasicARACAgent<ActorT, CriticT>::clone() const
 {
-    return std::unique_ptr<Agent>(new ARACAgent(*this));
+    return std::unique_ptr<Agent>(new BasicARACAgent(*this));
 }
 
-void ARACAgent::receiveObservation(arma::vec const &observation_)
+template<class ActorT, class CriticT>
+void BasicARACAgent<ActorT, CriticT>::receiveObservation(arma::vec const &observation_)
 {
-    observation = observation_;
+    convertTo(observation_, observation);
 }
 
-arma::vec ARACAgent::getAction()
+template<class ActorT, class CriticT>
+void BasicARACAgent<ActorT, CriticT>::getAction(arma::vec &action_)
 {
-    action = actor.getAction(observation);
-    return action;
+    actor.getAction(observation, action);
+    convertTo(action, action_);
+    behaviourAction = false;
 }
 
-void ARACAgent::receiveReward(double reward_)
+template<class ActorT, class CriticT>
+void BasicARACAgent<ActorT, CriticT>::receiveBehaviourAction(arma::vec const &action_)
+{
+    convertTo(action_, action);
+    behaviourAction = true;
+}
+
+template<class ActorT, class CriticT>
+void BasicARACAgent<ActorT, CriticT>::receiveReward(double reward_)
 {
     reward = reward_;
 }
 
-void ARACAgent::receiveNextObservation(arma::vec const &nextObservation_)
+template<class ActorT, class CriticT>
+void BasicARACAgent<ActorT, CriticT>::receiveNextObservation(arma::vec const &nextObservation_)
 {
-    nextObservation = nextObservation_;
+    convertTo(nextObservation_, nextObservation);
 }
 
-void ARACAgent::learn()
+template<class ActorT, class CriticT>
+void BasicARACAgent<ActorT, CriticT>::learn()
 {
     // 1) Update baseline
     double alphaBaseline = baselineLearningRatePtr->get();
@@ -81,25 +107,38 @@ void ARACAgent::learn()
 
     // 3) Update critics
     double alphaCritic = criticLearningRatePtr->get();
-    gradientCritic = lambda * gradientCritic + critic.gradient(observation);
+    critic.gradient(observation, criticGradientCache);
+    gradientCritic *= lambda;
+    gradientCritic += criticGradientCache;
     gradientCritic /= arma::norm(gradientCritic, 2);
-    critic.setParameters(critic.getParameters() + alphaCritic * tdErr * gradientCritic);
+    critic.getParameters(criticParameters);
+    criticParameters += alphaCritic * tdErr * gradientCritic;
+    critic.setParameters(criticParameters);
 
     // 4) Update actor
     double alphaActor = actorLearningRatePtr->get();
-    gradientActor = lambda * gradientActor + actor.likelihoodScore(observation, action);
+    if (behaviourAction)
+        actor.behaviourLikelihoodScore(observation, action, likelihoodScoreCache);
+    else
+        actor.likelihoodScore(observation, action, likelihoodScoreCache);
+    gradientActor *= lambda;
+    gradientActor += likelihoodScoreCache;
     gradientActor /= arma::norm(gradientActor, 2);
-    actor.setParameters(actor.getParameters() + alphaActor * tdErr * gradientActor);
+    actor.getParameters(actorParameters);
+    actorParameters += alphaActor * tdErr * gradientActor;
+    actor.setParameters(actorParameters);
 }
 
-void ARACAgent::newEpoch()
+template<class ActorT, class CriticT>
+void BasicARACAgent<ActorT, CriticT>::newEpoch()
 {
     baselineLearningRatePtr->update();
     criticLearningRatePtr->update();
     actorLearningRatePtr->update();
 }
 
-void ARACAgent::reset()
+template<class ActorT, class CriticT>
+void BasicARACAgent<ActorT, CriticT>::reset()
 {
     actor.reset();
     critic.reset();
@@ -111,3 +150,49 @@ void ARACAgent::reset()
     gradientActor.zeros();
 }
 
+template<class ActorT, class CriticT>
+void BasicARACAgent<ActorT, CriticT>::resetTraces()
+{
+    gradientCritic.zeros();
+    gradientActor.zeros();
+}
+
+template<class ActorT, class CriticT>
+void BasicARACAgent<ActorT, CriticT>::seed(unsigned int seed_)
+{
+    actor.seed(seed_);
+}
+
+template<class ActorT, class CriticT>
+void BasicARACAgent<ActorT, CriticT>::saveState(CheckpointWriter &writer_) const
+{
+    writer_.write(averageReward);
+    critic.saveState(writer_);
+    actor.saveState(writer_);
+    baselineLearningRatePtr->saveState(writer_);
+    criticLearningRatePtr->saveState(writer_);
+    actorLearningRatePtr->saveState(writer_);
+    writer_.write(gradientCritic);
+    writer_.write(gradientActor);
+}
+
+template<class ActorT, class CriticT>
+void BasicARACAgent<ActorT, CriticT>::loadState(CheckpointReader &reader_)
+{
+    reader_.read(averageReward);
+    critic.loadState(reader_);
+    actor.loadState(reader_);
+    baselineLearningRatePtr->loadState(reader_);
+    criticLearningRatePtr->loadState(reader_);
+    actorLearningRatePtr->loadState(reader_);
+    reader_.read(gradientCritic);
+    reader_.read(gradientActor);
+}
+
+
+// Explicit instantiations
+template class BasicARACAgent<StochasticActor, Critic>;
+template class BasicARACAgent<BasicStochasticActor<BoltzmannPolicy>,
+                              BasicCritic<LinearRegressor>>;
+template class BasicARACAgent<BasicStochasticActor<PGPEPolicy>,
+                              BasicCritic<LinearRegressor>>;
@@ -22,9 +22,11 @@ ARRSACAgent::ARRSACAgent(StochasticActor const & actor_,
       gradientCriticU(criticU.getDimParameters(), arma::fill::zeros),
       gradientActor(actor.getDimParameters(), arma::fill::zeros),
       gradientSharpe(actor.getDimParameters(), arma::fill::zeros),
+      actorParameters(actor.getDimParameters()),
       observation(actor_.getDimObservation()),
       action(actor_.getDimAction()),
-      nextObservation(actor_.getDimObservation())
+      nextObservation(actor_.getDimObservation()),
+      behaviourAction(false)
 {
     /* Nothing to do */
 }
@@ -43,11 +45,13 @@ ARRSACAgent::ARRSACAgent(ARRSACAgent const &other_)
       gradientCriticU(other_.gradientCriticU),
       gradientActor(other_.gradientActor),
       gradientSharpe(other_.gradientSharpe),
+      actorParameters(other_.actorParameters),
       observation(other_.observation),
       action(other_.action),
       nextObservation(other_.nextObservation),
       reward(other_.reward),
-      rewardSquared(other_.rewardSquared)
+      rewardSquared(other_.rewardSquared),
+      behaviourAction(other_.behaviourAction)
 {
     /* Nothing to do */
 }
@@ -60,13 +64,20 @@ std::unique_ptr<Agent> ARRSACAgent::clone() const
 
 void ARRSACAgent::receiveObservation(arma::vec const &observation_)
 {
-    observation = observation_;
+    convertTo(observation_, observation);
 }
 
-arma::vec ARRSACAgent::getAction()
+void ARRSACAgent::getAction(arma::vec &action_)
 {
-    action = actor.getAction(observation);
-    return action;
+    actor.getAction(observation, action);
+    convertTo(action, action_);
+    behaviourAction = false;
+}
+
+void ARRSACAgent::receiveBehaviourAction(arma::vec const &action_)
+{
+    convertTo(action_, action);
+    behaviourAction = true;
 }
 
 void ARRSACAgent::receiveReward(double reward_)
@@ -77,7 +88,7 @@ void ARRSACAgent::receiveReward(double reward_)
 
 void ARRSACAgent::receiveNextObservation(arma::vec const &nextObservation_)
 {
-    nextObservation = nextObservation_;
+    convertTo(nextObservation_, nextObservation);
 }
 
 void ARRSACAgent::learn()
@@ -110,13 +121,19 @@ void ARRSACAgent::learn()
 //                             (var * sqrtVar);
 
 
-    gradientActor = actor.likelihoodScore(observation, action);
+    if (behaviourAction)
+        actor.behaviourLikelihoodScore(observation, action, gradientActor);
+    else
+        actor.likelihoodScore(observation, action, gradientActor);
     double coeffGradientSR = (averageSquareReward * (reward - averageReward) - 0.5 * averageReward * (rewardSquared - averageSquareReward)) /
                              (var * sqrtVar);
 
-    gradientSharpe = lambda * gradientSharpe + coeffGradientSR * gradientActor;
+    gradientSharpe *= lambda;
+    gradientSharpe += coeffGradientSR * gradientActor;
     // gradientSharpe /= arma::norm(gradientSharpe, 2);
-    actor.setParameters(actor.getParameters() + alphaActor * gradientSharpe);
+    actor.getParameters(actorParameters);
+    actorParameters += alphaActor * gradientSharpe;
+    actor.setParameters(actorParameters);
 }
 
 void ARRSACAgent::newEpoch()
@@ -141,3 +158,43 @@ void ARRSACAgent::reset()
     gradientCriticV.zeros();
 }
 
+void ARRSACAgent::resetTraces()
+{
+    gradientSharpe.zeros();
+}
+
+void ARRSACAgent::seed(unsigned int seed_)
+{
+    actor.seed(seed_);
+}
+
+void ARRSACAgent::saveState(CheckpointWriter &writer_) const
+{
+    writer_.write(averageReward);
+    writer_.write(averageSquareReward);
+    criticV.saveState(writer_);
+    criticU.saveState(writer_);
+    actor.saveState(writer_);
+    baselineLearningRatePtr->saveState(writer_);
+    criticLearningRatePtr->saveState(writer_);
+    actorLearningRatePtr->saveState(writer_);
+    writer_.write(gradientCriticV);
+    writer_.write(gradientCriticU);
+    writer_.write(gradientSharpe);
+}
+
+void ARRSACAgent::loadState(CheckpointReader &reader_)
+{
+    reader_.read(averageReward);
+    reader_.read(averageSquareReward);
+    criticV.loadState(reader_);
+    criticU.loadState(reader_);
+    actor.loadState(reader_);
+    baselineLearningRatePtr->loadState(reader_);
+    criticLearningRatePtr->loadState(reader_);
+    actorLearningRatePtr->loadState(reader_);
+    reader_.read(gradientCriticV);
+    reader_.read(gradientCriticU);
+    reader_.read(gradientSharpe);
+}
+
@@ -1,5 +1,23 @@
 #include "thesis/AssetAllocationExperiment.h"
+#include "thesis/ThreadPool.h"
+#include "thesis/AracAgent.h"
+#include "thesis/NpgpeAgent.h"
+#include "thesis/FixedDimensions.h"
+#include <algorithm>
 #include <fstream>
+#include <functional>
+#include <future>
+#include <iomanip>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+//! Mutex serializing the console output of concurrent experiments
+static std::mutex consoleMutex;
+
+//! Number of backtest records buffered before a background write
+static const size_t backtestBufferRecords = 1024;
 
 AssetAllocationExperiment::AssetAllocationExperiment(AssetAllocationTask const &task_,
                                                      Agent const &agent_,
@@ -8,20 +26,30 @@ AssetAllocationExperiment::AssetAllocationExperiment(AssetAllocationTask const &
                                                      size_t const &numTrainingSteps_,
                                                      size_t const &numTestSteps_,
                                                      std::string const &outputDir_,
-                                                     std::string const &debugDir_)
+                                                     std::string const &debugDir_,
+                                                     size_t const &numThreads_,
+                                                     unsigned int seed_,
+                                                     BacktestLog::Format backtestFormat_)
     : Experiment(task_, agent_),
       numExperiments(numExperiments_),
       numEpochs(numEpochs_),
       numTrainingSteps(numTrainingSteps_),
       numTestSteps(numTestSteps_),
-      blog(taskPtr->getDimAction(), taskPtr->getDimAction(), numTestSteps),
+      numThreads(numThreads_),
+      seed(seed_),
+      blog(taskPtr->getDimAction(), taskPtr->getDimAction(), backtestBufferRecords, backtestFormat_),
       observationCache(taskPtr->getObservation()),
       actionCache(taskPtr->getDimAction()),
       rewardCache(0.0),
+      stateCache(taskPtr->getDimAction()),
       outputDir(outputDir_),
-      debugDir(debugDir_)
+      debugDir(debugDir_),
+      checkpointInterval(0),
+      poolPtr(nullptr),
+      numActorThreads(0),
+      actorBatchSize(64)
 {
-    /* Nothing to do */
+    selectInteractionLoop();
 }
 
 AssetAllocationExperiment::AssetAllocationExperiment(AssetAllocationExperiment const &other_)
@@ -30,12 +58,23 @@ AssetAllocationExperiment::AssetAllocationExperiment(AssetAllocationExperiment c
       numEpochs(other_.numEpochs),
       numTrainingSteps(other_.numTrainingSteps),
       numTestSteps(other_.numTestSteps),
-      blog(taskPtr->getDimAction(), taskPtr->getDimAction(), numTestSteps),
+      numThreads(other_.numThreads),
+      seed(other_.seed),
+      blog(taskPtr->getDimAction(), taskPtr->getDimAction(), backtestBufferRecords, other_.blog.getFormat()),
       observationCache(taskPtr->getObservation()),
       actionCache(taskPtr->getDimAction()),
       rewardCache(0.0),
+      stateCache(taskPtr->getDimAction()),
       outputDir(other_.outputDir),
-      debugDir(other_.debugDir)
+      debugDir(other_.debugDir),
+      checkpointDir(other_.checkpointDir),
+      checkpointInterval(other_.checkpointInterval),
+      warmStartFilename(other_.warmStartFilename),
+      poolPtr(other_.poolPtr),
+      numActorThreads(other_.numActorThreads),
+      actorBatchSize(other_.actorBatchSize),
+      trainingStepsPtr(other_.trainingStepsPtr),
+      testStepPtr(other_.testStepPtr)
 {
     /* Nothing to do */
 }
@@ -45,96 +84,556 @@ std::unique_ptr<Experiment> AssetAllocationExperiment::clone() const
     return std::unique_ptr<Experiment>(new AssetAllocationExperiment(*this));
 }
 
-void AssetAllocationExperiment::oneInteraction()
+void AssetAllocationExperiment::setCheckpointing(std::string const &checkpointDir_,
+                                                 size_t checkpointInterval_)
+{
+    checkpointDir = checkpointDir_;
+    checkpointInterval = checkpointInterval_;
+}
+
+void AssetAllocationExperiment::setWarmStart(std::string const &filename_)
+{
+    warmStartFilename = filename_;
+}
+
+void AssetAllocationExperiment::setThreadPool(WorkStealingPool *pool_)
+{
+    poolPtr = pool_;
+}
+
+void AssetAllocationExperiment::setActorLearner(size_t numActorThreads_,
+                                                size_t actorBatchSize_)
+{
+    if (numActorThreads_ > 0)
+    {
+        ActorLearnerAgent const *agent = dynamic_cast<ActorLearnerAgent const *>(agentPtr.get());
+        if (!agent || !agent->supportsBehaviourActions())
+            throw std::invalid_argument("AssetAllocationExperiment: the agent does not support asynchronous training");
+    }
+    numActorThreads = numActorThreads_;
+    actorBatchSize = actorBatchSize_;
+}
+
+void AssetAllocationExperiment::selectInteractionLoop()
+{
+    if (useInteractionLoop<BoltzmannARACAgent>() ||
+        useInteractionLoop<PGPEARACAgent>() ||
+        useInteractionLoop<BinaryNPGPEAgent>())
+        return;
+#ifdef THESIS_FIXED_DAYS_OBSERVED
+    if (useInteractionLoop<FixedNPGPEAgent>())
+        return;
+#endif
+    useInteractionLoop<Agent>();
+}
+
+template<class AgentT>
+bool AssetAllocationExperiment::useInteractionLoop()
+{
+    if (!dynamic_cast<AgentT *>(agentPtr.get()))
+        return false;
+    trainingStepsPtr = &AssetAllocationExperiment::trainingSteps<AgentT>;
+    testStepPtr = &AssetAllocationExperiment::testStep<AgentT>;
+    return true;
+}
+
+template<class AgentT>
+void AssetAllocationExperiment::oneInteraction(AssetAllocationTask &task, AgentT &agent)
 {
     // 1) Get observation
-    agentPtr->receiveObservation(observationCache);
+    {
+        THESIS_TIME_PHASE(epochProfile, Observation);
+        agent.receiveObservation(observationCache);
+    }
 
     // 2) Perform action
-    actionCache = agentPtr->getAction();
-    taskPtr->performAction(actionCache);
+    {
+        THESIS_TIME_PHASE(epochProfile, Action);
+        agent.getAction(actionCache);
+    }
 
     // 3) Receive reward
-    rewardCache = taskPtr->getReward();
-    agentPtr->receiveReward(rewardCache);
+    {
+        THESIS_TIME_PHASE(epochProfile, Reward);
+        task.performAction(actionCache);
+        rewardCache = task.getReward();
+        agent.receiveReward(rewardCache);
+
+        // 3b) Receive the rewards of the candidate actions of a population agent
+        if (agent.getPopulationSize() > 1)
+        {
+            agent.getPopulationActions(populationActionsCache);
+            task.getRewards(populationActionsCache, populationRewardsCache);
+            agent.receivePopulationRewards(populationRewardsCache);
+        }
+    }
 
     // 4) Receive next observation
-    observationCache = taskPtr->getObservation();
-    agentPtr->receiveNextObservation(observationCache);
+    {
+        THESIS_TIME_PHASE(epochProfile, Observation);
+        task.getObservation(observationCache);
+        agent.receiveNextObservation(observationCache);
+    }
 
     // 5) Dump results in statistics gatherer
+    THESIS_TIME_PHASE(epochProfile, Stats);
     experimentStats.dumpOneResult(rewardCache);
 }
 
 void AssetAllocationExperiment::run()
 {
-    // Perform numExperiments independent experiments
-    for (size_t exp = 0; exp < numExperiments; ++exp)
+    // Each experiment runs on a copy of this experiment, which clones the
+    // prototype task and agent and owns its backtest log and statistics.
+    runJobs(numExperiments, [this](size_t exp)
     {
-        // Reset backtest log and agent
-        agentPtr->reset();
-        blog.reset();
+        AssetAllocationExperiment experiment(*this);
+        experiment.runExperiment(exp);
+    });
+}
 
-        // Open debugging file
-        std::ostringstream stringStream;
-        stringStream << debugDir << "experiment" << exp << ".csv";
-        std::ofstream debugFile;
-        debugFile.open(stringStream.str());
-        debugFile << "epoch,average,stdev,sharpe,\n";
+void AssetAllocationExperiment::runWalkForward()
+{
+    // Rolling windows over the full history. The test periods of consecutive
+    // windows are adjacent, the last one ends before the final day, which is
+    // observed after the last test step.
+    size_t const numDays = getTask().getNumDays();
+    size_t const windowLength = getTask().getNumDaysObserved() + numTrainingSteps + numTestSteps;
+    if (numTestSteps == 0 || numDays < windowLength + 1)
+        throw std::invalid_argument("AssetAllocationExperiment::runWalkForward: "
+                                    "the history is shorter than one window");
+    size_t const numWindows = (numDays - 1 - windowLength) / numTestSteps + 1;
 
-        // Training
-        for (size_t epoch = 0; epoch < numEpochs; ++epoch)
+    // Every (experiment, window) pair is an independent job
+    std::vector<std::vector<WindowBacktest>> backtests(numExperiments,
+                                                       std::vector<WindowBacktest>(numWindows));
+    runJobs(numExperiments * numWindows, [this, numWindows, &backtests](size_t job)
+    {
+        size_t const exp = job / numWindows;
+        size_t const window = job % numWindows;
+        AssetAllocationExperiment experiment(*this);
+        experiment.runWindow(exp, window, backtests[exp][window]);
+    });
+
+    // Stitch the out-of-sample periods into one continuous backtest
+    for (size_t exp = 0; exp < numExperiments; ++exp)
+    {
+        std::ostringstream stringStreamBacktest;
+        stringStreamBacktest << outputDir << "experiment" << exp << blog.getFileExtension();
+        blog.open(stringStreamBacktest.str());
+        for (WindowBacktest &backtest : backtests[exp])
         {
-            // Reset task
-            taskPtr->reset();
-            experimentStats.reset();
+            for (size_t step = 0; step < numTestSteps; ++step)
+                blog.insertRecord(backtest.states.unsafe_col(step),
+                                  backtest.actions.unsafe_col(step),
+                                  backtest.rewards(step));
+            backtest = WindowBacktest();
+        }
+        closeBacktest(exp);
+    }
+}
 
-            // Signal to agent that a new epoch has started
-            agentPtr->newEpoch();
+void AssetAllocationExperiment::runJobs(size_t numJobs,
+                                        std::function<void(size_t)> const &job) const
+{
+    // Shared pool
+    if (poolPtr)
+    {
+        poolPtr->parallelFor(numJobs, job);
+        return;
+    }
 
-            for (size_t step = 0; step < numTrainingSteps; ++step)
-            {
-                // Interaction between the task and the agent
-                oneInteraction();
+    // Serial execution
+    size_t numWorkers = (numThreads > 0) ? numThreads : ThreadPool::hardwareConcurrency();
+    numWorkers = std::min(numWorkers, numJobs);
+    if (numWorkers <= 1)
+    {
+        for (size_t idx = 0; idx < numJobs; ++idx)
+            job(idx);
+        return;
+    }
 
-                // Learning step
-                agentPtr->learn();
-            }
+    // Parallel execution
+    ThreadPool pool(numWorkers);
+    std::vector<std::future<void>> results;
+    results.reserve(numJobs);
+    for (size_t idx = 0; idx < numJobs; ++idx)
+        results.push_back(pool.submit(std::bind(job, idx)));
+
+    // Wait for all the jobs and rethrow the first failure, if any
+    for (std::future<void> &result : results)
+        result.wait();
+    for (std::future<void> &result : results)
+        result.get();
+}
+
+unsigned int AssetAllocationExperiment::experimentSeed(size_t exp) const
+{
+    std::seed_seq sequence {seed, static_cast<unsigned int>(exp)};
+    std::vector<unsigned int> experimentSeed(1);
+    sequence.generate(experimentSeed.begin(), experimentSeed.end());
+    return experimentSeed[0];
+}
+
+unsigned int AssetAllocationExperiment::windowSeed(size_t exp, size_t window) const
+{
+    std::seed_seq sequence {seed, static_cast<unsigned int>(exp), static_cast<unsigned int>(window)};
+    std::vector<unsigned int> windowSeed(1);
+    sequence.generate(windowSeed.begin(), windowSeed.end());
+    return windowSeed[0];
+}
+
+AssetAllocationTask &AssetAllocationExperiment::getTask()
+{
+    // The prototype task passed to the constructor is an AssetAllocationTask
+    return static_cast<AssetAllocationTask &>(*taskPtr);
+}
+
+void AssetAllocationExperiment::runExperiment(size_t exp)
+{
+    // Skip the experiments completed by a previous run
+    std::ostringstream stringStream;
+    stringStream << "Experiment #" << exp;
+    std::ostringstream stringStreamRun;
+    stringStreamRun << "experiment" << exp;
+    std::string const checkpointFilename = checkpointPath(stringStreamRun.str());
+    if (isCompleted(checkpointFilename, experimentSeed(exp)))
+    {
+        std::lock_guard<std::mutex> lock(consoleMutex);
+        std::cout << stringStream.str() << " - completed by a previous run" << std::endl;
+        return;
+    }
+
+    // Path of the market, if simulated
+    taskPtr->seed(experimentSeed(exp));
+
+    // Training
+    std::ostringstream stringStreamDebug;
+    stringStreamDebug << debugDir << "experiment" << exp << ".csv";
+    train(experimentSeed(exp), stringStream.str(), stringStreamDebug.str(), checkpointFilename);
+
+    // Backtest, streamed to the output file
+    std::ostringstream stringStreamBacktest;
+    stringStreamBacktest << outputDir << "experiment" << exp << blog.getFileExtension();
+    blog.open(stringStreamBacktest.str());
+    backtestSteps(numTestSteps);
+    {
+        THESIS_TIME_PHASE(epochProfile, Logging);
+        closeBacktest(exp);
+    }
+    closeProfile();
+
+    // Mark the experiment as completed
+    if (!checkpointFilename.empty())
+        saveCheckpoint(checkpointFilename, experimentSeed(exp), numEpochs);
+}
+
+void AssetAllocationExperiment::closeBacktest(size_t exp)
+{
+    blog.close();
 
-            // Print convergence summary
-            if (epoch % static_cast<int>(numEpochs / 50) == 0)
+    // Summary of the backtest statistics
+    std::ostringstream stringStreamSummary;
+    stringStreamSummary << outputDir << "experiment" << exp << "_summary.csv";
+    std::ofstream summaryFile(stringStreamSummary.str());
+    if (!summaryFile)
+        throw std::runtime_error("Cannot open backtest summary " + stringStreamSummary.str());
+    std::vector<double> const stats = blog.getStatistics().getStatistics()[0];
+    summaryFile << StatisticsBacktest::names() << "\n";
+    summaryFile << std::scientific << std::setprecision(16);
+    for (size_t i = 0; i < stats.size(); ++i)
+        summaryFile << stats[i] << ((i + 1 < stats.size()) ? "," : "\n");
+}
+
+void AssetAllocationExperiment::runWindow(size_t exp,
+                                          size_t window,
+                                          WindowBacktest &backtest)
+{
+    // Restrict the task to the window of the experiment path
+    size_t const startDate = window * numTestSteps;
+    size_t const windowLength = getTask().getNumDaysObserved() + numTrainingSteps + numTestSteps;
+    taskPtr->seed(experimentSeed(exp));
+    getTask().setEvaluationInterval(startDate, startDate + windowLength - 1);
+
+    // Training
+    std::ostringstream stringStream;
+    stringStream << "Experiment #" << exp << " - Window #" << window;
+    std::ostringstream stringStreamDebug;
+    stringStreamDebug << debugDir << "experiment" << exp << "_window" << window << ".csv";
+    std::ostringstream stringStreamRun;
+    stringStreamRun << "experiment" << exp << "_window" << window;
+    train(windowSeed(exp, window), stringStream.str(), stringStreamDebug.str(),
+          checkpointPath(stringStreamRun.str()));
+
+    // Out-of-sample backtest, kept in memory until the windows are stitched
+    backtest.states.set_size(stateCache.n_elem, numTestSteps);
+    backtest.actions.set_size(actionCache.n_elem, numTestSteps);
+    backtest.rewards.set_size(numTestSteps);
+    for (size_t step = 0; step < numTestSteps; ++step)
+    {
+        (this->*testStepPtr)();
+        backtest.states.col(step) = stateCache;
+        backtest.actions.col(step) = actionCache;
+        backtest.rewards(step) = rewardCache;
+    }
+    closeProfile();
+}
+
+void AssetAllocationExperiment::train(unsigned int trainingSeed,
+                                      std::string const &name,
+                                      std::string const &debugFilename,
+                                      std::string const &checkpointFilename)
+{
+    // Seed random number generators. The armadillo generator, used to
+    // initialize the parameters, is local to the calling thread.
+    arma::arma_rng::set_seed(trainingSeed);
+    agentPtr->seed(trainingSeed);
+
+    // Reset agent, or start from a trained one with fresh random streams
+    agentPtr->reset();
+    if (!warmStartFilename.empty())
+    {
+        // Skip the header and the observation of the run that wrote it
+        CheckpointReader reader(warmStartFilename);
+        uint64_t header[4];
+        for (uint64_t &field : header)
+            reader.read(field);
+        arma::vec observation(observationCache.n_elem);
+        reader.read(observation);
+        agentPtr->loadState(reader);
+        agentPtr->seed(trainingSeed);
+    }
+
+    // Resume from the last snapshot, if any
+    size_t firstEpoch = 0;
+    if (!checkpointFilename.empty() && CheckpointReader::exists(checkpointFilename))
+        firstEpoch = loadCheckpoint(checkpointFilename, trainingSeed);
+
+    // Open debugging file, appending to the lines of the interrupted run
+    std::ofstream debugFile;
+    if (firstEpoch > 0)
+        debugFile.open(debugFilename, std::ios::app);
+    else
+    {
+        debugFile.open(debugFilename);
+        debugFile << "epoch,average,stdev,sharpe,\n";
+    }
+
+#ifdef THESIS_PROFILING
+    // Open per-phase timing file, next to the debugging file
+    std::string profileFilename = debugFilename;
+    if (profileFilename.size() >= 4 && profileFilename.compare(profileFilename.size() - 4, 4, ".csv") == 0)
+        profileFilename.erase(profileFilename.size() - 4);
+    profileFilename += "_profile.csv";
+    epochProfile.reset();
+    runProfile.reset();
+    if (firstEpoch > 0)
+        profileFile.open(profileFilename, std::ios::app);
+    else
+    {
+        profileFile.open(profileFilename);
+        profileFile << "epoch," << PhaseProfile::header() << "\n";
+    }
+#endif
+
+    // Actor threads of the asynchronous training, if any
+    std::unique_ptr<AsyncActorLearner> actorLearnerPtr;
+    if (numActorThreads > 0)
+    {
+        actorLearnerPtr.reset(new AsyncActorLearner(numActorThreads, actorBatchSize));
+        actorLearnerPtr->seed(trainingSeed);
+    }
+
+    // Training
+    for (size_t epoch = firstEpoch; epoch < numEpochs; ++epoch)
+    {
+        // Interaction and learning steps
+        trainingEpoch(actorLearnerPtr.get());
+
+        // Print convergence summary
+        if (epoch % static_cast<int>(numEpochs / 50) == 0)
+        {
+            THESIS_TIME_PHASE(epochProfile, Logging);
+            std::vector<std::vector<double>> stats = experimentStats.getStatistics();
             {
-                std::vector<std::vector<double>> stats = experimentStats.getStatistics();
-                std::cout << "Experiment #" << exp
+                std::lock_guard<std::mutex> lock(consoleMutex);
+                std::cout << name
                           << " - Epoch #" << epoch
                           << " - Average: " << stats[0][0]
                           << " - Standard Deviation: " << stats[0][1]
                           << " - Sharpe Ratio: " << stats[0][2] << std::endl;
-
-                debugFile << epoch << "," << stats[0][0] << "," << stats[0][1]
-                          << "," << stats[0][2] << ",\n";
             }
+
+            debugFile << epoch << "," << stats[0][0] << "," << stats[0][1]
+                      << "," << stats[0][2] << ",\n";
         }
-        debugFile.close();
 
-        // Backtest
-        for (size_t step = 0; step < numTestSteps; ++step)
+        // Snapshot. The last epoch is always replayed on resume, so that the
+        // backtest starts from the task state reached by the training.
+        if (!checkpointFilename.empty() && (epoch + 1) % checkpointInterval == 0 &&
+            epoch + 1 < numEpochs)
         {
-            // Interaction between the task and the agent
-            oneInteraction();
+            THESIS_TIME_PHASE(epochProfile, Checkpoint);
+            debugFile.flush();
+            saveCheckpoint(checkpointFilename, trainingSeed, epoch + 1);
+        }
 
-            // Learning step
-            agentPtr->learn();
+#ifdef THESIS_PROFILING
+        // Per-phase timing of the epoch
+        profileFile << epoch << ",";
+        epochProfile.write(profileFile);
+        profileFile << "\n";
+        runProfile.merge(epochProfile);
+        epochProfile.reset();
+#endif
+    }
+    debugFile.close();
+}
 
-            // Log (action, reward) tuple
-            arma::vec stateCache =
-                observationCache.rows(observationCache.size() - 2 * taskPtr->getDimAction(),
-                                      observationCache.size() - taskPtr->getDimAction() - 1);
-            blog.insertRecord(stateCache, actionCache, rewardCache);
-        }
+void AssetAllocationExperiment::trainingEpoch()
+{
+    trainingEpoch(nullptr);
+}
 
-        std::ostringstream stringStreamBacktest;
-        stringStreamBacktest << outputDir << "experiment" << exp << ".csv";
-        blog.save(stringStreamBacktest.str());
+void AssetAllocationExperiment::trainingEpoch(AsyncActorLearner *actorLearner)
+{
+    // Reset task
+    taskPtr->reset();
+    experimentStats.reset();
+
+    // Signal to agent that a new epoch has started
+    agentPtr->newEpoch();
+
+    // Interaction and learning steps
+    if (actorLearner)
+    {
+        // The agent type was checked by setActorLearner
+        THESIS_TIME_PHASE(epochProfile, Learn);
+        actorLearner->runEpoch(getTask(),
+                               static_cast<ActorLearnerAgent &>(*agentPtr),
+                               numTrainingSteps,
+                               [this](double reward_)
+                               { experimentStats.dumpOneResult(reward_); });
+        getTask().getObservation(observationCache);
+    }
+    else
+        (this->*trainingStepsPtr)();
+}
+
+void AssetAllocationExperiment::backtestSteps(size_t numSteps_)
+{
+    for (size_t step = 0; step < numSteps_; ++step)
+    {
+        (this->*testStepPtr)();
+        THESIS_TIME_PHASE(epochProfile, Logging);
+        blog.insertRecord(stateCache, actionCache, rewardCache);
+    }
+}
+
+void AssetAllocationExperiment::closeProfile()
+{
+#ifdef THESIS_PROFILING
+    // Per-phase timing of the backtest and of the whole run
+    profileFile << "backtest,";
+    epochProfile.write(profileFile);
+    profileFile << "\n";
+    runProfile.merge(epochProfile);
+    epochProfile.reset();
+    profileFile << "total,";
+    runProfile.write(profileFile);
+    profileFile << "\n";
+    profileFile.close();
+#endif
+}
+
+std::string AssetAllocationExperiment::checkpointPath(std::string const &runName) const
+{
+    if (checkpointInterval == 0)
+        return std::string();
+    return checkpointDir + runName + ".ckpt";
+}
+
+void AssetAllocationExperiment::saveCheckpoint(std::string const &filename,
+                                               unsigned int trainingSeed,
+                                               size_t epochsCompleted) const
+{
+    CheckpointWriter writer(filename);
+    writer.write(static_cast<uint64_t>(trainingSeed));
+    writer.write(static_cast<uint64_t>(numEpochs));
+    writer.write(static_cast<uint64_t>(numTrainingSteps));
+    writer.write(static_cast<uint64_t>(epochsCompleted));
+    writer.write(observationCache);
+    agentPtr->saveState(writer);
+    writer.commit();
+}
+
+size_t AssetAllocationExperiment::readCheckpointHeader(CheckpointReader &reader,
+                                                       unsigned int trainingSeed) const
+{
+    uint64_t storedSeed = 0, storedEpochs = 0, storedSteps = 0, epochsCompleted = 0;
+    reader.read(storedSeed);
+    reader.read(storedEpochs);
+    reader.read(storedSteps);
+    reader.read(epochsCompleted);
+    if (storedSeed != trainingSeed || storedEpochs != numEpochs ||
+        storedSteps != numTrainingSteps || epochsCompleted > numEpochs)
+        throw std::runtime_error("AssetAllocationExperiment: the checkpoint was "
+                                 "written by a run with different parameters");
+    return epochsCompleted;
+}
+
+bool AssetAllocationExperiment::isCompleted(std::string const &filename,
+                                            unsigned int trainingSeed) const
+{
+    if (filename.empty() || !CheckpointReader::exists(filename))
+        return false;
+    CheckpointReader reader(filename);
+    return readCheckpointHeader(reader, trainingSeed) == numEpochs;
+}
+
+size_t AssetAllocationExperiment::loadCheckpoint(std::string const &filename,
+                                                 unsigned int trainingSeed)
+{
+    CheckpointReader reader(filename);
+    size_t const epochsCompleted = readCheckpointHeader(reader, trainingSeed);
+    reader.read(observationCache);
+    agentPtr->loadState(reader);
+    return epochsCompleted;
+}
+
+template<class AgentT>
+void AssetAllocationExperiment::trainingSteps()
+{
+    // The agent type was checked by selectInteractionLoop
+    AssetAllocationTask &task = getTask();
+    AgentT &agent = static_cast<AgentT &>(*agentPtr);
+    for (size_t step = 0; step < numTrainingSteps; ++step)
+    {
+        // Interaction between the task and the agent
+        oneInteraction(task, agent);
+
+        // Learning step
+        THESIS_TIME_PHASE(epochProfile, Learn);
+        agent.learn();
     }
 }
+
+template<class AgentT>
+void AssetAllocationExperiment::testStep()
+{
+    // Interaction between the task and the agent
+    AssetAllocationTask &task = getTask();
+    AgentT &agent = static_cast<AgentT &>(*agentPtr);
+    oneInteraction(task, agent);
+
+    // Learning step
+    {
+        THESIS_TIME_PHASE(epochProfile, Learn);
+        agent.learn();
+    }
+
+    // Log (action, reward) tuple
+    THESIS_TIME_PHASE(epochProfile, Logging);
+    stateCache =
+        observationCache.rows(observationCache.size() - 2 * task.getDimAction(),
+                              observationCache.size() - task.getDimAction() - 1);
+}
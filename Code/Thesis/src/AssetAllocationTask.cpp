@@ -1,28 +1,31 @@
 #include <thesis/AssetAllocationTask.h>
+#include <thesis/PortfolioReturn.h>
 #include <math.h>      /* log */
-#include <limits>      /* numeric_limits */
+#include <stdexcept>   /* std::invalid_argument */
 
 void AssetAllocationTask::initializeStatesCache()
 {
-	// Initialize past market states
-	arma::vec proxyAction(environmentPtr->getDimAction());
+	// Initialize past market states. The market ignores the allocation, the
+	// workspace of performAction is passed to avoid a temporary per reset.
+	pastStates.clear();
 	for(size_t i = 0; i < numDaysObserved; ++i)
 	{
         // Get market state
-        pastStates.rows(i * dimState, (i + 1) * dimState - 1) =
-            environmentPtr->getState();
+        environmentPtr->getState(currentState);
+        pastStates.push(currentState);
 
 		// Move to the next time step
-		environmentPtr->performAction(proxyAction);
+		environmentPtr->performAction(newAllocation);
 	}
 
 	// Initialize current market state
-    currentState = environmentPtr->getState();
+    environmentPtr->getState(currentState);
 }
 
 void AssetAllocationTask::initializeAllocationCache()
 {
 	currentAllocation.zeros();
+	previousAllocation.zeros();
 }
 
 AssetAllocationTask::AssetAllocationTask (MarketEnvironment const & market_,
@@ -36,22 +39,22 @@ AssetAllocationTask::AssetAllocationTask (MarketEnvironment const & market_,
 	  deltaP(deltaP_),
 	  deltaF(deltaF_),
 	  deltaS(deltaS_),
-	  numDaysObserved(numDaysObserved_)
+	  numDaysObserved(numDaysObserved_),
+	  dimState(market_.getDimState()),
+	  pastStates(dimState, numDaysObserved)
 {
-	// Dimensions of observation and action spaces
-	dimState = environmentPtr->getDimState();
-	dimPastStates = numDaysObserved * dimState;
-	dimObservation = 1 + dimPastStates + dimState + environmentPtr->getDimAction();
-
-	// Initialize state cache variables
-	pastStates.set_size(dimPastStates);
-	currentState.set_size(dimState);
-	initializeStatesCache();
+	// Dimension of observation space
+	dimObservation = pastStates.getDimObservation(environmentPtr->getDimAction());
 
 	// Initialize allocation cache variables
 	currentAllocation.set_size(environmentPtr->getDimAction());
 	newAllocation.set_size(environmentPtr->getDimAction());
+	previousAllocation.set_size(environmentPtr->getDimAction());
 	initializeAllocationCache();
+
+	// Initialize state cache variables
+	currentState.set_size(dimState);
+	initializeStatesCache();
 }
 
 AssetAllocationTask::AssetAllocationTask(AssetAllocationTask const &other_)
@@ -62,12 +65,12 @@ AssetAllocationTask::AssetAllocationTask(AssetAllocationTask const &other_)
       deltaS(other_.deltaS),
       numDaysObserved(other_.numDaysObserved),
       dimState(other_.dimState),
-      dimPastStates(other_.dimPastStates),
       dimObservation(other_.dimObservation),
       pastStates(other_.pastStates),
       currentState(other_.currentState),
       currentAllocation(other_.currentAllocation),
-      newAllocation(other_.newAllocation)
+      newAllocation(other_.newAllocation),
+      previousAllocation(other_.previousAllocation)
 {
     /* Nothing to do */
 }
@@ -77,27 +80,17 @@ std::unique_ptr<Task> AssetAllocationTask::clone() const
     return std::unique_ptr<Task>(new AssetAllocationTask(*this));
 }
 
-arma::vec AssetAllocationTask::getObservation () const
+void AssetAllocationTask::getObservation (arma::vec &observation_) const
 {
-	arma::vec observation(dimObservation);
-
-    // Risk-free rate
-    observation(0) = riskFreeRate;
-
-	// Past states
-	observation.rows(1, dimPastStates) = pastStates;
-
-	// Current state
-	observation.rows(dimPastStates + 1, dimPastStates + dimState) = currentState;
-
-	// Current allocation
-	observation.rows(dimPastStates + dimState + 1, observation.size() - 1) = currentAllocation;
-
-	return observation;
+	pastStates.getObservations(riskFreeRate, currentState, currentAllocation, observation_);
 }
 
 void AssetAllocationTask::performAction (arma::vec const &action)
 {
+	// The reward kernel reads one weight per risky asset
+	if (action.n_elem != dimState)
+		throw std::invalid_argument("AssetAllocationTask: wrong action size");
+
 	// Cache new allocation
 	newAllocation = action;
 
@@ -108,26 +101,41 @@ void AssetAllocationTask::performAction (arma::vec const &action)
 double AssetAllocationTask::getReward () const
 {
 	// Update past states with current state
-	if (numDaysObserved > 1)
-        pastStates.rows(0, (numDaysObserved - 1) * dimState - 1) =
-            pastStates.rows(dimState, pastStates.size() - 1);
-	pastStates.rows((numDaysObserved - 1) * dimState, pastStates.size() - 1) =
-		currentState;
+	pastStates.push(currentState);
 
 	// Observe new market state
-	currentState = environmentPtr->getState();
+	environmentPtr->getState(currentState);
 
-	// Compute portfolio simple return
-	double portfolioSimpleReturn = computePortfolioSimpleReturn();
+	// Compute portfolio simple return and the drifted allocation weights in
+	// a single pass, the current allocation becoming the previous one
+	previousAllocation.swap(currentAllocation);
+	double portfolioSimpleReturn =
+		computePortfolioSimpleReturn<true>(dimState, currentState.memptr(),
+		                                   riskFreeRate, deltaP, deltaF, deltaS,
+		                                   newAllocation.memptr(),
+		                                   previousAllocation.memptr(),
+		                                   currentAllocation.memptr());
 
-	// Update allocation weights
-	currentAllocation = newAllocation % (1.0 + currentState) /
-						(1.0 + portfolioSimpleReturn);
+	// Normalize allocation weights by the portfolio gross return
+	currentAllocation /= 1.0 + portfolioSimpleReturn;
 
 	// Return portfolio log-return
 	return log(1.0 + portfolioSimpleReturn);
 }
 
+void AssetAllocationTask::getRewards(arma::mat const &actions_,
+                                     arma::vec &rewards_) const
+{
+    if (actions_.n_rows != dimState)
+        throw std::invalid_argument("AssetAllocationTask: wrong actions size");
+
+    rewards_.set_size(actions_.n_cols);
+    for (size_t j = 0; j < actions_.n_cols; ++j)
+        rewards_(j) = log(1.0 + computePortfolioSimpleReturn<false>(
+            dimState, currentState.memptr(), riskFreeRate, deltaP, deltaF, deltaS,
+            actions_.colptr(j), previousAllocation.memptr(), nullptr));
+}
+
 void AssetAllocationTask::reset()
 {
     environmentPtr->reset();
@@ -144,32 +152,23 @@ void AssetAllocationTask::setEvaluationInterval (size_t startDate_,
     reset();
 }
 
-double AssetAllocationTask::computePortfolioSimpleReturn () const
+size_t AssetAllocationTask::getNumDays() const
+{
+	MarketEnvironment const* marketEvironmentPtr =
+        dynamic_cast<MarketEnvironment const*>(environmentPtr.get());
+	return marketEvironmentPtr->getNumDays();
+}
+
+size_t AssetAllocationTask::getStartDate() const
+{
+	MarketEnvironment const* marketEvironmentPtr =
+        dynamic_cast<MarketEnvironment const*>(environmentPtr.get());
+	return marketEvironmentPtr->getStartDate();
+}
+
+size_t AssetAllocationTask::getEndDate() const
 {
-	// Proportional transaction costs
-	double proportionTransactionCosts = deltaP *
-		arma::sum(arma::abs(newAllocation - currentAllocation));
-
-	// Fixed transaction costs
-	double fixedTransactionCosts = 	deltaF *
-		(!arma::approx_equal(currentAllocation, newAllocation, "absdiff",
-							 std::numeric_limits<double>::epsilon()));
-
-	// Short-selling fees
-    double shortPositionsWeight = 0.0;
-	for(size_t i = 0; i < newAllocation.size(); ++i)
-		if (newAllocation(i) < 0.0)
-			shortPositionsWeight += - newAllocation(i);
-	double shortTransactionCosts = deltaS * shortPositionsWeight;
-
-	// Trading profit & loss
-	double tradingPL = riskFreeRate +
-                       arma::dot(newAllocation, currentState - riskFreeRate);
-
-	// Compute simple portfolio return
-	double portfolioSimpleReturn = tradingPL
-								 - proportionTransactionCosts
-								 - fixedTransactionCosts
-								 - shortTransactionCosts;
-	return portfolioSimpleReturn;
+	MarketEnvironment const* marketEvironmentPtr =
+        dynamic_cast<MarketEnvironment const*>(environmentPtr.get());
+	return marketEvironmentPtr->getEndDate();
 }
@@ -0,0 +1,310 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "thesis/AsyncActorLearner.h"
+#include <random>      /* std::seed_seq */
+#include <stdexcept>   /* std::invalid_argument */
+#include <thread>      /* std::thread */
+
+namespace
+{
+
+//! Number of transition batches in flight per actor thread
+static const size_t batchesPerActor = 4;
+
+//! Smallest power of two not lower than n
+size_t nextPowerOfTwo(size_t n)
+{
+    size_t power = 1;
+    while (power < n)
+        power <<= 1;
+    return power;
+}
+
+}
+
+AsyncActorLearner::AsyncActorLearner(size_t numActors_, size_t batchSize_)
+    : numActors(numActors_),
+      batchSize(batchSize_),
+      actorsSeed(0),
+      numEpochs(0),
+      startDate(0),
+      endDate(0),
+      snapshotVersion(0),
+      numRunningActors(0),
+      stopping(false)
+{
+    if (numActors == 0)
+        throw std::invalid_argument("AsyncActorLearner: at least one actor thread is needed");
+    if (batchSize == 0)
+        throw std::invalid_argument("AsyncActorLearner: empty transition batches");
+}
+
+void AsyncActorLearner::seed(unsigned int seed_)
+{
+    actorsSeed = seed_;
+    numEpochs = 0;
+}
+
+void AsyncActorLearner::initializeBatches(size_t dimObservation_, size_t dimAction_)
+{
+    if (!batches.empty() &&
+        batches.front().observations.n_rows == dimObservation_ &&
+        batches.front().actions.n_rows == dimAction_)
+        return;
+
+    size_t const numBatches = batchesPerActor * numActors;
+    batches.resize(numBatches);
+    for (TransitionBatch &batch : batches)
+    {
+        batch.observations.set_size(dimObservation_, batchSize);
+        batch.actions.set_size(dimAction_, batchSize);
+        batch.rewards.set_size(batchSize);
+        batch.nextObservations.set_size(dimObservation_, batchSize);
+        batch.size = 0;
+    }
+
+    // Both queues can hold every batch, so that a push never fails
+    size_t const capacity = nextPowerOfTwo(numBatches);
+    freeBatches.reset(new LockFreeQueue<TransitionBatch *>(capacity));
+    fullBatches.reset(new LockFreeQueue<TransitionBatch *>(capacity));
+}
+
+void AsyncActorLearner::runEpoch(AssetAllocationTask &task_,
+                                 ActorLearnerAgent &agent_,
+                                 size_t numSteps_,
+                                 std::function<void(double)> const &rewardCallback_)
+{
+    // The actions are stored as selected by the agent, whose action space
+    // matches the one of the task, as checked by performAction
+    initializeBatches(task_.getDimObservation(), agent_.getDimAction());
+
+    // Recycle all the batches, including the ones left by a failed epoch
+    TransitionBatch *batch = nullptr;
+    while (freeBatches->pop(batch)) {}
+    while (fullBatches->pop(batch)) {}
+    for (TransitionBatch &b : batches)
+    {
+        b.size = 0;
+        b.newTrajectory = false;
+        freeBatches->push(&b);
+    }
+
+    // Actor agents and tasks, seeded from the epoch and the actor index. The
+    // evaluation interval of the k-th task starts k / numActors of the epoch
+    // later, so that on a historical market the actors visit the training
+    // days in a different order rather than replaying the same trajectory.
+    startDate = task_.getStartDate();
+    endDate = task_.getEndDate();
+    actorAgents.clear();
+    actorTasks.clear();
+    actorOffsets.assign(numActors, 0);
+    for (size_t k = 0; k < numActors; ++k)
+    {
+        std::seed_seq sequence{actorsSeed, static_cast<unsigned int>(numEpochs),
+                               static_cast<unsigned int>(k)};
+        unsigned int actorSeed;
+        sequence.generate(&actorSeed, &actorSeed + 1);
+
+        actorAgents.emplace_back(static_cast<ActorLearnerAgent*>(agent_.clone().release()));
+        actorAgents.back()->seed(actorSeed);
+        if (k > 0)
+        {
+            actorTasks.emplace_back(static_cast<AssetAllocationTask*>(task_.clone().release()));
+            actorTasks.back()->seed(actorSeed);
+            actorOffsets[k] = k * numSteps_ / numActors;
+            actorTasks.back()->setEvaluationInterval(startDate + actorOffsets[k], endDate);
+        }
+    }
+    ++numEpochs;
+
+    // Publish the initial policy and start the actors
+    error = nullptr;
+    stopping = false;
+    publish(agent_);
+    numRunningActors = numActors;
+    std::vector<std::thread> actors;
+    actors.reserve(numActors);
+    for (size_t k = 0; k < numActors; ++k)
+    {
+        AssetAllocationTask &task = (k == 0) ? task_ : *actorTasks[k - 1];
+        actors.emplace_back(&AsyncActorLearner::actorLoop, this, k, std::ref(task), numSteps_);
+    }
+
+    // Learner loop: the actors must be checked before the queue, so that
+    // the batches they pushed before finishing are not missed. The batches of
+    // an actor arrive in order, hence the eligibility traces are only reset
+    // when the next batch does not continue the trajectory of the last one.
+    try
+    {
+        size_t lastActor = numActors;
+        while (!stopping)
+        {
+            bool const finished = (numRunningActors.load(std::memory_order_acquire) == 0);
+            if (fullBatches->pop(batch))
+            {
+                if (batch->actor != lastActor || batch->newTrajectory)
+                    agent_.resetTraces();
+                lastActor = batch->actor;
+                learnBatch(*batch, agent_, rewardCallback_);
+                freeBatches->push(batch);
+                publish(agent_);
+            }
+            else if (finished)
+                break;
+            else
+                std::this_thread::yield();
+        }
+    }
+    catch (...)
+    {
+        fail(std::current_exception());
+    }
+
+    for (std::thread &actor : actors)
+        actor.join();
+    if (error)
+        std::rethrow_exception(error);
+}
+
+void AsyncActorLearner::actorLoop(size_t index_, AssetAllocationTask &task_, size_t numSteps_)
+{
+    try
+    {
+        ActorLearnerAgent &agent = *actorAgents[index_];
+        std::shared_ptr<RealVec const> parameters;
+        size_t version = 0;
+        arma::vec observation;
+        arma::vec action(agent.getDimAction());
+        task_.getObservation(observation);
+
+        // Steps after which the task wraps around to the start of the interval
+        size_t const wrapStep = numSteps_ - actorOffsets[index_];
+        bool newTrajectory = false;
+
+        TransitionBatch *batch = nullptr;
+        for (size_t step = 0; step < numSteps_ && !stopping; ++step)
+        {
+            // Wrap around, handing over the transitions of the first segment
+            if (step == wrapStep)
+            {
+                if (batch)
+                {
+                    fullBatches->push(batch);
+                    batch = nullptr;
+                }
+                task_.setEvaluationInterval(startDate, endDate);
+                task_.getObservation(observation);
+                newTrajectory = true;
+            }
+
+            // Refresh the policy if the learner published a new snapshot
+            size_t lastVersion = snapshotVersion.load(std::memory_order_acquire);
+            if (!parameters || lastVersion != version)
+            {
+                parameters = std::atomic_load(&snapshot);
+                agent.setActorParameters(*parameters);
+                version = lastVersion;
+            }
+
+            // Get a free batch, waiting for the learner if necessary
+            while (!batch && !freeBatches->pop(batch))
+            {
+                if (stopping)
+                    break;
+                std::this_thread::yield();
+            }
+            if (!batch)
+                break;
+            if (batch->size == 0)
+            {
+                batch->actor = index_;
+                batch->newTrajectory = newTrajectory;
+                newTrajectory = false;
+            }
+
+            // Interaction step, recorded in the batch
+            size_t const i = batch->size;
+            agent.receiveObservation(observation);
+            agent.getAction(action);
+            task_.performAction(action);
+            double reward = task_.getReward();
+            batch->observations.col(i) = observation;
+            batch->actions.col(i) = action;
+            batch->rewards(i) = reward;
+            task_.getObservation(observation);
+            batch->nextObservations.col(i) = observation;
+            ++batch->size;
+
+            // Hand the batch to the learner when full or at the end of the epoch
+            if (batch->size == batchSize || step + 1 == numSteps_)
+            {
+                fullBatches->push(batch);
+                batch = nullptr;
+            }
+        }
+    }
+    catch (...)
+    {
+        fail(std::current_exception());
+    }
+    numRunningActors.fetch_sub(1, std::memory_order_release);
+}
+
+void AsyncActorLearner::learnBatch(TransitionBatch &batch_,
+                                   ActorLearnerAgent &agent_,
+                                   std::function<void(double)> const &rewardCallback_)
+{
+    for (size_t i = 0; i < batch_.size; ++i)
+    {
+        arma::vec const observation(batch_.observations.colptr(i),
+                                    batch_.observations.n_rows, false, true);
+        arma::vec const action(batch_.actions.colptr(i),
+                               batch_.actions.n_rows, false, true);
+        arma::vec const nextObservation(batch_.nextObservations.colptr(i),
+                                        batch_.nextObservations.n_rows, false, true);
+        agent_.receiveObservation(observation);
+        agent_.receiveBehaviourAction(action);
+        agent_.receiveReward(batch_.rewards(i));
+        agent_.receiveNextObservation(nextObservation);
+        agent_.learn();
+        rewardCallback_(batch_.rewards(i));
+    }
+    batch_.size = 0;
+}
+
+void AsyncActorLearner::publish(ActorLearnerAgent const &agent_)
+{
+    agent_.getActorParameters(parametersCache);
+    std::atomic_store(&snapshot, std::make_shared<RealVec const>(parametersCache));
+    snapshotVersion.fetch_add(1, std::memory_order_release);
+}
+
+void AsyncActorLearner::fail(std::exception_ptr error_)
+{
+    {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!error)
+            error = error_;
+    }
+    stopping = true;
+}
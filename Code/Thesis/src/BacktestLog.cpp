@@ -1,57 +1,196 @@
 #include "thesis/BacktestLog.h"
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
 
-std::ostream& operator<<(std::ostream &os, BacktestLog const &blog)
+namespace
 {
-    os << blog.history.t() << std::endl;
-    return os;
-}
 
-BacktestLog::BacktestLog(size_t dimState_, size_t dimAction_, size_t numRecords_)
+//! Magic number at the beginning of the binary backtest files.
+const char magicNumber[8] = {'T', 'H', 'B', 'K', 'T', 'B', 'I', 'N'};
+
+//! Binary format version.
+const uint32_t formatVersion = 1;
+
+//! Maximum length of a value printed with "%.16e", e.g. -1.2345678901234567e+308
+const size_t maxValueLength = 24;
+
+} // namespace
+
+BacktestLog::BacktestLog(size_t dimState_,
+                         size_t dimAction_,
+                         size_t bufferRecords_,
+                         Format format_)
     : dimState(dimState_),
       dimAction(dimAction_),
-      history(dimState_ + dimAction_ + 2, numRecords_, arma::fill::zeros),
-      currentIdx(0ul)
+      format(format_),
+      activeRecords(dimState_ + dimAction_ + 2, bufferRecords_ > 0 ? bufferRecords_ : 1),
+      writtenRecords(activeRecords.n_rows, activeRecords.n_cols),
+      currentIdx(0ul),
+      file(nullptr),
+      writer(1)
 {
     /* Nothing to do */
 }
 
-void BacktestLog::insertRecord(arma::vec const &state_,
-                               arma::vec const &action_,
-                               double const reward_)
+BacktestLog::~BacktestLog()
 {
-    history(arma::span(0, state_.size() - 1), currentIdx) = state_;
-    history(state_.size(), currentIdx) = 1.0 - arma::sum(action_);
-    history(arma::span(state_.size() + 1, history.n_rows - 2), currentIdx) = action_;
-    history(history.n_rows-1, currentIdx) = reward_;
-    ++currentIdx;
+    // Destructors must not throw: errors are only reported by close()
+    try
+    {
+        close();
+    }
+    catch (...)
+    {
+    }
 }
 
-void BacktestLog::save(std::string filename)
+std::string BacktestLog::getFileExtension() const
 {
-    // Open file
-    std::ofstream backtestFile;
-    backtestFile.open(filename);
+    return (format == Format::Binary) ? ".bin" : ".csv";
+}
 
-    // Write header
+BacktestLog::Format BacktestLog::formatFromString(std::string const &name_)
+{
+    if (name_ == "csv")
+        return Format::Csv;
+    else if (name_ == "binary")
+        return Format::Binary;
+    else
+        throw std::invalid_argument("Unknown backtest log format " + name_);
+}
+
+std::string BacktestLog::header() const
+{
     std::ostringstream headerStream;
     for (size_t n = 1; n < dimState + 1; ++n)
         headerStream << "r_" << n << ",";
     for (size_t n = 0; n < dimAction + 1; ++n)
         headerStream << "a_" << n << ",";
     headerStream << "logReturn";
-    std::string header = headerStream.str();
-    backtestFile << header << std::endl;
+    return headerStream.str();
+}
+
+void BacktestLog::open(std::string const &filename)
+{
+    close();
+    statistics.reset();
+
+    file = std::fopen(filename.c_str(), "wb");
+    if (!file)
+        throw std::runtime_error("Cannot open backtest log " + filename);
+
+    // Write header
+    std::string const columns = header();
+    if (format == Format::Binary)
+    {
+        uint32_t const numColumns = activeRecords.n_rows;
+        uint64_t const headerSize = columns.size();
+        std::fwrite(magicNumber, 1, sizeof(magicNumber), file);
+        std::fwrite(&formatVersion, sizeof(formatVersion), 1, file);
+        std::fwrite(&numColumns, sizeof(numColumns), 1, file);
+        std::fwrite(&headerSize, sizeof(headerSize), 1, file);
+        std::fwrite(columns.data(), 1, columns.size(), file);
+    }
+    else
+    {
+        std::fputs(columns.c_str(), file);
+        std::fputc('\n', file);
+    }
+}
+
+void BacktestLog::insertRecord(arma::vec const &state_,
+                               arma::vec const &action_,
+                               double const reward_)
+{
+    if (state_.n_elem != dimState || action_.n_elem != dimAction)
+        throw std::invalid_argument("BacktestLog: wrong record size");
 
-    // Save matrix
-    arma::mat historyTransposed = trans(history);
-    historyTransposed.save(backtestFile, arma::csv_ascii);
+    double *record = activeRecords.colptr(currentIdx);
+    std::memcpy(record, state_.memptr(), dimState * sizeof(double));
+    record[dimState] = 1.0 - arma::sum(action_);
+    std::memcpy(record + dimState + 1, action_.memptr(), dimAction * sizeof(double));
+    record[activeRecords.n_rows - 1] = reward_;
+    statistics.dumpOneRecord(action_, reward_);
 
-    // Close file
-    backtestFile.close();
+    if (++currentIdx == activeRecords.n_cols)
+        flush();
 }
 
-void BacktestLog::reset()
+void BacktestLog::flush()
 {
-    history.zeros();
+    if (!file || currentIdx == 0)
+    {
+        currentIdx = 0ul;
+        return;
+    }
+
+    // The written buffer becomes free once the previous write is completed
+    waitPendingWrite();
+    activeRecords.swap(writtenRecords);
+    size_t const numRecords = currentIdx;
+    std::FILE *output = file;
     currentIdx = 0ul;
+    pendingWrite = writer.submit([this, output, numRecords]() {
+        writeRecords(output, writtenRecords, numRecords);
+    });
+}
+
+void BacktestLog::waitPendingWrite()
+{
+    if (pendingWrite.valid())
+        pendingWrite.get();
+}
+
+void BacktestLog::close()
+{
+    if (!file)
+        return;
+
+    flush();
+    std::FILE *closingFile = file;
+    file = nullptr;
+    try
+    {
+        waitPendingWrite();
+    }
+    catch (...)
+    {
+        std::fclose(closingFile);
+        throw;
+    }
+    if (std::fclose(closingFile) != 0)
+        throw std::runtime_error("Cannot close backtest log");
+}
+
+void BacktestLog::writeRecords(std::FILE *file_,
+                               arma::mat const &records_,
+                               size_t numRecords_)
+{
+    size_t const numColumns = records_.n_rows;
+    if (format == Format::Binary)
+    {
+        // Records are stored column-wise, hence contiguously
+        if (std::fwrite(records_.memptr(), sizeof(double), numColumns * numRecords_, file_)
+                != numColumns * numRecords_)
+            throw std::runtime_error("Cannot write backtest log");
+        return;
+    }
+
+    // Encode the records as text in a single buffer
+    textBuffer.resize(numColumns * numRecords_ * (maxValueLength + 1) + 1);
+    char *text = textBuffer.data();
+    for (size_t j = 0; j < numRecords_; ++j)
+    {
+        double const *record = records_.colptr(j);
+        for (size_t i = 0; i < numColumns; ++i)
+        {
+            text += std::snprintf(text, maxValueLength + 1, "%.16e", record[i]);
+            *text++ = (i + 1 < numColumns) ? ',' : '\n';
+        }
+    }
+    size_t const textSize = text - textBuffer.data();
+    if (std::fwrite(textBuffer.data(), 1, textSize, file_) != textSize)
+        throw std::runtime_error("Cannot write backtest log");
 }
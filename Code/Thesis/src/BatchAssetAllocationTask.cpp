@@ -0,0 +1,179 @@
+#include <thesis/BatchAssetAllocationTask.h>
+#include <thesis/PortfolioReturn.h>
+#include <math.h>      /* log */
+#include <random>      /* std::seed_seq */
+#include <stdexcept>   /* std::invalid_argument */
+
+BatchAssetAllocationTask::BatchAssetAllocationTask(MarketEnvironment const &market_,
+                                                   std::vector<size_t> const &startDates_,
+                                                   double riskFreeRate_,
+                                                   double deltaP_,
+                                                   double deltaF_,
+                                                   double deltaS_,
+                                                   size_t numDaysObserved_)
+    : riskFreeRate(riskFreeRate_),
+      deltaP(deltaP_),
+      deltaF(deltaF_),
+      deltaS(deltaS_),
+      numDaysObserved(numDaysObserved_),
+      pastStates(0, numDaysObserved_)
+{
+    for (size_t startDate : startDates_)
+    {
+        markets.emplace_back(static_cast<MarketEnvironment*>(market_.clone().release()));
+        markets.back()->setEvaluationInterval(startDate, market_.getEndDate());
+    }
+    initialize();
+}
+
+BatchAssetAllocationTask::BatchAssetAllocationTask(std::vector<std::unique_ptr<MarketEnvironment>> markets_,
+                                                   double riskFreeRate_,
+                                                   double deltaP_,
+                                                   double deltaF_,
+                                                   double deltaS_,
+                                                   size_t numDaysObserved_)
+    : markets(std::move(markets_)),
+      riskFreeRate(riskFreeRate_),
+      deltaP(deltaP_),
+      deltaF(deltaF_),
+      deltaS(deltaS_),
+      numDaysObserved(numDaysObserved_),
+      pastStates(0, numDaysObserved_)
+{
+    initialize();
+}
+
+BatchAssetAllocationTask::BatchAssetAllocationTask(BatchAssetAllocationTask const &other_)
+    : riskFreeRate(other_.riskFreeRate),
+      deltaP(other_.deltaP),
+      deltaF(other_.deltaF),
+      deltaS(other_.deltaS),
+      numDaysObserved(other_.numDaysObserved),
+      dimState(other_.dimState),
+      dimObservation(other_.dimObservation),
+      pastStates(other_.pastStates),
+      currentStates(other_.currentStates),
+      currentAllocations(other_.currentAllocations),
+      newAllocations(other_.newAllocations),
+      previousAllocations(other_.previousAllocations)
+{
+    for (auto const &marketPtr : other_.markets)
+        markets.emplace_back(static_cast<MarketEnvironment*>(marketPtr->clone().release()));
+}
+
+void BatchAssetAllocationTask::initialize()
+{
+    if (markets.empty())
+        throw std::invalid_argument("BatchAssetAllocationTask: empty batch");
+
+    // Dimensions of observation and action spaces
+    dimState = markets.front()->getDimState();
+    for (auto const &marketPtr : markets)
+        if (marketPtr->getDimState() != dimState)
+            throw std::invalid_argument("BatchAssetAllocationTask: markets with different numbers of risky assets");
+    size_t const batchSize = markets.size();
+    pastStates = PastStatesWindow(dimState, numDaysObserved, batchSize);
+    dimObservation = pastStates.getDimObservation(dimState);
+
+    // Initialize batch matrices
+    currentStates.set_size(dimState, batchSize);
+    currentAllocations.set_size(dimState, batchSize);
+    newAllocations.set_size(dimState, batchSize);
+    previousAllocations.set_size(dimState, batchSize);
+    reset();
+}
+
+void BatchAssetAllocationTask::initializeStatesCache()
+{
+    pastStates.clear();
+    for (size_t i = 0; i < numDaysObserved; ++i)
+    {
+        readStates();
+        pastStates.push(currentStates);
+        advanceMarkets();
+    }
+    readStates();
+}
+
+void BatchAssetAllocationTask::readStates()
+{
+    for (size_t k = 0; k < markets.size(); ++k)
+    {
+        arma::vec state(currentStates.colptr(k), dimState, false, true);
+        markets[k]->getState(state);
+    }
+}
+
+void BatchAssetAllocationTask::advanceMarkets()
+{
+    for (size_t k = 0; k < markets.size(); ++k)
+    {
+        arma::vec const action(newAllocations.colptr(k), dimState, false, true);
+        markets[k]->performAction(action);
+    }
+}
+
+void BatchAssetAllocationTask::getObservations(arma::mat &observations_) const
+{
+    pastStates.getObservations(riskFreeRate, currentStates, currentAllocations, observations_);
+}
+
+void BatchAssetAllocationTask::performActions(arma::mat const &actions_)
+{
+    if (actions_.n_rows != dimState || actions_.n_cols != markets.size())
+        throw std::invalid_argument("BatchAssetAllocationTask: wrong actions size");
+
+    // Cache new allocations and broadcast them to the markets
+    newAllocations = actions_;
+    advanceMarkets();
+}
+
+void BatchAssetAllocationTask::getRewards(arma::vec &rewards_)
+{
+    // Update past states with current states and observe new market states
+    pastStates.push(currentStates);
+    readStates();
+
+    // Compute the portfolio simple returns and the drifted allocation weights
+    // column by column, the current allocations becoming the previous ones
+    previousAllocations.swap(currentAllocations);
+    rewards_.set_size(markets.size());
+    for (size_t k = 0; k < markets.size(); ++k)
+    {
+        double *allocation = currentAllocations.colptr(k);
+        double portfolioSimpleReturn =
+            computePortfolioSimpleReturn<true>(dimState, currentStates.colptr(k),
+                                               riskFreeRate, deltaP, deltaF, deltaS,
+                                               newAllocations.colptr(k),
+                                               previousAllocations.colptr(k),
+                                               allocation);
+
+        // Normalize allocation weights by the portfolio gross return
+        for (size_t i = 0; i < dimState; ++i)
+            allocation[i] /= 1.0 + portfolioSimpleReturn;
+
+        // Portfolio log-return
+        rewards_(k) = log(1.0 + portfolioSimpleReturn);
+    }
+}
+
+void BatchAssetAllocationTask::reset()
+{
+    for (auto &marketPtr : markets)
+        marketPtr->reset();
+    newAllocations.zeros();
+    initializeStatesCache();
+    currentAllocations.zeros();
+    previousAllocations.zeros();
+}
+
+void BatchAssetAllocationTask::seed(unsigned int seed_)
+{
+    for (size_t k = 0; k < markets.size(); ++k)
+    {
+        std::seed_seq sequence {seed_, static_cast<unsigned int>(k)};
+        std::vector<unsigned int> trajectorySeed(1);
+        sequence.generate(trajectorySeed.begin(), trajectorySeed.end());
+        markets[k]->seed(trajectorySeed[0]);
+    }
+}
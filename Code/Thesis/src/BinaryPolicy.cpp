@@ -1,4 +1,5 @@
 #include "thesis/BinaryPolicy.h"
+#include <algorithm>  /* std::min, std::max */
 
 BinaryPolicy::BinaryPolicy(size_t dimObservation_,
                            double paramMinValue_,
@@ -6,8 +7,9 @@ BinaryPolicy::BinaryPolicy(size_t dimObservation_,
     : Policy(dimObservation_, 1ul),
       dimParameters(dimObservation_ + 1),
       parameters(dimObservation_ + 1),
-      paramMinValue(paramMinValue_),
-      paramMaxValue(paramMaxValue_)
+      paramMinValue(toRealBound(paramMinValue_)),
+      paramMaxValue(toRealBound(paramMaxValue_)),
+      features(dimObservation_ + 1)
 {
     initializeParameters();
 }
@@ -19,23 +21,55 @@ void BinaryPolicy::initializeParameters()
     parameters *= 0.001;
 }
 
-void BinaryPolicy::setParameters(arma::vec const & parameters_)
+void BinaryPolicy::setParameters(RealVec const & parameters_)
 {
     parameters = arma::clamp(parameters_, paramMinValue, paramMaxValue);
 }
 
-arma::vec BinaryPolicy::getAction(arma::vec const & observation_) const
+void BinaryPolicy::getAction(RealVec const & observation_,
+                             RealVec &action_) const
 {
     // Compute features
-    arma::vec features(dimParameters);
     features(0) = 1.0;
     features.rows(1, dimParameters - 1) = observation_;
 
     // Compute action
-    double activation = arma::dot(parameters, features);
-    arma::vec action(1);
-    action(0) = (activation > 0.0) ? 1.0 : -1.0;
-    return action;
+    Real activation = arma::dot(parameters, features);
+    action_.set_size(1);
+    action_(0) = (activation > 0.0) ? 1.0 : -1.0;
+}
+
+void BinaryPolicy::getActions(RealVec const & observation_,
+                              RealMat &parameters_,
+                              RealMat &actions_) const
+{
+    // Enforce parameters bounds
+    parameters_.transform( [&](Real p) {
+        return std::min(std::max(p, paramMinValue), paramMaxValue); } );
+
+    // Compute features
+    features(0) = 1.0;
+    features.rows(1, dimParameters - 1) = observation_;
+
+    // Compute actions
+    activations = parameters_.t() * features;
+    actions_.set_size(1, parameters_.n_cols);
+    for (size_t j = 0; j < parameters_.n_cols; ++j)
+    {
+        actions_(0, j) = (activations(j) > 0.0) ? 1.0 : -1.0;
+    }
+}
+
+void BinaryPolicy::getBatchActions(RealMat const & observations_,
+                                   RealMat &actions_) const
+{
+    // Compute activations, the bias being the first parameter
+    activations = observations_.t() * parameters.tail(dimParameters - 1);
+    actions_.set_size(1, observations_.n_cols);
+    for (size_t k = 0; k < observations_.n_cols; ++k)
+    {
+        actions_(0, k) = (parameters(0) + activations(k) > 0.0) ? 1.0 : -1.0;
+    }
 }
 
 void BinaryPolicy::reset()
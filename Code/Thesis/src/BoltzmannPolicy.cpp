@@ -1,26 +1,61 @@
 #include "thesis/BoltzmannPolicy.h"
-#include <cmath>   /* abs */
-#include <limits>  /* eps */
+#include <cmath>      /* exp */
+#include <limits>     /* digits */
 #include <random>
+#include <stdexcept>  /* std::invalid_argument */
 #include <iostream>
-#include <algorithm>  /* find */
+#include <algorithm>  /* find, lower_bound, max */
+#include <numeric>    /* partial_sum */
 #include <fstream>
 
+/*
+ * Check the possible actions before the sizes of the parameters, which depend
+ * on their number minus one, are computed from them.
+ */
+static std::vector<double> const &checkedActions(std::vector<double> const &possibleActions_)
+{
+    if (possibleActions_.size() < 2)
+        throw std::invalid_argument("BoltzmannPolicy requires at least two possible actions");
+    return possibleActions_;
+}
+
 BoltzmannPolicy::BoltzmannPolicy(size_t dimObservation_,
                                  std::vector<double> possibleActions_)
     : StochasticPolicy(dimObservation_, 1ul),
-      possibleActions(possibleActions_),
+      possibleActions(checkedActions(possibleActions_)),
       numPossibleActions(possibleActions.size()),
       dimParametersPerAction(dimObservation_ + 1),
       dimParameters(dimParametersPerAction * (numPossibleActions - 1)),
       parametersMat(dimParametersPerAction, numPossibleActions - 1),
       parametersVec(parametersMat.memptr(), dimParameters, false, false),
-      generator(),
-      boltzmannProbabilities(numPossibleActions)
+      generator(0, RandomStream::Policy),
+      boltzmannProbabilities(numPossibleActions),
+      cumulativeProbabilities(numPossibleActions),
+      lastActionIdx(numPossibleActions),
+      features(dimParametersPerAction),
+      activations(numPossibleActions - 1)
 {
     initializeParameters();
 }
 
+BoltzmannPolicy::BoltzmannPolicy(BoltzmannPolicy const &other_)
+    : StochasticPolicy(other_.getDimObservation(), other_.getDimAction()),
+      possibleActions(other_.possibleActions),
+      numPossibleActions(other_.numPossibleActions),
+      dimParametersPerAction(other_.dimParametersPerAction),
+      dimParameters(other_.dimParameters),
+      parametersMat(other_.parametersMat),
+      parametersVec(parametersMat.memptr(), dimParameters, false, false),
+      generator(other_.generator),
+      boltzmannProbabilities(other_.boltzmannProbabilities),
+      cumulativeProbabilities(other_.cumulativeProbabilities),
+      lastActionIdx(other_.lastActionIdx),
+      features(other_.features),
+      activations(other_.activations)
+{
+    /* Nothing to do */
+}
+
 void BoltzmannPolicy::initializeParameters()
 {
     parametersMat.randu();
@@ -28,61 +63,103 @@ void BoltzmannPolicy::initializeParameters()
     parametersMat *= 0.1;
 }
 
-arma::vec BoltzmannPolicy::getParameters() const
+void BoltzmannPolicy::getParameters(RealVec &parameters_) const
 {
-    return parametersVec;
+    parameters_ = parametersVec;
 }
 
-void BoltzmannPolicy::setParameters(arma::vec const &parameters)
+void BoltzmannPolicy::setParameters(RealVec const &parameters)
 {
     parametersVec = parameters;
 }
 
-arma::vec BoltzmannPolicy::getAction(arma::vec const &observation_) const
+void BoltzmannPolicy::getAction(RealVec const &observation_,
+                                RealVec &action_) const
 {
     // Compute features
-    arma::vec features(dimParametersPerAction);
     features(0) = 1.0;
     features.rows(1, features.n_elem - 1) = observation_;
 
-    // Compute actions probabilities according to Boltzmann distribution
-    arma::vec boltzmannWeights(numPossibleActions, arma::fill::ones);
-    boltzmannWeights.rows(0, boltzmannWeights.n_elem - 2) = arma::exp(parametersMat.t() * features);
-    std::discrete_distribution<int> boltzmannDistribution(boltzmannWeights.begin(),
-                                                          boltzmannWeights.end());
-    // Cache action probabilities
-    boltzmannProbabilities = boltzmannDistribution.probabilities();
-
-    // Generate action
-    int actionIdx = boltzmannDistribution(generator);
-    arma::vec action(1);
-    action(0) = possibleActions[actionIdx];
-    return action;
+    // Compute actions probabilities according to Boltzmann distribution. The
+    // last action is the reference one and has zero activation.
+    activations = parametersMat.t() * features;
+    computeProbabilities();
+
+    // Generate action by inversion of the cumulative probabilities
+    double const u =
+        std::generate_canonical<double, std::numeric_limits<double>::digits>(generator);
+    lastActionIdx = std::distance(cumulativeProbabilities.begin(),
+                                  std::lower_bound(cumulativeProbabilities.begin(),
+                                                   cumulativeProbabilities.end(),
+                                                   u));
+    action_.set_size(1);
+    action_(0) = possibleActions[lastActionIdx];
+}
+
+void BoltzmannPolicy::computeProbabilities() const
+{
+    // Log-sum-exp: shift the activations by their maximum, so that the
+    // largest weight is one and the exponentials cannot overflow.
+    double const maxActivation = std::max<double>(activations.max(), 0.0);
+    double sumWeights = 0.0;
+    for (size_t i = 0; i < numPossibleActions - 1; ++i)
+    {
+        boltzmannProbabilities[i] = std::exp(activations(i) - maxActivation);
+        sumWeights += boltzmannProbabilities[i];
+    }
+    boltzmannProbabilities[numPossibleActions - 1] = std::exp(-maxActivation);
+    sumWeights += boltzmannProbabilities[numPossibleActions - 1];
+
+    double const invSumWeights = 1.0 / sumWeights;
+    for (double &probability : boltzmannProbabilities)
+        probability *= invSumWeights;
+    std::partial_sum(boltzmannProbabilities.begin(),
+                     boltzmannProbabilities.end(),
+                     cumulativeProbabilities.begin());
+    cumulativeProbabilities.back() = 1.0;
 }
 
-arma::vec BoltzmannPolicy::likelihoodScore(arma::vec const &observation_,
-                                           arma::vec const &action_) const
+void BoltzmannPolicy::likelihoodScore(RealVec const &observation_,
+                                      RealVec const &action_,
+                                      RealVec &likScore_) const
 {
     // Compute features
-    arma::vec features(dimParametersPerAction);
     features(0) = 1.0;
     features.rows(1, features.n_elem - 1) = observation_;
 
-    // Find index of selected action
-    size_t actionIdx = std::distance(possibleActions.begin(),
-                                     std::find(possibleActions.begin(), possibleActions.end(), action_[0]));
+    // Index of selected action, searched only if the action was not the last
+    // one sampled by getAction
+    size_t actionIdx = lastActionIdx;
+    if (actionIdx >= numPossibleActions || possibleActions[actionIdx] != action_[0])
+        actionIdx = std::distance(possibleActions.begin(),
+                                  std::find(possibleActions.begin(), possibleActions.end(), action_[0]));
 
-    // Compute likelihood score
-    arma::vec likScore(dimParameters);
+    // Compute likelihood score block by block: (1{a = i} - p_i) * features
+    likScore_.set_size(dimParameters);
+    Real *score = likScore_.memptr();
+    Real const *phi = features.memptr();
     for (size_t i = 0; i < numPossibleActions - 1; ++i)
     {
-        likScore.rows(i * dimParametersPerAction, (i + 1) * dimParametersPerAction - 1)
-            = - boltzmannProbabilities[i] * features;
+        double const coefficient = (i == actionIdx ? 1.0 : 0.0) - boltzmannProbabilities[i];
+        for (size_t j = 0; j < dimParametersPerAction; ++j)
+            score[j] = coefficient * phi[j];
+        score += dimParametersPerAction;
     }
-    if (actionIdx != numPossibleActions - 1)
-        likScore.rows(actionIdx * dimParametersPerAction,
-                      (actionIdx + 1) * dimParametersPerAction - 1) += features;
-    return likScore;
+}
+
+void BoltzmannPolicy::behaviourLikelihoodScore(RealVec const &observation_,
+                                               RealVec const &action_,
+                                               RealVec &likScore_) const
+{
+    // Compute features and actions probabilities
+    features(0) = 1.0;
+    features.rows(1, features.n_elem - 1) = observation_;
+    activations = parametersMat.t() * features;
+    computeProbabilities();
+
+    // The action has not been sampled by this copy
+    lastActionIdx = numPossibleActions;
+    likelihoodScore(observation_, action_, likScore_);
 }
 
 std::unique_ptr<Policy> BoltzmannPolicy::cloneImpl() const
@@ -95,3 +172,21 @@ void BoltzmannPolicy::reset()
     initializeParameters();
 }
 
+void BoltzmannPolicy::seed(unsigned int seed_)
+{
+    generator.seed(seed_, RandomStream::Policy);
+}
+
+void BoltzmannPolicy::saveState(CheckpointWriter &writer_) const
+{
+    writer_.write(parametersVec);
+    writer_.write(generator);
+}
+
+void BoltzmannPolicy::loadState(CheckpointReader &reader_)
+{
+    // parametersVec shares memory with parametersMat
+    reader_.read(parametersVec);
+    reader_.read(generator);
+}
+
@@ -0,0 +1,181 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "thesis/Checkpoint.h"
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+
+//! Magic number at the beginning of the snapshot files.
+const char magicNumber[8] = {'T', 'H', 'C', 'K', 'P', 'T', '0', '1'};
+
+//! Snapshot format version.
+const uint32_t formatVersion = 1;
+
+} // namespace
+
+CheckpointWriter::CheckpointWriter(std::string const &filename_)
+    : filename(filename_),
+      temporaryFilename(filename_ + ".tmp"),
+      file(std::fopen(temporaryFilename.c_str(), "wb"))
+{
+    if (!file)
+        throw std::runtime_error("Cannot open checkpoint " + temporaryFilename);
+    writeBytes(magicNumber, sizeof(magicNumber));
+    writeBytes(&formatVersion, sizeof(formatVersion));
+}
+
+CheckpointWriter::~CheckpointWriter()
+{
+    if (file)
+    {
+        std::fclose(file);
+        std::remove(temporaryFilename.c_str());
+    }
+}
+
+void CheckpointWriter::writeBytes(void const *data_, size_t size_)
+{
+    if (std::fwrite(data_, 1, size_, file) != size_)
+        throw std::runtime_error("Cannot write checkpoint " + temporaryFilename);
+}
+
+void CheckpointWriter::write(uint64_t value_)
+{
+    writeBytes(&value_, sizeof(value_));
+}
+
+void CheckpointWriter::write(double value_)
+{
+    writeBytes(&value_, sizeof(value_));
+}
+
+void CheckpointWriter::write(arma::vec const &values_)
+{
+    write(static_cast<uint64_t>(values_.n_elem));
+    writeBytes(values_.memptr(), values_.n_elem * sizeof(double));
+}
+
+void CheckpointWriter::write(arma::fvec const &values_)
+{
+    arma::vec values;
+    convertTo(values_, values);
+    write(values);
+}
+
+void CheckpointWriter::write(Philox4x32 const &generator_)
+{
+    write(static_cast<uint64_t>(generator_.getSeed()));
+    write(static_cast<uint64_t>(generator_.getComponent()));
+    write(generator_.getStep());
+    write(generator_.getPosition());
+}
+
+void CheckpointWriter::commit()
+{
+    std::FILE *closingFile = file;
+    file = nullptr;
+    if (std::fclose(closingFile) != 0)
+    {
+        std::remove(temporaryFilename.c_str());
+        throw std::runtime_error("Cannot close checkpoint " + temporaryFilename);
+    }
+    if (std::rename(temporaryFilename.c_str(), filename.c_str()) != 0)
+        throw std::runtime_error("Cannot replace checkpoint " + filename);
+}
+
+CheckpointReader::CheckpointReader(std::string const &filename_)
+    : filename(filename_),
+      file(std::fopen(filename_.c_str(), "rb"))
+{
+    if (!file)
+        throw std::runtime_error("Cannot open checkpoint " + filename);
+
+    char magic[sizeof(magicNumber)];
+    uint32_t version = 0;
+    readBytes(magic, sizeof(magic));
+    readBytes(&version, sizeof(version));
+    if (std::memcmp(magic, magicNumber, sizeof(magicNumber)) != 0 || version != formatVersion)
+    {
+        std::fclose(file);
+        throw std::runtime_error("Invalid checkpoint " + filename);
+    }
+}
+
+CheckpointReader::~CheckpointReader()
+{
+    std::fclose(file);
+}
+
+bool CheckpointReader::exists(std::string const &filename_)
+{
+    std::FILE *check = std::fopen(filename_.c_str(), "rb");
+    if (!check)
+        return false;
+    std::fclose(check);
+    return true;
+}
+
+void CheckpointReader::readBytes(void *data_, size_t size_)
+{
+    if (std::fread(data_, 1, size_, file) != size_)
+        throw std::runtime_error("Truncated checkpoint " + filename);
+}
+
+void CheckpointReader::read(uint64_t &value_)
+{
+    readBytes(&value_, sizeof(value_));
+}
+
+void CheckpointReader::read(double &value_)
+{
+    readBytes(&value_, sizeof(value_));
+}
+
+void CheckpointReader::read(arma::vec &values_)
+{
+    uint64_t size = 0;
+    read(size);
+    if (size != values_.n_elem)
+        throw std::runtime_error("Checkpoint " + filename + " does not match the object structure");
+    readBytes(values_.memptr(), values_.n_elem * sizeof(double));
+}
+
+void CheckpointReader::read(arma::fvec &values_)
+{
+    arma::vec values(values_.n_elem);
+    read(values);
+    convertTo(values, values_);
+}
+
+void CheckpointReader::read(Philox4x32 &generator_)
+{
+    uint64_t seed = 0, component = 0, step = 0, position = 0;
+    read(seed);
+    read(component);
+    read(step);
+    read(position);
+    generator_.seed(static_cast<uint32_t>(seed), static_cast<uint32_t>(component), step);
+    generator_.setPosition(position);
+}
@@ -1,10 +1,29 @@
 #include "thesis/ExperimentParameters.h"
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <stdexcept>
 #include <getpot.h>
 
+namespace
+{
+
+//! Parse the whole textual value of a parameter.
+template<typename T>
+void parseValue(std::string const &name_, std::string const &value_, T &field_)
+{
+    std::istringstream stream(value_);
+    stream >> field_;
+    if (stream.fail() || !(stream >> std::ws).eof())
+        throw std::invalid_argument("Invalid value " + value_ + " for parameter " + name_);
+}
+
+} // namespace
+
 ExperimentParameters::ExperimentParameters()
     : riskFreeRate(0.0),
+      market("historical"),
+      numSyntheticDays(10000),
       deltaP(0.0),
       deltaF(0.0),
       deltaS(0.0),
@@ -16,10 +35,23 @@ ExperimentParameters::ExperimentParameters()
       alphaExpCritic(0.7),
       alphaConstBaseline(0.2),
       alphaExpBaseline(0.6),
+      covariance("full"),
+      covarianceRank(1),
+      covarianceBlockSize(1),
+      populationSize(1),
       numExperiments(1),
       numEpochs(100),
       numTrainingSteps(1000),
-      numTestSteps(100)
+      numTestSteps(100),
+      numThreads(1),
+      seed(0),
+      backtestFormat("csv"),
+      walkForward(false),
+      checkpointInterval(0),
+      checkpointDir(""),
+      warmStart(""),
+      numActorThreads(0),
+      actorBatchSize(64)
 {
     /* Nothing to do */
 }
@@ -44,6 +76,8 @@ ExperimentParameters::ExperimentParameters(std::string const &filename, bool ver
         // Read parameters from file using GetPot
         GetPot ifile(filename.c_str());
         riskFreeRate = ifile("riskFreeRate", riskFreeRate);
+        market = ifile("market", market.c_str());
+        numSyntheticDays = ifile("numSyntheticDays", static_cast<int>(numSyntheticDays));
         deltaP = ifile("deltaP", deltaP);
         deltaF = ifile("deltaF", deltaF);
         deltaS = ifile("deltaS", deltaS);
@@ -55,10 +89,23 @@ ExperimentParameters::ExperimentParameters(std::string const &filename, bool ver
         alphaExpCritic = ifile("alphaExpCritic", alphaExpCritic);
         alphaConstBaseline = ifile("alphaConstBaseline", alphaConstBaseline);
         alphaExpBaseline = ifile("alphaExpBaseline", alphaExpBaseline);
+        covariance = ifile("covariance", covariance.c_str());
+        covarianceRank = ifile("covarianceRank", static_cast<int>(covarianceRank));
+        covarianceBlockSize = ifile("covarianceBlockSize", static_cast<int>(covarianceBlockSize));
+        populationSize = ifile("populationSize", static_cast<int>(populationSize));
         numExperiments = ifile("numExperiments", static_cast<int>(numExperiments));
         numEpochs = ifile("numEpochs", static_cast<int>(numEpochs));
         numTrainingSteps = ifile("numTrainingSteps", static_cast<int>(numTrainingSteps));
         numTestSteps = ifile("numTestSteps", static_cast<int>(numTestSteps));
+        numThreads = ifile("numThreads", static_cast<int>(numThreads));
+        seed = ifile("seed", static_cast<int>(seed));
+        backtestFormat = ifile("backtestFormat", backtestFormat.c_str());
+        walkForward = ifile("walkForward", static_cast<int>(walkForward)) != 0;
+        checkpointInterval = ifile("checkpointInterval", static_cast<int>(checkpointInterval));
+        checkpointDir = ifile("checkpointDir", checkpointDir.c_str());
+        warmStart = ifile("warmStart", warmStart.c_str());
+        numActorThreads = ifile("numActorThreads", static_cast<int>(numActorThreads));
+        actorBatchSize = ifile("actorBatchSize", static_cast<int>(actorBatchSize));
 
         if (verbose)
         {
@@ -67,9 +114,48 @@ ExperimentParameters::ExperimentParameters(std::string const &filename, bool ver
     }
 }
 
+void ExperimentParameters::setValue(std::string const &name_, std::string const &value_)
+{
+    if (name_ == "riskFreeRate") parseValue(name_, value_, riskFreeRate);
+    else if (name_ == "market") parseValue(name_, value_, market);
+    else if (name_ == "numSyntheticDays") parseValue(name_, value_, numSyntheticDays);
+    else if (name_ == "deltaP") parseValue(name_, value_, deltaP);
+    else if (name_ == "deltaF") parseValue(name_, value_, deltaF);
+    else if (name_ == "deltaS") parseValue(name_, value_, deltaS);
+    else if (name_ == "numDaysObserved") parseValue(name_, value_, numDaysObserved);
+    else if (name_ == "lambda") parseValue(name_, value_, lambda);
+    else if (name_ == "alphaConstActor") parseValue(name_, value_, alphaConstActor);
+    else if (name_ == "alphaExpActor") parseValue(name_, value_, alphaExpActor);
+    else if (name_ == "alphaConstCritic") parseValue(name_, value_, alphaConstCritic);
+    else if (name_ == "alphaExpCritic") parseValue(name_, value_, alphaExpCritic);
+    else if (name_ == "alphaConstBaseline") parseValue(name_, value_, alphaConstBaseline);
+    else if (name_ == "alphaExpBaseline") parseValue(name_, value_, alphaExpBaseline);
+    else if (name_ == "covariance") parseValue(name_, value_, covariance);
+    else if (name_ == "covarianceRank") parseValue(name_, value_, covarianceRank);
+    else if (name_ == "covarianceBlockSize") parseValue(name_, value_, covarianceBlockSize);
+    else if (name_ == "populationSize") parseValue(name_, value_, populationSize);
+    else if (name_ == "numExperiments") parseValue(name_, value_, numExperiments);
+    else if (name_ == "numEpochs") parseValue(name_, value_, numEpochs);
+    else if (name_ == "numTrainingSteps") parseValue(name_, value_, numTrainingSteps);
+    else if (name_ == "numTestSteps") parseValue(name_, value_, numTestSteps);
+    else if (name_ == "numThreads") parseValue(name_, value_, numThreads);
+    else if (name_ == "seed") parseValue(name_, value_, seed);
+    else if (name_ == "backtestFormat") parseValue(name_, value_, backtestFormat);
+    else if (name_ == "walkForward") parseValue(name_, value_, walkForward);
+    else if (name_ == "checkpointInterval") parseValue(name_, value_, checkpointInterval);
+    else if (name_ == "checkpointDir") parseValue(name_, value_, checkpointDir);
+    else if (name_ == "warmStart") parseValue(name_, value_, warmStart);
+    else if (name_ == "numActorThreads") parseValue(name_, value_, numActorThreads);
+    else if (name_ == "actorBatchSize") parseValue(name_, value_, actorBatchSize);
+    else
+        throw std::invalid_argument("Unknown experiment parameter " + name_);
+}
+
 std::ostream &operator<<(std::ostream &os, ExperimentParameters const &params)
 {
     std::cout << ".. riskFreeRate:       " << params.riskFreeRate << std::endl;
+    std::cout << ".. market:             " << params.market << std::endl;
+    std::cout << ".. numSyntheticDays:   " << params.numSyntheticDays << std::endl;
     std::cout << ".. deltaP:             " << params.deltaP << std::endl;
     std::cout << ".. deltaF:             " << params.deltaF << std::endl;
     std::cout << ".. deltaS:             " << params.deltaS << std::endl;
@@ -81,10 +167,24 @@ std::ostream &operator<<(std::ostream &os, ExperimentParameters const &params)
     std::cout << ".. alphaExpCritic:     " << params.alphaExpCritic << std::endl;
     std::cout << ".. alphaConstBaseline: " << params.alphaConstBaseline << std::endl;
     std::cout << ".. alphaExpBaseline:   " << params.alphaExpBaseline << std::endl;
+    std::cout << ".. covariance:         " << params.covariance << std::endl;
+    std::cout << ".. covarianceRank:     " << params.covarianceRank << std::endl;
+    std::cout << ".. covarianceBlockSize: " << params.covarianceBlockSize << std::endl;
+    std::cout << ".. populationSize:     " << params.populationSize << std::endl;
     std::cout << ".. numExperiments:     " << params.numExperiments << std::endl;
     std::cout << ".. numEpochs:          " << params.numEpochs << std::endl;
     std::cout << ".. numTrainingSteps:   " << params.numTrainingSteps << std::endl;
     std::cout << ".. numTestSteps:       " << params.numTestSteps << std::endl;
+    std::cout << ".. numThreads:         " << params.numThreads << std::endl;
+    std::cout << ".. seed:               " << params.seed << std::endl;
+    std::cout << ".. backtestFormat:     " << params.backtestFormat << std::endl;
+    std::cout << ".. walkForward:        " << params.walkForward << std::endl;
+    std::cout << ".. checkpointInterval: " << params.checkpointInterval << std::endl;
+    std::cout << ".. checkpointDir:      " << params.checkpointDir << std::endl;
+    std::cout << ".. warmStart:          " << params.warmStart << std::endl;
+    std::cout << ".. numActorThreads:    " << params.numActorThreads << std::endl;
+    std::cout << ".. actorBatchSize:     " << params.actorBatchSize << std::endl;
+    return os;
 }
 
 
@@ -7,18 +7,27 @@
 #include <thesis/LongShortPolicy.h>
 #include <thesis/GaussianDistribution.h>
 #include <thesis/PgpePolicy.h>
+#include <thesis/FixedDimensions.h>
 
 FactoryOfAgents& FactoryOfAgents::instance(size_t const &dimObservation_,
                                            LearningRate const &baselineLearningRate_,
                                            LearningRate const &criticLearningRate_,
                                            LearningRate const &actorLearningRate_,
-                                           double const &lambda_)
+                                           double const &lambda_,
+                                           std::string const &covariance_,
+                                           size_t covarianceRank_,
+                                           size_t covarianceBlockSize_,
+                                           size_t populationSize_)
 {
     static FactoryOfAgents factory(dimObservation_,
                                    baselineLearningRate_,
                                    criticLearningRate_,
                                    actorLearningRate_,
-                                   lambda_);
+                                   lambda_,
+                                   covariance_,
+                                   covarianceRank_,
+                                   covarianceBlockSize_,
+                                   populationSize_);
     return factory;
 }
 
@@ -26,12 +35,20 @@ FactoryOfAgents::FactoryOfAgents(size_t const &dimObservation_,
                                  LearningRate const &baselineLearningRate_,
                                  LearningRate const &criticLearningRate_,
                                  LearningRate const &actorLearningRate_,
-                                 double const &lambda_)
+                                 double const &lambda_,
+                                 std::string const &covariance_,
+                                 size_t covarianceRank_,
+                                 size_t covarianceBlockSize_,
+                                 size_t populationSize_)
     : dimObservation(dimObservation_),
       baselineLearningRatePtr(baselineLearningRate_.clone()),
       criticLearningRatePtr(criticLearningRate_.clone()),
       actorLearningRatePtr(actorLearningRate_.clone()),
-      lambda(lambda_)
+      lambda(lambda_),
+      covariance(covariance_),
+      covarianceRank(covarianceRank_),
+      covarianceBlockSize(covarianceBlockSize_),
+      populationSize(populationSize_)
 {
     /* Nothing to do */
 }
@@ -61,66 +78,91 @@ std::unique_ptr<Agent> FactoryOfAgents::make(std::string const &agentId) const
 // Builders //
 //----------//
 
-std::unique_ptr<ARACAgent> FactoryOfAgents::makeARACAgent() const
+std::unique_ptr<BoltzmannARACAgent> FactoryOfAgents::makeARACAgent() const
 {
     // State-value function critic
     LinearRegressor linearRegV(dimObservation);
 
     // Initialize critics
-    Critic critic(linearRegV);
+    BasicCritic<LinearRegressor> critic(linearRegV);
 
     // Boltzmann Policy
     std::vector<double> possibleAction {-1.0, 1.0};
     BoltzmannPolicy policy(dimObservation, possibleAction);
 
     // Stochastic Actor
-    StochasticActor actor(policy);
+    BasicStochasticActor<BoltzmannPolicy> actor(policy);
 
     // ARAC Agent
-    return std::unique_ptr<ARACAgent>(new ARACAgent(actor,
-                                                    critic,
-                                                    *baselineLearningRatePtr,
-                                                    *criticLearningRatePtr,
-                                                    *actorLearningRatePtr,
-                                                    lambda));
+    return std::unique_ptr<BoltzmannARACAgent>(new BoltzmannARACAgent(actor,
+                                                                      critic,
+                                                                      *baselineLearningRatePtr,
+                                                                      *criticLearningRatePtr,
+                                                                      *actorLearningRatePtr,
+                                                                      lambda));
 }
 
-std::unique_ptr<ARACAgent> FactoryOfAgents::makePGPEAgent() const
+std::unique_ptr<PGPEARACAgent> FactoryOfAgents::makePGPEAgent() const
 {
     // State-value function critic
     LinearRegressor linearRegV(dimObservation);
 
     // Initialize critics
-    Critic critic(linearRegV);
+    BasicCritic<LinearRegressor> critic(linearRegV);
 
     // Binary policy
-    BinaryPolicy controller(dimObservation);
-    GaussianDistribution distribution(controller.getDimParameters());
-    PGPEPolicy policy(controller, distribution, 1.0);
+    std::unique_ptr<Policy> controllerPtr = makeController();
+    GaussianDistribution distribution(controllerPtr->getDimParameters());
+    PGPEPolicy policy(*controllerPtr, distribution, 1.0);
 
     // Stochastic Actor
-    StochasticActor actor(policy);
+    BasicStochasticActor<PGPEPolicy> actor(policy);
 
     // ARAC Agent
-    return std::unique_ptr<ARACAgent> (new ARACAgent(actor,
-                                                     critic,
-                                                     *baselineLearningRatePtr,
-                                                     *criticLearningRatePtr,
-                                                     *actorLearningRatePtr,
-                                                     lambda));
+    return std::unique_ptr<PGPEARACAgent> (new PGPEARACAgent(actor,
+                                                             critic,
+                                                             *baselineLearningRatePtr,
+                                                             *criticLearningRatePtr,
+                                                             *actorLearningRatePtr,
+                                                             lambda));
 }
 
-std::unique_ptr<NPGPEAgent> FactoryOfAgents::makeNPGPEAgent() const
+std::unique_ptr<Agent> FactoryOfAgents::makeNPGPEAgent() const
 {
+#ifdef THESIS_FIXED_DAYS_OBSERVED
+    // PGPE Binary policy of fixed dimension
+    if (dimObservation == fixedSingleAssetDimObservation)
+        return makeNPGPEAgent(FixedSingleAssetPolicy());
+#endif
+
     // PGPE Binary policy
-    BinaryPolicy controller(dimObservation);
+    return makeNPGPEAgent(BinaryPolicy(dimObservation));
+}
+
+template<class PolicyT>
+std::unique_ptr<BasicNPGPEAgent<PolicyT>> FactoryOfAgents::makeNPGPEAgent(PolicyT const &controller_) const
+{
+    auto covariancePtr = makeParameterCovariance(covariance,
+                                                 controller_.getDimParameters(),
+                                                 covarianceRank,
+                                                 covarianceBlockSize);
 
     // NPGPE Agent
+    return  std::unique_ptr<BasicNPGPEAgent<PolicyT>> (new BasicNPGPEAgent<PolicyT>(controller_,
+                                                                                    *covariancePtr,
+                                                                                    *baselineLearningRatePtr,
+                                                                                    *actorLearningRatePtr,
+                                                                                    lambda,
+                                                                                    populationSize));
+}
 
-    return  std::unique_ptr<NPGPEAgent> (new NPGPEAgent(controller,
-                                                        *baselineLearningRatePtr,
-                                                        *actorLearningRatePtr,
-                                                        lambda));
+std::unique_ptr<Policy> FactoryOfAgents::makeController() const
+{
+#ifdef THESIS_FIXED_DAYS_OBSERVED
+    if (dimObservation == fixedSingleAssetDimObservation)
+        return std::unique_ptr<Policy>(new FixedSingleAssetPolicy());
+#endif
+    return std::unique_ptr<Policy>(new BinaryPolicy(dimObservation));
 }
 
 std::unique_ptr<ARRSACAgent> FactoryOfAgents::makeRSARACAgent() const
@@ -161,9 +203,9 @@ std::unique_ptr<ARRSACAgent> FactoryOfAgents::makeRSPGPEAgent() const
     Critic criticU(linearRegU);
 
     // Binary policy
-    BinaryPolicy controller(dimObservation);
-    GaussianDistribution distribution(controller.getDimParameters());
-    PGPEPolicy policy(controller, distribution, 1.0);
+    std::unique_ptr<Policy> controllerPtr = makeController();
+    GaussianDistribution distribution(controllerPtr->getDimParameters());
+    PGPEPolicy policy(*controllerPtr, distribution, 1.0);
 
     // Stochastic Actor
     StochasticActor actor(policy);
@@ -181,14 +223,20 @@ std::unique_ptr<ARRSACAgent> FactoryOfAgents::makeRSPGPEAgent() const
 std::unique_ptr<RiskSensitiveNPGPEAgent> FactoryOfAgents::makeRSNPGPEAgent() const
 {
     // Binary policy
-    BinaryPolicy controller(dimObservation);
+    std::unique_ptr<Policy> controllerPtr = makeController();
+    auto covariancePtr = makeParameterCovariance(covariance,
+                                                 controllerPtr->getDimParameters(),
+                                                 covarianceRank,
+                                                 covarianceBlockSize);
 
     // NPGPE Agent
     return std::unique_ptr<RiskSensitiveNPGPEAgent>
-        (new RiskSensitiveNPGPEAgent (controller,
+        (new RiskSensitiveNPGPEAgent (*controllerPtr,
+                                      *covariancePtr,
                                       *baselineLearningRatePtr,
                                       *actorLearningRatePtr,
-                                      lambda));
+                                      lambda,
+                                      populationSize));
 }
 
 
@@ -200,13 +248,21 @@ FactoryOfAgentsForTwoAssetsProblem& FactoryOfAgentsForTwoAssetsProblem::instance
                                            LearningRate const &baselineLearningRate_,
                                            LearningRate const &criticLearningRate_,
                                            LearningRate const &actorLearningRate_,
-                                           double const &lambda_)
+                                           double const &lambda_,
+                                           std::string const &covariance_,
+                                           size_t covarianceRank_,
+                                           size_t covarianceBlockSize_,
+                                           size_t populationSize_)
 {
     static FactoryOfAgentsForTwoAssetsProblem factory(dimObservation_,
                                                       baselineLearningRate_,
                                                       criticLearningRate_,
                                                       actorLearningRate_,
-                                                      lambda_);
+                                                      lambda_,
+                                                      covariance_,
+                                                      covarianceRank_,
+                                                      covarianceBlockSize_,
+                                                      populationSize_);
     return factory;
 }
 
@@ -214,12 +270,20 @@ FactoryOfAgentsForTwoAssetsProblem::FactoryOfAgentsForTwoAssetsProblem(size_t co
                                  LearningRate const &baselineLearningRate_,
                                  LearningRate const &criticLearningRate_,
                                  LearningRate const &actorLearningRate_,
-                                 double const &lambda_)
+                                 double const &lambda_,
+                                 std::string const &covariance_,
+                                 size_t covarianceRank_,
+                                 size_t covarianceBlockSize_,
+                                 size_t populationSize_)
     : dimObservation(dimObservation_),
       baselineLearningRatePtr(baselineLearningRate_.clone()),
       criticLearningRatePtr(criticLearningRate_.clone()),
       actorLearningRatePtr(actorLearningRate_.clone()),
-      lambda(lambda_)
+      lambda(lambda_),
+      covariance(covariance_),
+      covarianceRank(covarianceRank_),
+      covarianceBlockSize(covarianceBlockSize_),
+      populationSize(populationSize_)
 {
     /* Nothing to do */
 }
@@ -241,41 +305,56 @@ std::unique_ptr<Agent> FactoryOfAgentsForTwoAssetsProblem::make(std::string cons
 // Builders //
 //----------//
 
-std::unique_ptr<ARACAgent> FactoryOfAgentsForTwoAssetsProblem::makePGPEAgent() const
+std::unique_ptr<PGPEARACAgent> FactoryOfAgentsForTwoAssetsProblem::makePGPEAgent() const
 {
     // State-value function critic
     LinearRegressor linearRegV(dimObservation);
 
     // Initialize critics
-    Critic critic(linearRegV);
+    BasicCritic<LinearRegressor> critic(linearRegV);
 
     // Binary policy
-    LongShortPolicy controller(dimObservation);
-    GaussianDistribution distribution(controller.getDimParameters());
-    PGPEPolicy policy(controller, distribution, 1.0);
+    std::unique_ptr<Policy> controllerPtr = makeController();
+    GaussianDistribution distribution(controllerPtr->getDimParameters());
+    PGPEPolicy policy(*controllerPtr, distribution, 1.0);
 
     // Stochastic Actor
-    StochasticActor actor(policy);
+    BasicStochasticActor<PGPEPolicy> actor(policy);
 
     // ARAC Agent
-    return std::unique_ptr<ARACAgent> (new ARACAgent(actor,
-                                                     critic,
-                                                     *baselineLearningRatePtr,
-                                                     *criticLearningRatePtr,
-                                                     *actorLearningRatePtr,
-                                                     lambda));
+    return std::unique_ptr<PGPEARACAgent> (new PGPEARACAgent(actor,
+                                                             critic,
+                                                             *baselineLearningRatePtr,
+                                                             *criticLearningRatePtr,
+                                                             *actorLearningRatePtr,
+                                                             lambda));
+}
+
+std::unique_ptr<Policy> FactoryOfAgentsForTwoAssetsProblem::makeController() const
+{
+#ifdef THESIS_FIXED_DAYS_OBSERVED
+    if (dimObservation == fixedTwoAssetsDimObservation)
+        return std::unique_ptr<Policy>(new FixedTwoAssetsPolicy());
+#endif
+    return std::unique_ptr<Policy>(new LongShortPolicy(dimObservation));
 }
 
 std::unique_ptr<RiskSensitiveNPGPEAgent> FactoryOfAgentsForTwoAssetsProblem::makeRSNPGPEAgent() const
 {
     // Binary policy
-    LongShortPolicy controller(dimObservation);
+    std::unique_ptr<Policy> controllerPtr = makeController();
+    auto covariancePtr = makeParameterCovariance(covariance,
+                                                 controllerPtr->getDimParameters(),
+                                                 covarianceRank,
+                                                 covarianceBlockSize);
 
     // NPGPE Agent
     return std::unique_ptr<RiskSensitiveNPGPEAgent>
-        (new RiskSensitiveNPGPEAgent (controller,
+        (new RiskSensitiveNPGPEAgent (*controllerPtr,
+                                      *covariancePtr,
                                       *baselineLearningRatePtr,
                                       *actorLearningRatePtr,
-                                      lambda));
+                                      lambda,
+                                      populationSize));
 }
 
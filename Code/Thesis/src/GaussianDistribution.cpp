@@ -1,10 +1,11 @@
 #include "thesis/GaussianDistribution.h"
+#include "thesis/NormalSampler.h"
 
 GaussianDistribution::GaussianDistribution(size_t dimOutput_)
     : dimOutput(dimOutput_),
       dimParameters(2 * dimOutput_),
       parameters(2 * dimOutput_),
-      generator(16u)                    // eventually use random seed
+      generator(16u, RandomStream::Distribution)
 {
     initializeParameters();
 }
@@ -21,30 +22,47 @@ std::unique_ptr<ProbabilityDistribution> GaussianDistribution::clone() const
     return std::unique_ptr<ProbabilityDistribution>(new GaussianDistribution(*this));
 }
 
-arma::vec GaussianDistribution::simulate() const
+void GaussianDistribution::simulate(RealVec &simulation_) const
 {
-    arma::vec simulation(dimOutput);
+    simulation_.set_size(dimOutput);
+    fillStandardNormal(generator, simulation_);
     for (size_t i = 0; i < dimOutput; ++i)
-    {
-        std::normal_distribution<double> d(parameters[i], parameters[dimOutput+i]);
-        simulation[i] = d(generator);
-    }
-    return simulation;
+        simulation_[i] = parameters[i] + parameters[dimOutput+i] * simulation_[i];
 }
 
-arma::vec GaussianDistribution::likelihoodScore(arma::vec const &output_) const
+void GaussianDistribution::likelihoodScore(RealVec const &output_,
+                                           RealVec &likScore_) const
 {
-    arma::vec likScore(dimParameters);
-    arma::vec delta = output_ - parameters.rows(0, dimOutput-1);
-    arma::vec sigma = parameters.rows(dimOutput, dimParameters-1);
-    arma::vec sigma2 = sigma % sigma;
-    arma::vec sigma3 = sigma2 % sigma;
-    likScore.rows(0, dimOutput-1) = delta / sigma2;
-    likScore.rows(dimOutput, dimParameters-1) = delta % delta / sigma3 - 1.0 / sigma;
-    return likScore;
+    likScore_.set_size(dimParameters);
+    for (size_t i = 0; i < dimOutput; ++i)
+    {
+        double const delta = output_[i] - parameters[i];
+        double const sigma = parameters[dimOutput + i];
+        double const sigma2 = sigma * sigma;
+        double const sigma3 = sigma2 * sigma;
+        likScore_[i] = delta / sigma2;
+        likScore_[dimOutput + i] = delta * delta / sigma3 - 1.0 / sigma;
+    }
 }
 
 void GaussianDistribution::reset()
 {
     initializeParameters();
 }
+
+void GaussianDistribution::seed(unsigned int seed_)
+{
+    generator.seed(seed_, RandomStream::Distribution);
+}
+
+void GaussianDistribution::saveState(CheckpointWriter &writer_) const
+{
+    writer_.write(parameters);
+    writer_.write(generator);
+}
+
+void GaussianDistribution::loadState(CheckpointReader &reader_)
+{
+    reader_.read(parameters);
+    reader_.read(generator);
+}
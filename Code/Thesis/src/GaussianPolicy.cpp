@@ -1,16 +1,33 @@
 #include "thesis/GaussianPolicy.h"
-#include <random>
+#include "thesis/NormalSampler.h"
 
 GaussianPolicy::GaussianPolicy(size_t dimObservation_,
                                size_t dimAction_)
     : StochasticPolicy(dimObservation_, dimAction_),
       dimParameters((dimObservation_ + 1) * dimAction_ + 1),
       parameters(dimParameters),
-      psiMat(parameters.memptr(), dimObservation_ + 1, dimAction_, false, false)
+      psiMat(parameters.memptr(), dimObservation_ + 1, dimAction_, false, false),
+      generator(0, RandomStream::Policy),
+      features(dimObservation_ + 1),
+      mean(dimAction_),
+      deltaAction(dimAction_)
 {
     initializeParameters();
 }
 
+GaussianPolicy::GaussianPolicy(GaussianPolicy const &other_)
+    : StochasticPolicy(other_.getDimObservation(), other_.getDimAction()),
+      dimParameters(other_.dimParameters),
+      parameters(other_.parameters),
+      psiMat(parameters.memptr(), other_.psiMat.n_rows, other_.psiMat.n_cols, false, false),
+      generator(other_.generator),
+      features(other_.features),
+      mean(other_.mean),
+      deltaAction(other_.deltaAction)
+{
+    /* Nothing to do */
+}
+
 void GaussianPolicy::initializeParameters()
 {
     psiMat.randu();
@@ -19,68 +36,63 @@ void GaussianPolicy::initializeParameters()
     parameters(dimParameters - 1) = 1;  // sigma
 }
 
-arma::vec GaussianPolicy::getParameters() const
+void GaussianPolicy::getParameters(RealVec &parameters_) const
 {
-    return parameters;
+    parameters_ = parameters;
 }
 
-void GaussianPolicy::setParameters(arma::vec const &parameters_)
+void GaussianPolicy::setParameters(RealVec const &parameters_)
 {
     parameters = parameters_;
     if (parameters(dimParameters - 1) < 0)
         parameters(dimParameters - 1) = 0.01;
 }
 
-arma::vec GaussianPolicy::getAction(arma::vec const &observation_) const
+void GaussianPolicy::getAction(RealVec const &observation_,
+                               RealVec &action_) const
 {
     // Compute features
-    arma::vec features(getDimObservation() + 1, arma::fill::zeros);
     features(0) = 1.0;
     features.rows(1, features.size() - 1) = observation_;
 
     // Compute mean
-    arma::vec mean = psiMat.t() * features;
+    mean = psiMat.t() * features;
     double stddev = parameters(dimParameters - 1);
 
     // Simulate action
-    arma::vec action(getDimAction());
+    action_.set_size(getDimAction());
+    fillStandardNormal(generator, action_);
     for (size_t i = 0; i < getDimAction(); ++i)
-    {
-        std::normal_distribution<double> d(mean[i], stddev);
-        action[i] = d(generator);
-    }
-    return action;
+        action_[i] = mean[i] + stddev * action_[i];
 }
 
-arma::vec GaussianPolicy::likelihoodScore(arma::vec const &observation_,
-                                          arma::vec const &action_) const
+void GaussianPolicy::likelihoodScore(RealVec const &observation_,
+                                     RealVec const &action_,
+                                     RealVec &likScore_) const
 {
     // Compute features
-    arma::vec features(getDimObservation() + 1);
     features(0) = 1.0;
     features.rows(1, features.size() - 1) = observation_;
 
     // Compute mean and stddev
-    arma::vec mean = psiMat.t() * features;
+    mean = psiMat.t() * features;
     double stddev = parameters(dimParameters - 1);
     double stddev2 = stddev * stddev;
     double stddev3 = stddev2 * stddev;
 
     // Compute gradient with respect to parameters
-    arma::vec deltaAction = action_ - mean;
-    arma::vec gradientMean = deltaAction / stddev2;
+    deltaAction = action_ - mean;
     double gradientSigma = arma::norm(deltaAction, 2) / stddev3 - getDimAction() / stddev;
 
     // Compute gradient with respect to mean hyperparameters
-    arma::vec likScore(dimParameters, arma::fill::zeros);
-    likScore(dimParameters - 1) = gradientSigma;
+    likScore_.set_size(dimParameters);
+    likScore_(dimParameters - 1) = gradientSigma;
     for (size_t i = 0; i < getDimAction(); ++i)
     {
-        likScore.rows((getDimObservation() + 1) * i,
-                      (getDimObservation() + 1) * (i + 1) - 1) =
-            features * gradientMean(i);
+        likScore_.rows((getDimObservation() + 1) * i,
+                       (getDimObservation() + 1) * (i + 1) - 1) =
+            features * (deltaAction(i) / stddev2);
     }
-    return likScore;
 }
 
 std::unique_ptr<Policy> GaussianPolicy::cloneImpl() const
@@ -92,3 +104,20 @@ void GaussianPolicy::reset()
 {
     initializeParameters();
 }
+
+void GaussianPolicy::seed(unsigned int seed_)
+{
+    generator.seed(seed_, RandomStream::Policy);
+}
+
+void GaussianPolicy::saveState(CheckpointWriter &writer_) const
+{
+    writer_.write(parameters);
+    writer_.write(generator);
+}
+
+void GaussianPolicy::loadState(CheckpointReader &reader_)
+{
+    reader_.read(parameters);
+    reader_.read(generator);
+}
@@ -21,3 +21,17 @@ void DecayingLearningRate::reset()
     currentIteration = 1ul;
     learningRate = c;
 }
+
+void DecayingLearningRate::saveState(CheckpointWriter &writer_) const
+{
+    writer_.write(static_cast<uint64_t>(currentIteration));
+    writer_.write(learningRate);
+}
+
+void DecayingLearningRate::loadState(CheckpointReader &reader_)
+{
+    uint64_t iteration = 0;
+    reader_.read(iteration);
+    currentIteration = iteration;
+    reader_.read(learningRate);
+}
@@ -18,27 +18,26 @@ std::unique_ptr<FunctionApproximator> LinearRegressor::clone() const
     return std::unique_ptr<FunctionApproximator>(new LinearRegressor(*this));
 }
 
-arma::vec LinearRegressor::getParameters() const
+void LinearRegressor::getParameters(RealVec &parameters_) const
 {
-    return parameters;
+    parameters_ = parameters;
 }
 
-void LinearRegressor::setParameters(arma::vec const &parameters_)
+void LinearRegressor::setParameters(RealVec const &parameters_)
 {
     parameters = parameters_;
 }
 
-double LinearRegressor::evaluate(arma::vec const &x) const
+double LinearRegressor::evaluate(RealVec const &x) const
 {
     return parameters(0) + arma::dot(parameters.rows(1, getDimParameters()-1), x);
 }
 
-arma::vec LinearRegressor::gradient(arma::vec const &x) const
+void LinearRegressor::gradient(RealVec const &x, RealVec &grad_) const
 {
-    arma::vec grad(getDimParameters());
-    grad(0) = 1.0;
-    grad.rows(1, getDimParameters() - 1) = x;
-    return grad;
+    grad_.set_size(getDimParameters());
+    grad_(0) = 1.0;
+    grad_.rows(1, getDimParameters() - 1) = x;
 }
 
 void LinearRegressor::reset()
@@ -7,8 +7,9 @@ LogisticPolicy::LogisticPolicy(size_t dimObservation_,
     : Policy(dimObservation_, 1ul),
       dimParameters(dimObservation_ + 1),
       parameters(dimObservation_ + 1),
-      paramMinValue(paramMinValue_),
-      paramMaxValue(paramMaxValue_)
+      paramMinValue(toRealBound(paramMinValue_)),
+      paramMaxValue(toRealBound(paramMaxValue_)),
+      features(dimObservation_ + 1)
 {
     initializeParameters();
 }
@@ -20,23 +21,22 @@ void LogisticPolicy::initializeParameters()
     parameters *= 0.001;
 }
 
-void LogisticPolicy::setParameters(arma::vec const & parameters_)
+void LogisticPolicy::setParameters(RealVec const & parameters_)
 {
     parameters = arma::clamp(parameters_, paramMinValue, paramMaxValue);;
 }
 
-arma::vec LogisticPolicy::getAction(arma::vec const & observation_) const
+void LogisticPolicy::getAction(RealVec const & observation_,
+                               RealVec &action_) const
 {
     // Compute features
-    arma::vec features(dimParameters);
     features(0) = 1.0;
     features.rows(1, dimParameters - 1) = observation_;
 
     // Compute action
-    double activation = arma::dot(parameters, features);
-    arma::vec action(1);
-    action(0) = std::tanh(activation);
-    return action;
+    Real activation = arma::dot(parameters, features);
+    action_.set_size(1);
+    action_(0) = std::tanh(activation);
 }
 
 void LogisticPolicy::reset()
@@ -1,4 +1,5 @@
 #include "thesis/LongShortPolicy.h"
+#include <algorithm>  /* std::min, std::max */
 
 LongShortPolicy::LongShortPolicy(size_t dimObservation_,
                            double paramMinValue_,
@@ -6,8 +7,9 @@ LongShortPolicy::LongShortPolicy(size_t dimObservation_,
     : Policy(dimObservation_, 2ul),
       dimParameters(dimObservation_ + 1),
       parameters(dimObservation_ + 1),
-      paramMinValue(paramMinValue_),
-      paramMaxValue(paramMaxValue_)
+      paramMinValue(toRealBound(paramMinValue_)),
+      paramMaxValue(toRealBound(paramMaxValue_)),
+      features(dimObservation_ + 1)
 {
     initializeParameters();
 }
@@ -19,24 +21,45 @@ void LongShortPolicy::initializeParameters()
     parameters *= 0.001;
 }
 
-void LongShortPolicy::setParameters(arma::vec const & parameters_)
+void LongShortPolicy::setParameters(RealVec const & parameters_)
 {
     parameters = arma::clamp(parameters_, paramMinValue, paramMaxValue);
 }
 
-arma::vec LongShortPolicy::getAction(arma::vec const & observation_) const
+void LongShortPolicy::getAction(RealVec const & observation_,
+                                RealVec &action_) const
 {
     // Compute features
-    arma::vec features(dimParameters);
     features(0) = 1.0;
     features.rows(1, dimParameters - 1) = observation_;
 
     // Compute action
-    double activation = arma::dot(parameters, features);
-    arma::vec action(2);
-    action(0) = (activation > 0.0) ? 1.0 : -1.0;
-    action(1) = - action(0);
-    return action;
+    Real activation = arma::dot(parameters, features);
+    action_.set_size(2);
+    action_(0) = (activation > 0.0) ? 1.0 : -1.0;
+    action_(1) = - action_(0);
+}
+
+void LongShortPolicy::getActions(RealVec const & observation_,
+                                 RealMat &parameters_,
+                                 RealMat &actions_) const
+{
+    // Enforce parameters bounds
+    parameters_.transform( [&](Real p) {
+        return std::min(std::max(p, paramMinValue), paramMaxValue); } );
+
+    // Compute features
+    features(0) = 1.0;
+    features.rows(1, dimParameters - 1) = observation_;
+
+    // Compute actions
+    activations = parameters_.t() * features;
+    actions_.set_size(2, parameters_.n_cols);
+    for (size_t j = 0; j < parameters_.n_cols; ++j)
+    {
+        actions_(0, j) = (activations(j) > 0.0) ? 1.0 : -1.0;
+        actions_(1, j) = - actions_(0, j);
+    }
 }
 
 void LongShortPolicy::reset()
@@ -0,0 +1,89 @@
+#include <thesis/MarketData.h>
+#include <fstream>    /* std::ifstream */
+#include <sstream>    /* std::istringstream */
+#include <stdexcept>  /* std::invalid_argument */
+
+MarketData::MarketData(std::string const &inputFilePath)
+    : dataFilePtr(MarketDataFile::isMarketDataFile(inputFilePath) ?
+                  new MarketDataFile(inputFilePath) : nullptr),
+      // Binary input: use the mapped log-returns in place (strict aux memory)
+      assetsReturns(dataFilePtr ? const_cast<double *>(dataFilePtr->getReturns()) : nullptr,
+                    dataFilePtr ? dataFilePtr->getNumRiskyAssets() : 0,
+                    dataFilePtr ? dataFilePtr->getNumDays() : 0,
+                    false,
+                    dataFilePtr != nullptr)
+{
+    if (dataFilePtr)
+    {
+        assetsSymbols = dataFilePtr->getAssetsSymbols();
+        numDays = dataFilePtr->getNumDays();
+        numRiskyAssets = dataFilePtr->getNumRiskyAssets();
+    }
+    else
+    {
+        readCsv(inputFilePath);
+    }
+}
+
+MarketData::MarketData(std::vector<std::string> const &assetsSymbols_,
+                       arma::mat const &assetsReturns_)
+    : assetsSymbols(assetsSymbols_),
+      assetsReturns(assetsReturns_),
+      numDays(assetsReturns_.n_cols),
+      numRiskyAssets(assetsReturns_.n_rows)
+{
+    /* Nothing to do */
+}
+
+void MarketData::readCsv(std::string const &inputFilePath)
+{
+	// Initialize filestream from inputFilePath
+	std::ifstream ifs(inputFilePath);
+	std::string line;
+    char ch;
+
+    // Check file opening
+    if (!ifs)
+    {
+        throw std::invalid_argument("Input file doesn't exist");
+    }
+
+	// Read number of days and number of risky assets from the first line
+	if (getline(ifs, line))
+	{
+		std::istringstream linestream(line);
+		linestream >> numDays >> ch >> numRiskyAssets;
+	}
+
+	// Read risky assets symbols from the second line
+	if (getline(ifs, line))
+	{
+		std::istringstream linestream(line);
+		std::string symbol;
+
+		for(size_t i = 0; i < numRiskyAssets && getline(linestream, symbol, ','); i++)
+		{
+            assetsSymbols.push_back(symbol);
+		}
+	}
+
+	// Read risky assets log-returns in an armadillo matrix.
+	assetsReturns.set_size(numRiskyAssets, numDays);
+	double oneReturn = 0.0;
+	for(size_t i = 0; i < numDays && getline(ifs, line); ++i)
+	{
+		std::istringstream linestream(line);
+		for(size_t j = 0; j < numRiskyAssets && linestream >> oneReturn; ++j)
+		{
+			assetsReturns(j, i) = oneReturn;
+
+			if (linestream.peek() == ',')
+                linestream.ignore();
+		}
+	}
+}
+
+void MarketData::save(std::string const &outputFilePath) const
+{
+    MarketDataFile::write(outputFilePath, assetsSymbols, assetsReturns);
+}
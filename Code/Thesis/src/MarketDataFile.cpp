@@ -0,0 +1,152 @@
+#include <thesis/MarketDataFile.h>
+#include <cstring>    /* std::memcmp, std::memcpy */
+#include <fstream>    /* std::ifstream, std::ofstream */
+#include <sstream>    /* std::istringstream */
+#include <stdexcept>  /* std::invalid_argument, std::runtime_error */
+#include <fcntl.h>    /* open */
+#include <sys/mman.h> /* mmap, munmap */
+#include <sys/stat.h> /* fstat */
+#include <unistd.h>   /* close */
+
+//! Binary format constants
+static char const magicNumber[8] = {'T', 'H', 'R', 'E', 'T', 'B', 'I', 'N'};
+static uint32_t const formatVersion = 1;
+static size_t const dataAlignment = 64;
+
+//! Fixed-size part of the binary header
+struct MarketDataFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t dataOffset;
+    uint64_t numDays;
+    uint64_t numRiskyAssets;
+    uint64_t symbolsSize;
+};
+
+/*
+ * Check the header against the size of the file. The fields are untrusted,
+ * hence the sizes are compared with subtractions and divisions of bounded
+ * values, which cannot wrap around on a corrupted file.
+ */
+static bool isValidHeader(MarketDataFileHeader const &header, size_t fileSize)
+{
+    if (std::memcmp(header.magic, magicNumber, sizeof(magicNumber)) != 0 ||
+        header.version != formatVersion ||
+        header.dataOffset % dataAlignment != 0 ||
+        header.dataOffset > fileSize)
+        return false;
+
+    // Symbols between the fixed-size header and the log-returns
+    if (header.symbolsSize > fileSize - sizeof(header) ||
+        header.dataOffset < sizeof(header) + header.symbolsSize)
+        return false;
+
+    // Log-returns within the file
+    uint64_t const maxNumValues = (fileSize - header.dataOffset) / sizeof(double);
+    return header.numRiskyAssets == 0 ||
+           header.numDays <= maxNumValues / header.numRiskyAssets;
+}
+
+MarketDataFile::MarketDataFile(std::string const &filePath)
+    : numDays(0),
+      numRiskyAssets(0),
+      mapping(MAP_FAILED),
+      mappingSize(0),
+      returns(nullptr)
+{
+    // Open file and get its size
+    int fd = open(filePath.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        throw std::invalid_argument("Input file doesn't exist");
+    }
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0 ||
+        static_cast<size_t>(fileStat.st_size) < sizeof(MarketDataFileHeader))
+    {
+        close(fd);
+        throw std::runtime_error("Invalid binary return series " + filePath);
+    }
+    mappingSize = static_cast<size_t>(fileStat.st_size);
+
+    // Map the whole file. The descriptor can be closed right away.
+    mapping = mmap(nullptr, mappingSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+    {
+        throw std::runtime_error("Cannot map binary return series " + filePath);
+    }
+
+    // Validate header
+    MarketDataFileHeader header;
+    std::memcpy(&header, mapping, sizeof(header));
+    if (!isValidHeader(header, mappingSize))
+    {
+        munmap(mapping, mappingSize);
+        throw std::runtime_error("Invalid binary return series " + filePath);
+    }
+    numDays = header.numDays;
+    numRiskyAssets = header.numRiskyAssets;
+
+    // Read assets symbols
+    char const *base = static_cast<char const *>(mapping);
+    std::istringstream symbolsStream(std::string(base + sizeof(header), header.symbolsSize));
+    std::string symbol;
+    while (std::getline(symbolsStream, symbol, ','))
+        assetsSymbols.push_back(symbol);
+
+    // Log-returns
+    returns = reinterpret_cast<double const *>(base + header.dataOffset);
+}
+
+MarketDataFile::~MarketDataFile()
+{
+    if (mapping != MAP_FAILED)
+        munmap(mapping, mappingSize);
+}
+
+bool MarketDataFile::isMarketDataFile(std::string const &filePath)
+{
+    std::ifstream ifs(filePath, std::ios::binary);
+    char magic[sizeof(magicNumber)];
+    return ifs.read(magic, sizeof(magic)) &&
+           std::memcmp(magic, magicNumber, sizeof(magicNumber)) == 0;
+}
+
+void MarketDataFile::write(std::string const &filePath,
+                           std::vector<std::string> const &assetsSymbols_,
+                           arma::mat const &assetsReturns_)
+{
+    // Comma-separated symbols
+    std::string symbols;
+    for (size_t i = 0; i < assetsSymbols_.size(); ++i)
+        symbols += (i > 0 ? "," : "") + assetsSymbols_[i];
+
+    // Header
+    MarketDataFileHeader header;
+    std::memcpy(header.magic, magicNumber, sizeof(magicNumber));
+    header.version = formatVersion;
+    header.dataOffset = static_cast<uint32_t>(
+        (sizeof(header) + symbols.size() + dataAlignment - 1) / dataAlignment * dataAlignment);
+    header.numDays = assetsReturns_.n_cols;
+    header.numRiskyAssets = assetsReturns_.n_rows;
+    header.symbolsSize = symbols.size();
+
+    // Write header, symbols, padding and log-returns
+    std::ofstream ofs(filePath, std::ios::binary | std::ios::trunc);
+    if (!ofs)
+    {
+        throw std::invalid_argument("Cannot open output file " + filePath);
+    }
+    std::string padding(header.dataOffset - sizeof(header) - symbols.size(), '\0');
+    ofs.write(reinterpret_cast<char const *>(&header), sizeof(header));
+    ofs.write(symbols.data(), symbols.size());
+    ofs.write(padding.data(), padding.size());
+    ofs.write(reinterpret_cast<char const *>(assetsReturns_.memptr()),
+              assetsReturns_.n_elem * sizeof(double));
+    if (!ofs)
+    {
+        throw std::runtime_error("Error while writing " + filePath);
+    }
+}
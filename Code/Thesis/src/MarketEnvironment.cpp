@@ -1,74 +1,38 @@
 #include <thesis/MarketEnvironment.h>
-#include <fstream>    /* std::ifstream */
-#include <sstream>    /* std::istringstream */
-#include <stdexcept>  /* std::invalid_argument */
+#include <stdexcept>
 
 MarketEnvironment::MarketEnvironment (std::string inputFilePath)
-    : Environment()
+    : MarketEnvironment(std::make_shared<MarketData const>(inputFilePath))
 {
-	// Initialize filestream from inputFilePath
-	std::ifstream ifs(inputFilePath);
-	std::string line;
-    char ch;
-
-    // Check file opening
-    if (!ifs)
-    {
-        throw std::invalid_argument("Input file doesn't exist");
-    }
-
-	// Read number of days and number of risky assets from the first line
-	if (getline(ifs, line))
-	{
-		std::istringstream linestream(line);
-		linestream >> numDays >> ch >> numRiskyAssets;
-	}
-
-	// Read risky assets symbols from the second line
-	if (getline(ifs, line))
-	{
-		std::istringstream linestream(line);
-		std::string symbol;
-
-		for(size_t i = 0; i < numRiskyAssets && linestream >> symbol; i++)
-		{
-            assetsSymbols.push_back(symbol);
-            if (linestream.peek() == ',')
-                linestream.ignore();
-		}
-	}
-
-	// Read risky assets log-returns in an armadillo matrix.
-	assetsReturns.set_size(numRiskyAssets, numDays);
-	double oneReturn = 0.0;
-	for(size_t i = 0; i < numDays && getline(ifs, line); ++i)
-	{
-		std::istringstream linestream(line);
-		for(size_t j = 0; j < numRiskyAssets && linestream >> oneReturn; ++j)
-		{
-			assetsReturns(j, i) = oneReturn;
-
-			if (linestream.peek() == ',')
-                linestream.ignore();
-		}
-	}
+    /* Nothing to do. */
+}
 
-	// Set dimensions of state and action spaces
-	dimState = numRiskyAssets;
-	dimAction = numRiskyAssets;
+MarketEnvironment::MarketEnvironment(std::shared_ptr<MarketData const> marketDataPtr_)
+    : Environment(),
+      marketDataPtr(marketDataPtr_),
+      dimState(marketDataPtr_->getNumRiskyAssets()),
+      dimAction(marketDataPtr_->getNumRiskyAssets()),
+      startDate(0),
+      currentDate(0),
+      endDate(marketDataPtr_->getNumDays() - 1)
+{
+    /* Nothing to do. */
+}
 
-    // Set time steps
-    startDate = 0;
-    currentDate = startDate;
-    endDate = numDays - 1;
+MarketEnvironment::MarketEnvironment(size_t numRiskyAssets_, size_t numDays_)
+    : Environment(),
+      dimState(numRiskyAssets_),
+      dimAction(numRiskyAssets_),
+      startDate(0),
+      currentDate(0),
+      endDate(numDays_ - 1)
+{
+    /* Nothing to do. */
 }
 
 MarketEnvironment::MarketEnvironment(MarketEnvironment const &market_)
     : Environment(),
-      assetsSymbols(market_.assetsSymbols),
-      assetsReturns(market_.assetsReturns),
-      numDays(market_.numDays),
-      numRiskyAssets(market_.numRiskyAssets),
+      marketDataPtr(market_.marketDataPtr),
       dimState(market_.dimState),
       dimAction(market_.dimAction),
       startDate(market_.startDate),
@@ -85,7 +49,12 @@ std::unique_ptr<Environment> MarketEnvironment::clone() const
 
 arma::vec MarketEnvironment::getState() const
 {
-	return assetsReturns.col(currentDate);
+	return marketDataPtr->getAssetsReturns().col(currentDate);
+}
+
+void MarketEnvironment::getState(arma::vec &state_) const
+{
+	state_ = marketDataPtr->getAssetsReturns().col(currentDate);
 }
 
 void MarketEnvironment::performAction(arma::vec const &action)
@@ -105,3 +74,10 @@ void MarketEnvironment::reset()
 {
 	currentDate = startDate;
 }
+
+void MarketEnvironment::save(std::string const &outputFilePath) const
+{
+    if (!marketDataPtr)
+        throw std::logic_error("MarketEnvironment::save: the return series are not stored");
+    marketDataPtr->save(outputFilePath);
+}
@@ -1,68 +1,97 @@
 #include "thesis/NpgpePolicy.h"
+#include "thesis/NormalSampler.h"
+#include <stdexcept>  /* std::invalid_argument, std::logic_error */
 
 NPGPEPolicy::NPGPEPolicy(Policy const &policy_,
                          double resamplingProbability_)
+    : NPGPEPolicy(policy_,
+                  TriangularCovariance(policy_.getDimParameters()),
+                  resamplingProbability_)
+{
+    // Nothing to do
+}
+
+NPGPEPolicy::NPGPEPolicy(Policy const &policy_,
+                         ParameterCovariance const &covariance_,
+                         double resamplingProbability_)
     : StochasticPolicy(policy_.getDimObservation(), policy_.getDimAction()),
       policyPtr(policy_.clone()),
-      resamplingProbability(resamplingProbability_),
+      covariancePtr(covariance_.clone()),
       dimParameters(policy_.getDimParameters()),
-      dimHyperParameters(dimParameters * (dimParameters + 1)),
+      dimHyperParameters(dimParameters + covariance_.getDimFactor()),
       parameters(dimHyperParameters, arma::fill::zeros),
       mean(parameters.memptr(), dimParameters, false, false),
-      cholFactor(parameters.memptr() + dimParameters, dimParameters, dimParameters, false, false),
-      xi(dimParameters),
-      generator(214),
-      gaussianDistr(0.0, 1.0)
+      covarianceFactor(parameters.memptr() + dimParameters, covariance_.getDimFactor(), false, false),
+      xi(covariance_.getDimNoise()),
+      controllerParameters(dimParameters),
+      resamplingProbability(resamplingProbability_),
+      generator(214, RandomStream::Policy)
 {
+    if (covariance_.getDimParameters() != dimParameters)
+        throw std::invalid_argument("Covariance structure does not match the controller parameters");
     initializeParameters();
 }
 
 void NPGPEPolicy::initializeParameters()
 {
     parameters.zeros();
-    cholFactor.diag().ones();
-    cholFactor *= 0.1;
+    covariancePtr->initializeFactor(0.1, covarianceFactor);
 }
 
 NPGPEPolicy::NPGPEPolicy(NPGPEPolicy const &other_)
     : StochasticPolicy(other_.getDimObservation(), other_.getDimAction()),
       policyPtr(other_.policyPtr->clone()),
-      resamplingProbability(other_.resamplingProbability),
+      covariancePtr(other_.covariancePtr->clone()),
       dimParameters(other_.dimParameters),
       dimHyperParameters(other_.dimHyperParameters),
       parameters(other_.parameters),
       mean(parameters.memptr(), dimParameters, false, false),
-      cholFactor(parameters.memptr() + dimParameters, dimParameters, dimParameters, false, false),
+      covarianceFactor(parameters.memptr() + dimParameters, dimHyperParameters - dimParameters, false, false),
       xi(other_.xi),
-      generator(other_.generator()),
-      gaussianDistr(other_.gaussianDistr)
+      controllerParameters(dimParameters),
+      resamplingProbability(other_.resamplingProbability),
+      generator(other_.generator)
 {
     // Nothing to do
 }
 
-arma::vec NPGPEPolicy::getAction(arma::vec const &observation_) const
+void NPGPEPolicy::getAction(RealVec const &observation_,
+                            RealVec &action_) const
 {
-    // Simulate policy parameters: w = mean + cholFactor' * xi
-    xi.imbue( [&]() { return gaussianDistr(generator); } );
-    arma::vec newPolicyParameters = mean + cholFactor.t() * xi;
-    policyPtr->setParameters(newPolicyParameters);
+    // Simulate policy parameters: w = mean + perturbation(F, xi)
+    fillStandardNormal(generator, xi);
+    covariancePtr->perturbation(covarianceFactor, xi, controllerParameters);
+    controllerParameters += mean;
+    policyPtr->setParameters(controllerParameters);
 
     // Select action
-    return policyPtr->getAction(observation_);
+    policyPtr->getAction(observation_, action_);
+}
+
+void NPGPEPolicy::likelihoodScore(RealVec const &observation_,
+                                  RealVec const &action_,
+                                  RealVec &likScore_) const
+{
+    likScore_.set_size(dimHyperParameters);
+
+    // Likelihood score with respect to the mean
+    policyPtr->getParameters(controllerParameters);
+    for (size_t i = 0; i < dimParameters; ++i)
+        likScore_(i) = controllerParameters(i) - mean(i);
+
+    // Likelihood score with respect to the covariance factor, written in place
+    // into the tail of likScore_
+    RealVec likScoreMean(likScore_.memptr(), dimParameters, false, true);
+    RealVec likScoreFactor(likScore_.memptr() + dimParameters,
+                             dimHyperParameters - dimParameters, false, true);
+    covariancePtr->factorScore(covarianceFactor, xi, likScoreMean, likScoreFactor);
 }
 
-arma::vec NPGPEPolicy::likelihoodScore(arma::vec const &observation_,
-                                       arma::vec const &action_) const
+void NPGPEPolicy::behaviourLikelihoodScore(RealVec const &observation_,
+                                            RealVec const &action_,
+                                            RealVec &likScore_) const
 {
-    arma::vec likScore(dimHyperParameters);
-    arma::vec policyParameters = policyPtr->getParameters();
-    likScore.rows(0, dimParameters-1) = policyParameters - mean;
-    likScore.rows(dimParameters, dimHyperParameters-1) = arma::vectorise(
-        (arma::trimatu(xi * xi.t()) -
-         0.5 * arma::diagmat(xi * xi.t()) -
-         0.5 * arma::diagmat(arma::eye(dimParameters, dimParameters))) *
-         cholFactor);
-    return likScore;
+    throw std::logic_error("NPGPEPolicy cannot score the actions selected by another copy");
 }
 
 void NPGPEPolicy::reset()
@@ -71,6 +100,31 @@ void NPGPEPolicy::reset()
     initializeParameters();
 }
 
+void NPGPEPolicy::seed(unsigned int seed_)
+{
+    generator.seed(seed_, RandomStream::Policy);
+    randDistr.reset();
+    policyPtr->seed(seed_ + 1);
+}
+
+void NPGPEPolicy::saveState(CheckpointWriter &writer_) const
+{
+    writer_.write(parameters);
+    writer_.write(xi);
+    writer_.write(generator);
+    policyPtr->saveState(writer_);
+}
+
+void NPGPEPolicy::loadState(CheckpointReader &reader_)
+{
+    // mean and covarianceFactor share memory with parameters
+    reader_.read(parameters);
+    reader_.read(xi);
+    reader_.read(generator);
+    randDistr.reset();
+    policyPtr->loadState(reader_);
+}
+
 std::unique_ptr<Policy> NPGPEPolicy::cloneImpl() const
 {
     return std::unique_ptr<Policy>(new NPGPEPolicy(*this));
@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <thesis/NormalSampler.h>
+#include <algorithm>  /* std::min */
+#include <cmath>      /* std::log, std::sqrt, std::cos, std::sin */
+#include <cstdint>
+
+namespace
+{
+
+//! Number of Philox blocks, i.e. pairs of normal variates, per batch.
+size_t const batchSize = 64;
+
+//! 2 pi and 2^-53
+double const twoPi = 6.283185307179586476925286766559;
+double const uniformResolution = 1.0 / 9007199254740992.0;
+
+/*!
+ * Uniform variate in the open interval (0, 1) from the 53 most significant
+ * bits of two 32-bit words.
+ */
+inline double openUniform(uint32_t high_, uint32_t low_)
+{
+    uint64_t const bits = ((static_cast<uint64_t>(high_) << 32) | low_) >> 11;
+    return (static_cast<double>(bits) + 0.5) * uniformResolution;
+}
+
+/*!
+ * Fill an array of any floating-point type with standard normal variates,
+ * which are computed in double precision.
+ */
+template<typename eT>
+void fillStandardNormalArray(Philox4x32 &generator_, eT *values_, size_t numValues_)
+{
+    if (numValues_ == 0)
+        return;
+
+    uint32_t const key[2] = {generator_.getSeed(), generator_.getComponent()};
+    uint64_t const step = generator_.getStep();
+    uint64_t block = (generator_.getPosition() + 3) / 4;
+
+    double radius[batchSize];
+    double angle[batchSize];
+    uint32_t words[4];
+    size_t idx = 0;
+    while (idx < numValues_)
+    {
+        size_t const numPairs = std::min(batchSize, (numValues_ - idx + 1) / 2);
+
+        // Uniform pairs from consecutive blocks of the stream
+        for (size_t k = 0; k < numPairs; ++k, ++block)
+        {
+            uint32_t const counter[4] = {static_cast<uint32_t>(block),
+                                         static_cast<uint32_t>(block >> 32),
+                                         static_cast<uint32_t>(step),
+                                         static_cast<uint32_t>(step >> 32)};
+            Philox4x32::generateBlock(counter, key, words);
+            radius[k] = openUniform(words[0], words[1]);
+            angle[k] = openUniform(words[2], words[3]);
+        }
+
+        // Box-Muller transform
+        for (size_t k = 0; k < numPairs; ++k)
+        {
+            radius[k] = std::sqrt(-2.0 * std::log(radius[k]));
+            angle[k] *= twoPi;
+        }
+
+        // Scatter the pairs, the last one is truncated for an odd size
+        for (size_t k = 0; k < numPairs; ++k)
+        {
+            values_[idx++] = static_cast<eT>(radius[k] * std::cos(angle[k]));
+            if (idx < numValues_)
+                values_[idx++] = static_cast<eT>(radius[k] * std::sin(angle[k]));
+        }
+    }
+    generator_.setPosition(4 * block);
+}
+
+} // namespace
+
+void fillStandardNormal(Philox4x32 &generator_, double *values_, size_t numValues_)
+{
+    fillStandardNormalArray(generator_, values_, numValues_);
+}
+
+void fillStandardNormal(Philox4x32 &generator_, float *values_, size_t numValues_)
+{
+    fillStandardNormalArray(generator_, values_, numValues_);
+}
@@ -1,100 +1,188 @@
 #include "thesis/NpgpeAgent.h"
+#include "thesis/FixedDimensions.h"
+#include "thesis/NormalSampler.h"
+#include <stdexcept>  /* std::invalid_argument */
 #include <math.h>       /* sqrt */
 
-NPGPEAgent::NPGPEAgent(Policy const &policy_,
-                       LearningRate const &baselineLearningRate_,
-                       LearningRate const &hyperparamsLearningRate_,
-                       double lambda_)
-    : policyPtr(policy_.clone()),
-      baselineLearningRatePtr(baselineLearningRate_.clone()),
-      hyperparamsLearningRatePtr(hyperparamsLearningRate_.clone()),
+template<class PolicyT>
+BasicNPGPEAgent<PolicyT>::BasicNPGPEAgent(PolicyT const &policy_,
+                                          LearningRate const &baselineLearningRate_,
+                                          LearningRate const &hyperparamsLearningRate_,
+                                          double lambda_)
+    : BasicNPGPEAgent(policy_,
+                      FullCovariance(policy_.getDimParameters()),
+                      baselineLearningRate_,
+                      hyperparamsLearningRate_,
+                      lambda_)
+{
+    /* Nothing to do */
+}
+
+template<class PolicyT>
+BasicNPGPEAgent<PolicyT>::BasicNPGPEAgent(PolicyT const &policy_,
+                                          ParameterCovariance const &covariance_,
+                                          LearningRate const &baselineLearningRate_,
+                                          LearningRate const &hyperparamsLearningRate_,
+                                          double lambda_,
+                                          size_t populationSize_)
+    : policyPtr(static_cast<PolicyT *>(policy_.clone().release())),
+      generator(215, RandomStream::Agent),
+      covariancePtr(covariance_.clone()),
+      xi(covariance_.getDimNoise()),
       mean(policy_.getDimParameters(), arma::fill::zeros),
-      choleskyFactor(policy_.getDimParameters(), policy_.getDimParameters(), arma::fill::eye),
-      generator(215),
-      gaussianDistr(0.0, 1.0),
-      xi(policy_.getDimParameters()),
+      covarianceFactor(covariance_.getDimFactor()),
       baseline(0.0),
-      gradientMean(policy_.getDimParameters(), arma::fill::zeros),
-      gradientChol(policy_.getDimParameters(), policy_.getDimParameters(), arma::fill::zeros),
+      baselineLearningRatePtr(baselineLearningRate_.clone()),
+      hyperparamsLearningRatePtr(hyperparamsLearningRate_.clone()),
       lambda(lambda_),
+      gradientMean(policy_.getDimParameters(), arma::fill::zeros),
+      gradientFactor(covariance_.getDimFactor(), arma::fill::zeros),
+      policyParameters(policy_.getDimParameters()),
+      likelihoodMean(policy_.getDimParameters()),
+      likelihoodFactor(covariance_.getDimFactor()),
+      population(populationSize_, covariance_, policy_.getDimAction()),
       observation(policy_.getDimObservation()),
       action(policy_.getDimAction())
 {
+    if (covariance_.getDimParameters() != policy_.getDimParameters())
+        throw std::invalid_argument("Covariance structure does not match the controller parameters");
     initializeParameters();
 }
 
-NPGPEAgent::NPGPEAgent(NPGPEAgent const &other_)
-    : policyPtr(other_.policyPtr->clone()),
-      baselineLearningRatePtr(other_.baselineLearningRatePtr->clone()),
-      hyperparamsLearningRatePtr(other_.hyperparamsLearningRatePtr->clone()),
-      mean(other_.mean),
-      choleskyFactor(other_.choleskyFactor),
+template<class PolicyT>
+BasicNPGPEAgent<PolicyT>::BasicNPGPEAgent(BasicNPGPEAgent const &other_)
+    : policyPtr(static_cast<PolicyT *>(other_.policyPtr->clone().release())),
       generator(other_.generator),
-      gaussianDistr(other_.gaussianDistr),
+      covariancePtr(other_.covariancePtr->clone()),
       xi(other_.xi),
+      mean(other_.mean),
+      covarianceFactor(other_.covarianceFactor),
       baseline(other_.baseline),
-      gradientMean(other_.gradientMean),
-      gradientChol(other_.gradientChol),
+      baselineLearningRatePtr(other_.baselineLearningRatePtr->clone()),
+      hyperparamsLearningRatePtr(other_.hyperparamsLearningRatePtr->clone()),
       lambda(other_.lambda),
+      gradientMean(other_.gradientMean),
+      gradientFactor(other_.gradientFactor),
+      policyParameters(other_.policyParameters),
+      likelihoodMean(other_.likelihoodMean),
+      likelihoodFactor(other_.likelihoodFactor),
+      population(other_.population),
       observation(other_.observation),
       action(other_.action)
 {
     /* Nothing to do */
 }
 
-void NPGPEAgent::initializeParameters()
+template<class PolicyT>
+void BasicNPGPEAgent<PolicyT>::initializeParameters()
 {
     mean.zeros();
-    choleskyFactor.eye();
+    covariancePtr->initializeFactor(1.0, covarianceFactor);
 }
 
-std::unique_ptr<Agent> NPGPEAgent::clone() const
+template<class PolicyT>
+std::unique_ptr<Agent> BasicNPGPEAgent<PolicyT>::clone() const
 {
-    return std::unique_ptr<Agent>(new NPGPEAgent(*this));
+    return std::unique_ptr<Agent>(new BasicNPGPEAgent(*this));
 }
 
-arma::vec NPGPEAgent::getAction()
+template<class PolicyT>
+void BasicNPGPEAgent<PolicyT>::getAction(arma::vec &action_)
 {
-    // Simulate policy parameters: w = mean + cholFactor * xi
-    xi.imbue( [&]() { return gaussianDistr(generator); } );
-    policyPtr->setParameters(mean + choleskyFactor * xi);
+    if (population.size() > 1)
+    {
+        getPopulationAction(action_);
+        return;
+    }
+
+    // Simulate policy parameters: w = mean + perturbation(F, xi)
+    fillStandardNormal(generator, xi);
+    covariancePtr->perturbation(covarianceFactor, xi, policyParameters);
+    policyParameters += mean;
+    policyPtr->setParameters(policyParameters);
 
     // Select action
-    return policyPtr->getAction(observation);
+    policyPtr->getAction(observation, action);
+    convertTo(action, action_);
+}
+
+template<class PolicyT>
+void BasicNPGPEAgent<PolicyT>::getPopulationAction(arma::vec &action_)
+{
+    // Simulate the population of policy parameters: w_j = mean + perturbation(F, xi_j)
+    population.sample(generator, *covariancePtr, covarianceFactor, mean);
+
+    // Evaluate the whole population at once and perform the first action
+    population.evaluate(*policyPtr, observation, action_);
 }
 
-void NPGPEAgent::learn()
+template<class PolicyT>
+void BasicNPGPEAgent<PolicyT>::learn()
 {
+    if (population.size() > 1)
+    {
+        learnPopulation();
+        return;
+    }
+
     // 1) Update baseline
     double alphaBaseline = baselineLearningRatePtr->get();
     baseline += alphaBaseline * (reward - baseline);
 
     // 2) Compute likelihood score
-    arma::vec likelihoodMean = policyPtr->getParameters() - mean;
-    arma::mat likelihoodChol =
-        (arma::trimatu(xi * xi.t()) -
-        0.5 * arma::diagmat(xi * xi.t()) -
-        0.5 * arma::eye(policyPtr->getDimParameters(), policyPtr->getDimParameters())) *
-        choleskyFactor.t();
+    policyPtr->getParameters(likelihoodMean);
+    likelihoodMean -= mean;
 
-    // 3) Update gradients
-    gradientMean = lambda * gradientMean + likelihoodMean;
-    gradientChol = lambda * gradientChol + likelihoodChol;
+    // 3) Update gradients with the natural likelihood score of the factor
+    covariancePtr->factorScore(covarianceFactor, xi, likelihoodMean, likelihoodFactor);
+    gradientMean *= lambda;
+    gradientMean += likelihoodMean;
+    gradientFactor *= lambda;
+    gradientFactor += likelihoodFactor;
 
     // 4) Update hyperparameters
     double alphaHyperparams = hyperparamsLearningRatePtr->get();
     mean += alphaHyperparams * (reward - baseline) * gradientMean;
-    choleskyFactor += alphaHyperparams * (reward - baseline) * gradientChol;
+    covarianceFactor += alphaHyperparams * (reward - baseline) * gradientFactor;
+}
+
+template<class PolicyT>
+void BasicNPGPEAgent<PolicyT>::learnPopulation()
+{
+    // 1) Update baseline with the average reward of the population
+    double alphaBaseline = baselineLearningRatePtr->get();
+    baseline += alphaBaseline * (arma::mean(population.getRewards()) - baseline);
+
+    // 2) Average the likelihood-weighted rewards of the population
+    population.averageScores(*covariancePtr, covarianceFactor, mean,
+                             [&](double reward_) { return reward_ - baseline; },
+                             likelihoodMean, likelihoodFactor);
+
+    // 3) Update hyperparameters. The eligibility trace of the past performed
+    // samples is weighted by the reward of the performed action.
+    double alphaHyperparams = hyperparamsLearningRatePtr->get();
+    gradientMean *= lambda;
+    gradientFactor *= lambda;
+    mean += alphaHyperparams * ((reward - baseline) * gradientMean +
+                                population.getGradientMean());
+    covarianceFactor += alphaHyperparams * ((reward - baseline) * gradientFactor +
+                                            population.getGradientFactor());
+
+    // 4) Update eligibility traces with the score of the performed sample
+    gradientMean += likelihoodMean;
+    gradientFactor += likelihoodFactor;
 }
 
-void NPGPEAgent::newEpoch()
+template<class PolicyT>
+void BasicNPGPEAgent<PolicyT>::newEpoch()
 {
     // Update learning rate
     baselineLearningRatePtr->update();
     hyperparamsLearningRatePtr->update();
 }
 
-void NPGPEAgent::reset()
+template<class PolicyT>
+void BasicNPGPEAgent<PolicyT>::reset()
 {
     // Reset deterministic policy
     policyPtr->reset();
@@ -104,7 +192,7 @@ void NPGPEAgent::reset()
 
     // Reset cache variables
     gradientMean.zeros();
-    gradientChol.zeros();
+    gradientFactor.zeros();
 
     // Reset reward baseline
     baseline = 0.0;
@@ -113,3 +201,45 @@ void NPGPEAgent::reset()
     baselineLearningRatePtr->reset();
     hyperparamsLearningRatePtr->reset();
 }
+
+template<class PolicyT>
+void BasicNPGPEAgent<PolicyT>::seed(unsigned int seed_)
+{
+    generator.seed(seed_, RandomStream::Agent);
+    policyPtr->seed(seed_ + 1);
+}
+
+template<class PolicyT>
+void BasicNPGPEAgent<PolicyT>::saveState(CheckpointWriter &writer_) const
+{
+    writer_.write(mean);
+    writer_.write(covarianceFactor);
+    writer_.write(baseline);
+    writer_.write(gradientMean);
+    writer_.write(gradientFactor);
+    baselineLearningRatePtr->saveState(writer_);
+    hyperparamsLearningRatePtr->saveState(writer_);
+    writer_.write(generator);
+    policyPtr->saveState(writer_);
+}
+
+template<class PolicyT>
+void BasicNPGPEAgent<PolicyT>::loadState(CheckpointReader &reader_)
+{
+    reader_.read(mean);
+    reader_.read(covarianceFactor);
+    reader_.read(baseline);
+    reader_.read(gradientMean);
+    reader_.read(gradientFactor);
+    baselineLearningRatePtr->loadState(reader_);
+    hyperparamsLearningRatePtr->loadState(reader_);
+    reader_.read(generator);
+    policyPtr->loadState(reader_);
+}
+
+// Explicit instantiations
+template class BasicNPGPEAgent<Policy>;
+template class BasicNPGPEAgent<BinaryPolicy>;
+#ifdef THESIS_FIXED_DAYS_OBSERVED
+template class BasicNPGPEAgent<FixedSingleAssetPolicy>;
+#endif
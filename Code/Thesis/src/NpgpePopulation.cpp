@@ -0,0 +1,55 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "thesis/NpgpePopulation.h"
+#include "thesis/NormalSampler.h"
+#include <stdexcept>  /* std::invalid_argument */
+
+NPGPEPopulation::NPGPEPopulation(size_t size_,
+                                 ParameterCovariance const &covariance_,
+                                 size_t dimAction_)
+    : populationSize(size_),
+      noise(covariance_.getDimNoise(), size_),
+      parameters(covariance_.getDimParameters(), size_),
+      actions(dimAction_, size_),
+      rewards(size_, arma::fill::zeros),
+      gradientMean(covariance_.getDimParameters()),
+      gradientFactor(covariance_.getDimFactor())
+{
+    if (populationSize == 0)
+        throw std::invalid_argument("Population size must be positive");
+}
+
+void NPGPEPopulation::sample(Philox4x32 &generator_,
+                             ParameterCovariance const &covariance_,
+                             RealVec const &factor_,
+                             RealVec const &mean_)
+{
+    fillStandardNormal(generator_, noise);
+    for (size_t j = 0; j < populationSize; ++j)
+    {
+        RealVec sampleNoise(noise.colptr(j), noise.n_rows, false, true);
+        RealVec sampleParameters(parameters.colptr(j), mean_.n_elem, false, true);
+        covariance_.perturbation(factor_, sampleNoise, sampleParameters);
+        sampleParameters += mean_;
+    }
+}
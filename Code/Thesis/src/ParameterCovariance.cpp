@@ -0,0 +1,360 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <thesis/ParameterCovariance.h>
+#include <algorithm>  /* std::min */
+#include <stdexcept>  /* std::invalid_argument */
+
+namespace
+{
+
+/*
+ * Kernels on an upper triangular n x n factor F stored column by column. Column
+ * k of F only has entries 0..k, hence (F' * xi)(k) is a dot product with the
+ * head of the column and the lower part of the score M * F is zero.
+ */
+
+void upperPerturbation(Real const *factor, Real const *xi, size_t n,
+                       Real *perturbation)
+{
+    for (size_t k = 0; k < n; ++k)
+    {
+        Real const *factorCol = factor + k * n;
+        double sum = 0.0;
+        for (size_t i = 0; i <= k; ++i)
+            sum += factorCol[i] * xi[i];
+        perturbation[k] = sum;
+    }
+}
+
+/*
+ * Entry (i,k) of M * F is M(i,i) * F(i,k) + xi(i) * sum_{i<j<=k} xi(j) * F(j,k),
+ * so each column is computed backwards with a running sum.
+ */
+void upperScore(Real const *factor, Real const *xi, size_t n, Real *score)
+{
+    for (size_t k = 0; k < n; ++k)
+    {
+        Real const *factorCol = factor + k * n;
+        Real *scoreCol = score + k * n;
+        double suffixSum = 0.0;
+        for (size_t i = k + 1; i-- > 0; )
+        {
+            double const xi2 = xi[i] * xi[i];
+            scoreCol[i] = (xi2 - 0.5 * xi2 - 0.5) * factorCol[i] + xi[i] * suffixSum;
+            suffixSum += xi[i] * factorCol[i];
+        }
+        std::fill(scoreCol + k + 1, scoreCol + n, 0.0);
+    }
+}
+
+void upperInitialize(double scale, size_t n, Real *factor)
+{
+    std::fill(factor, factor + n * n, 0.0);
+    for (size_t i = 0; i < n; ++i)
+        factor[i * n + i] = scale;
+}
+
+/*
+ * Kernels on a general n x n factor C stored column by column. C * xi is
+ * accumulated column by column, and entry (i,k) of the score M * C' is
+ * M(i,i) * C(k,i) + xi(i) * sum_{j>i} xi(j) * C(k,j), so each column of the
+ * score is computed backwards with a running sum over row k of C.
+ */
+
+void generalPerturbation(Real const *factor, Real const *xi, size_t n,
+                         Real *perturbation)
+{
+    std::fill(perturbation, perturbation + n, 0.0);
+    for (size_t k = 0; k < n; ++k)
+    {
+        Real const *factorCol = factor + k * n;
+        Real const xiEntry = xi[k];
+        for (size_t i = 0; i < n; ++i)
+            perturbation[i] += factorCol[i] * xiEntry;
+    }
+}
+
+void generalScore(Real const *factor, Real const *xi, size_t n, Real *score)
+{
+    for (size_t k = 0; k < n; ++k)
+    {
+        Real *scoreCol = score + k * n;
+        double suffixSum = 0.0;
+        for (size_t i = n; i-- > 0; )
+        {
+            double const xi2 = xi[i] * xi[i];
+            double const factorEntry = factor[i * n + k];
+            scoreCol[i] = (xi2 - 0.5 * xi2 - 0.5) * factorEntry + xi[i] * suffixSum;
+            suffixSum += xi[i] * factorEntry;
+        }
+    }
+}
+
+} // namespace
+
+//----------------------|
+// Full covariance      |
+//----------------------|
+
+std::unique_ptr<ParameterCovariance> FullCovariance::clone() const
+{
+    return std::unique_ptr<ParameterCovariance>(new FullCovariance(*this));
+}
+
+void FullCovariance::initializeFactor(double scale_, RealVec &factor_) const
+{
+    factor_.set_size(getDimFactor());
+    upperInitialize(scale_, dimParameters, factor_.memptr());
+}
+
+void FullCovariance::perturbation(RealVec const &factor_,
+                                  RealVec const &noise_,
+                                  RealVec &perturbation_) const
+{
+    perturbation_.set_size(dimParameters);
+    generalPerturbation(factor_.memptr(), noise_.memptr(), dimParameters,
+                        perturbation_.memptr());
+}
+
+void FullCovariance::factorScore(RealVec const &factor_,
+                                 RealVec const &noise_,
+                                 RealVec const &perturbation_,
+                                 RealVec &factorScore_) const
+{
+    generalScore(factor_.memptr(), noise_.memptr(), dimParameters,
+                 factorScore_.memptr());
+}
+
+//------------------------|
+// Triangular covariance  |
+//------------------------|
+
+std::unique_ptr<ParameterCovariance> TriangularCovariance::clone() const
+{
+    return std::unique_ptr<ParameterCovariance>(new TriangularCovariance(*this));
+}
+
+void TriangularCovariance::initializeFactor(double scale_, RealVec &factor_) const
+{
+    factor_.set_size(getDimFactor());
+    upperInitialize(scale_, dimParameters, factor_.memptr());
+}
+
+void TriangularCovariance::perturbation(RealVec const &factor_,
+                                        RealVec const &noise_,
+                                        RealVec &perturbation_) const
+{
+    perturbation_.set_size(dimParameters);
+    upperPerturbation(factor_.memptr(), noise_.memptr(), dimParameters,
+                      perturbation_.memptr());
+}
+
+void TriangularCovariance::factorScore(RealVec const &factor_,
+                                       RealVec const &noise_,
+                                       RealVec const &perturbation_,
+                                       RealVec &factorScore_) const
+{
+    upperScore(factor_.memptr(), noise_.memptr(), dimParameters,
+               factorScore_.memptr());
+}
+
+//----------------------|
+// Diagonal covariance  |
+//----------------------|
+
+std::unique_ptr<ParameterCovariance> DiagonalCovariance::clone() const
+{
+    return std::unique_ptr<ParameterCovariance>(new DiagonalCovariance(*this));
+}
+
+void DiagonalCovariance::initializeFactor(double scale_, RealVec &factor_) const
+{
+    factor_.set_size(dimParameters);
+    factor_.fill(scale_);
+}
+
+void DiagonalCovariance::perturbation(RealVec const &factor_,
+                                      RealVec const &noise_,
+                                      RealVec &perturbation_) const
+{
+    perturbation_.set_size(dimParameters);
+    for (size_t i = 0; i < dimParameters; ++i)
+        perturbation_[i] = factor_[i] * noise_[i];
+}
+
+void DiagonalCovariance::factorScore(RealVec const &factor_,
+                                     RealVec const &noise_,
+                                     RealVec const &perturbation_,
+                                     RealVec &factorScore_) const
+{
+    for (size_t i = 0; i < dimParameters; ++i)
+        factorScore_[i] = 0.5 * (noise_[i] * noise_[i] - 1.0) * factor_[i];
+}
+
+//----------------------|
+// Low-rank covariance  |
+//----------------------|
+
+std::unique_ptr<ParameterCovariance> LowRankCovariance::clone() const
+{
+    return std::unique_ptr<ParameterCovariance>(new LowRankCovariance(*this));
+}
+
+void LowRankCovariance::initializeFactor(double scale_, RealVec &factor_) const
+{
+    factor_.zeros(getDimFactor());
+    factor_.head(dimParameters).fill(scale_);
+}
+
+void LowRankCovariance::perturbation(RealVec const &factor_,
+                                     RealVec const &noise_,
+                                     RealVec &perturbation_) const
+{
+    perturbation_.set_size(dimParameters);
+    Real const *diagonal = factor_.memptr();
+    Real const *xi = noise_.memptr();
+    for (size_t i = 0; i < dimParameters; ++i)
+        perturbation_[i] = diagonal[i] * xi[i];
+
+    Real const *lowRank = diagonal + dimParameters;
+    Real const *eta = xi + dimParameters;
+    for (size_t l = 0; l < rank; ++l)
+    {
+        Real const *lowRankCol = lowRank + l * dimParameters;
+        for (size_t i = 0; i < dimParameters; ++i)
+            perturbation_[i] += eta[l] * lowRankCol[i];
+    }
+}
+
+void LowRankCovariance::factorScore(RealVec const &factor_,
+                                    RealVec const &noise_,
+                                    RealVec const &perturbation_,
+                                    RealVec &factorScore_) const
+{
+    Real const *diagonal = factor_.memptr();
+    Real const *xi = noise_.memptr();
+    Real *score = factorScore_.memptr();
+    for (size_t i = 0; i < dimParameters; ++i)
+        score[i] = 0.5 * (perturbation_[i] * xi[i] - diagonal[i]);
+
+    Real const *lowRank = diagonal + dimParameters;
+    Real const *eta = xi + dimParameters;
+    for (size_t l = 0; l < rank; ++l)
+    {
+        Real const *lowRankCol = lowRank + l * dimParameters;
+        Real *scoreCol = score + (l + 1) * dimParameters;
+        for (size_t i = 0; i < dimParameters; ++i)
+            scoreCol[i] = 0.5 * (perturbation_[i] * eta[l] - lowRankCol[i]);
+    }
+}
+
+//---------------------------|
+// Block-diagonal covariance |
+//---------------------------|
+
+BlockDiagonalCovariance::BlockDiagonalCovariance(size_t dimParameters_,
+                                                 size_t blockSize_)
+    : ParameterCovariance(dimParameters_),
+      blockSize(blockSize_),
+      dimFactor(0)
+{
+    if (blockSize == 0)
+        throw std::invalid_argument("Block size of the covariance must be positive");
+
+    for (size_t start = 0; start < dimParameters; start += blockSize)
+    {
+        size_t const n = std::min(blockSize, dimParameters - start);
+        dimFactor += n * n;
+    }
+}
+
+std::unique_ptr<ParameterCovariance> BlockDiagonalCovariance::clone() const
+{
+    return std::unique_ptr<ParameterCovariance>(new BlockDiagonalCovariance(*this));
+}
+
+void BlockDiagonalCovariance::initializeFactor(double scale_, RealVec &factor_) const
+{
+    factor_.set_size(dimFactor);
+    Real *block = factor_.memptr();
+    for (size_t start = 0; start < dimParameters; start += blockSize)
+    {
+        size_t const n = std::min(blockSize, dimParameters - start);
+        upperInitialize(scale_, n, block);
+        block += n * n;
+    }
+}
+
+void BlockDiagonalCovariance::perturbation(RealVec const &factor_,
+                                           RealVec const &noise_,
+                                           RealVec &perturbation_) const
+{
+    perturbation_.set_size(dimParameters);
+    Real const *block = factor_.memptr();
+    for (size_t start = 0; start < dimParameters; start += blockSize)
+    {
+        size_t const n = std::min(blockSize, dimParameters - start);
+        upperPerturbation(block, noise_.memptr() + start, n,
+                          perturbation_.memptr() + start);
+        block += n * n;
+    }
+}
+
+void BlockDiagonalCovariance::factorScore(RealVec const &factor_,
+                                          RealVec const &noise_,
+                                          RealVec const &perturbation_,
+                                          RealVec &factorScore_) const
+{
+    Real const *block = factor_.memptr();
+    Real *scoreBlock = factorScore_.memptr();
+    for (size_t start = 0; start < dimParameters; start += blockSize)
+    {
+        size_t const n = std::min(blockSize, dimParameters - start);
+        upperScore(block, noise_.memptr() + start, n, scoreBlock);
+        block += n * n;
+        scoreBlock += n * n;
+    }
+}
+
+//---------|
+// Factory |
+//---------|
+
+std::unique_ptr<ParameterCovariance> makeParameterCovariance(std::string const &type_,
+                                                             size_t dimParameters_,
+                                                             size_t rank_,
+                                                             size_t blockSize_)
+{
+    if (type_ == "full")
+        return std::unique_ptr<ParameterCovariance>(new FullCovariance(dimParameters_));
+    else if (type_ == "triangular")
+        return std::unique_ptr<ParameterCovariance>(new TriangularCovariance(dimParameters_));
+    else if (type_ == "diagonal")
+        return std::unique_ptr<ParameterCovariance>(new DiagonalCovariance(dimParameters_));
+    else if (type_ == "lowrank")
+        return std::unique_ptr<ParameterCovariance>(new LowRankCovariance(dimParameters_, rank_));
+    else if (type_ == "block")
+        return std::unique_ptr<ParameterCovariance>(new BlockDiagonalCovariance(dimParameters_, blockSize_));
+    else
+        throw std::invalid_argument("Unknown covariance structure " + type_);
+}
@@ -0,0 +1,274 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "thesis/ParameterSweep.h"
+#include <thesis/MarketEnvironment.h>
+#include <thesis/SyntheticMarketEnvironment.h>
+#include <thesis/AssetAllocationTask.h>
+#include <thesis/AssetAllocationExperiment.h>
+#include <thesis/LearningRate.h>
+#include <thesis/FactoryOfAgents.h>
+#include <cerrno>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <sys/stat.h> /* mkdir */
+
+namespace
+{
+
+//! Create a directory and its missing parents, as mkdir -p.
+void makeDirectories(std::string const &path_)
+{
+    for (size_t pos = path_.find('/', 1); ; pos = path_.find('/', pos + 1))
+    {
+        std::string const prefix = path_.substr(0, pos);
+        if (!prefix.empty() && mkdir(prefix.c_str(), 0755) != 0 && errno != EEXIST)
+            throw std::runtime_error("Cannot create directory " + prefix);
+        if (pos == std::string::npos)
+            break;
+    }
+}
+
+//! Append a trailing slash to a directory path, if missing.
+std::string asDirectory(std::string const &path_)
+{
+    return (path_.empty() || path_.back() == '/') ? path_ : path_ + "/";
+}
+
+} // namespace
+
+ParameterSweep::ParameterSweep(ExperimentParameters const &baseParams_,
+                               std::string const &gridFile_,
+                               std::string const &inputFile_,
+                               std::string const &outputBaseDir_,
+                               std::string const &debugBaseDir_)
+    : baseParams(baseParams_),
+      inputFile(inputFile_),
+      outputBaseDir(asDirectory(outputBaseDir_)),
+      debugBaseDir(asDirectory(debugBaseDir_))
+{
+    readGrid(gridFile_);
+
+    // Load the historical series once, if any job uses it
+    for (Job const &job : jobs)
+    {
+        if (job.params.market == "historical")
+        {
+            historicalDataPtr = std::make_shared<MarketData const>(inputFile);
+            break;
+        }
+    }
+}
+
+void ParameterSweep::readGrid(std::string const &gridFile_)
+{
+    std::ifstream gridFile(gridFile_);
+    if (!gridFile)
+        throw std::runtime_error("Cannot open grid file " + gridFile_);
+
+    // Read the axes of the grid
+    std::vector<std::string> algorithms;
+    std::vector<std::pair<std::string, std::vector<std::string>>> axes;
+    std::string line;
+    while (std::getline(gridFile, line))
+    {
+        line = line.substr(0, line.find('#'));
+        size_t const equalPos = line.find('=');
+        if (equalPos == std::string::npos)
+        {
+            if (line.find_first_not_of(" \t\r") != std::string::npos)
+                throw std::invalid_argument("Invalid grid line: " + line);
+            continue;
+        }
+
+        std::string name;
+        std::istringstream(line.substr(0, equalPos)) >> name;
+        std::vector<std::string> values;
+        std::istringstream valuesStream(line.substr(equalPos + 1));
+        for (std::string value; valuesStream >> value; )
+            values.push_back(value);
+        if (name.empty() || values.empty())
+            throw std::invalid_argument("Invalid grid line: " + line);
+
+        if (name == "algorithm")
+            algorithms = values;
+        else
+            axes.emplace_back(name, values);
+    }
+    if (algorithms.empty())
+        throw std::invalid_argument("The grid file does not list any algorithm");
+
+    // Cartesian product of the parameter axes, the algorithm varying fastest
+    std::vector<size_t> indices(axes.size(), 0);
+    while (true)
+    {
+        Job job{baseParams, "", {}};
+        for (size_t i = 0; i < axes.size(); ++i)
+        {
+            std::string const &value = axes[i].second[indices[i]];
+            job.params.setValue(axes[i].first, value);
+            job.sweptValues.emplace_back(axes[i].first, value);
+        }
+        for (std::string const &algorithm : algorithms)
+        {
+            job.algorithm = algorithm;
+            jobs.push_back(job);
+        }
+
+        // Next combination of values, the last axis varying fastest
+        size_t i = axes.size();
+        while (i > 0 && ++indices[i - 1] == axes[i - 1].second.size())
+            indices[--i] = 0;
+        if (i == 0)
+            break;
+    }
+}
+
+void ParameterSweep::run(WorkStealingPool &pool_) const
+{
+    std::cout << "Parameter sweep - " << jobs.size() << " jobs on "
+              << pool_.getNumThreads() << " threads" << std::endl;
+    pool_.parallelFor(jobs.size(), [this, &pool_](size_t idx)
+    {
+        runJob(jobs[idx], pool_);
+    });
+}
+
+void ParameterSweep::runJob(Job const &job_, WorkStealingPool &pool_) const
+{
+    ExperimentParameters const &params = job_.params;
+
+    // Market, either the shared historical series or simulated on the fly
+    std::unique_ptr<MarketEnvironment> marketPtr;
+    if (params.market == "historical")
+        marketPtr.reset(new MarketEnvironment(historicalDataPtr));
+    else
+        marketPtr = makeSyntheticMarketEnvironment(params.market, params.numSyntheticDays, params.seed);
+    MarketEnvironment &market = *marketPtr;
+    market.setEvaluationInterval(0, params.numDaysObserved + params.numTrainingSteps + params.numTestSteps - 1);
+
+    // Asset allocation task
+    AssetAllocationTask task(market,
+                             params.riskFreeRate,
+                             params.deltaP,
+                             params.deltaF,
+                             params.deltaS,
+                             params.numDaysObserved);
+
+    // Output directories in the layout of the experiment launcher
+    std::string const code = experimentCode(job_, market.getNumRiskyAssets());
+    std::string const outputDir = outputBaseDir + code + "/" + job_.algorithm + "/";
+    std::string const debugDir = debugBaseDir + code + "/" + job_.algorithm + "/";
+    std::string const checkpointDir = params.checkpointDir.empty() ?
+        debugDir : asDirectory(params.checkpointDir) + code + "/" + job_.algorithm + "/";
+    makeDirectories(outputDir);
+    makeDirectories(debugDir);
+    makeDirectories(checkpointDir);
+
+    // Agent, built by a factory local to the job since the singleton
+    // factories keep the parameters of their first use
+    DecayingLearningRate baselineLearningRate(params.alphaConstBaseline, params.alphaExpBaseline);
+    DecayingLearningRate criticLearningRate(params.alphaConstCritic, params.alphaExpCritic);
+    DecayingLearningRate actorLearningRate(params.alphaConstActor, params.alphaExpActor);
+    std::unique_ptr<Agent> agentPtr;
+    if (market.getNumRiskyAssets() == 2)
+    {
+        FactoryOfAgentsForTwoAssetsProblem factory(task.getDimObservation(),
+                                                   baselineLearningRate,
+                                                   criticLearningRate,
+                                                   actorLearningRate,
+                                                   params.lambda,
+                                                   params.covariance,
+                                                   params.covarianceRank,
+                                                   params.covarianceBlockSize,
+                                                   params.populationSize);
+        agentPtr = factory.make(job_.algorithm);
+    }
+    else
+    {
+        FactoryOfAgents factory(task.getDimObservation(),
+                                baselineLearningRate,
+                                criticLearningRate,
+                                actorLearningRate,
+                                params.lambda,
+                                params.covariance,
+                                params.covarianceRank,
+                                params.covarianceBlockSize,
+                                params.populationSize);
+        agentPtr = factory.make(job_.algorithm);
+    }
+
+    // Asset allocation experiment, whose experiments run on the sweep pool
+    AssetAllocationExperiment experiment(task,
+                                         *agentPtr,
+                                         params.numExperiments,
+                                         params.numEpochs,
+                                         params.numTrainingSteps,
+                                         params.numTestSteps,
+                                         outputDir,
+                                         debugDir,
+                                         params.numThreads,
+                                         params.seed,
+                                         BacktestLog::formatFromString(params.backtestFormat));
+    experiment.setCheckpointing(checkpointDir, params.checkpointInterval);
+    experiment.setWarmStart(params.warmStart);
+    experiment.setActorLearner(params.numActorThreads, params.actorBatchSize);
+    experiment.setThreadPool(&pool_);
+    if (params.walkForward)
+        experiment.runWalkForward();
+    else
+        experiment.run();
+
+    std::ostringstream message;
+    message << ".. " << code << "/" << job_.algorithm << " - done" << std::endl;
+    std::cout << message.str() << std::flush;
+}
+
+bool ParameterSweep::isRiskSensitive(std::string const &algorithm_)
+{
+    // Risk-sensitive agents are identified by the RS prefix, e.g. RSNPGPE
+    return algorithm_.compare(0, 2, "RS") == 0;
+}
+
+std::string ParameterSweep::experimentCode(Job const &job_, size_t numRiskyAssets_) const
+{
+    ExperimentParameters const &params = job_.params;
+    std::ostringstream code;
+    code << (numRiskyAssets_ > 1 ? "Multi_" : "Single_")
+         << (params.market == "historical" ? "Hist_" : "Synth_")
+         << (isRiskSensitive(job_.algorithm) ? "RS_" : "RN_")
+         << "P" << static_cast<int>(params.deltaP * 10000) << "_"
+         << "F" << static_cast<int>(params.deltaF * 10000) << "_"
+         << "S" << static_cast<int>(params.deltaS * 10000) << "_"
+         << "N" << params.numDaysObserved;
+
+    // Other swept parameters, which would otherwise share the directory
+    for (auto const &sweptValue : job_.sweptValues)
+    {
+        if (sweptValue.first != "deltaP" && sweptValue.first != "deltaF" &&
+            sweptValue.first != "deltaS" && sweptValue.first != "numDaysObserved")
+            code << "_" << sweptValue.first << sweptValue.second;
+    }
+    return code.str();
+}
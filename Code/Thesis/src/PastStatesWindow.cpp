@@ -0,0 +1,54 @@
+#include <thesis/PastStatesWindow.h>
+
+PastStatesWindow::PastStatesWindow(size_t dimState_,
+                                   size_t numDaysObserved_,
+                                   size_t numTrajectories_)
+    : dimState(dimState_),
+      numDaysObserved(numDaysObserved_),
+      dimPastStates(numDaysObserved_ * dimState_),
+      pastStates(2 * dimPastStates, numTrajectories_),
+      head(0)
+{
+    /* Nothing to do */
+}
+
+void PastStatesWindow::push(arma::mat const &states_)
+{
+    if (numDaysObserved == 0)
+        return;
+
+    // Overwrite the oldest states and their copies
+    size_t first = head * dimState;
+    size_t second = (head + numDaysObserved) * dimState;
+    pastStates.rows(first, first + dimState - 1) = states_;
+    pastStates.rows(second, second + dimState - 1) = states_;
+
+    // The next slot now contains the oldest states
+    head = (head + 1) % numDaysObserved;
+}
+
+void PastStatesWindow::getObservations(double riskFreeRate_,
+                                       arma::mat const &states_,
+                                       arma::mat const &allocations_,
+                                       arma::mat &observations_) const
+{
+    size_t const dimObservation = getDimObservation(allocations_.n_rows);
+    observations_.set_size(dimObservation, states_.n_cols);
+
+    // Risk-free rate
+    observations_.row(0).fill(riskFreeRate_);
+
+    // Past states, from the oldest to the most recent one
+    if (dimPastStates > 0)
+    {
+        size_t begin = head * dimState;
+        observations_.rows(1, dimPastStates) =
+            pastStates.rows(begin, begin + dimPastStates - 1);
+    }
+
+    // Current states
+    observations_.rows(dimPastStates + 1, dimPastStates + dimState) = states_;
+
+    // Current allocations
+    observations_.rows(dimPastStates + dimState + 1, dimObservation - 1) = allocations_;
+}
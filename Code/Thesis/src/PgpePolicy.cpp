@@ -1,4 +1,5 @@
 #include <thesis/PgpePolicy.h>
+#include <stdexcept>  /* std::logic_error */
 
 PGPEPolicy::PGPEPolicy(Policy const &policy_,
                        ProbabilityDistribution const &distribution_,
@@ -7,8 +8,9 @@ PGPEPolicy::PGPEPolicy(Policy const &policy_,
       policyPtr(policy_.clone()),
       distributionPtr(distribution_.clone()),
       resamplingProbability(resamplingProbability_),
-      generator(456),
-      randDistr(0.0, 1.0)
+      generator(456, RandomStream::Policy),
+      randDistr(0.0, 1.0),
+      controllerParameters(policyPtr->getDimParameters())
 {
     /* Nothing to do */
 }
@@ -19,25 +21,39 @@ PGPEPolicy::PGPEPolicy(PGPEPolicy const &other_)
       distributionPtr(other_.distributionPtr->clone()),
       resamplingProbability(other_.resamplingProbability),
       generator(other_.generator),
-      randDistr(other_.randDistr)
+      randDistr(other_.randDistr),
+      controllerParameters(policyPtr->getDimParameters())
 {
     /* Nothing to do */
 }
 
-arma::vec PGPEPolicy::getAction(arma::vec const &observation_) const
+void PGPEPolicy::getAction(RealVec const &observation_,
+                           RealVec &action_) const
 {
     // Simulate policy parameters
     if (randDistr(generator) < resamplingProbability)
-        policyPtr->setParameters(distributionPtr->simulate());
+    {
+        distributionPtr->simulate(controllerParameters);
+        policyPtr->setParameters(controllerParameters);
+    }
 
     // Select action
-    return policyPtr->getAction(observation_);
+    policyPtr->getAction(observation_, action_);
 }
 
-arma::vec PGPEPolicy::likelihoodScore(arma::vec const &observation_,
-                          arma::vec const &action_) const
+void PGPEPolicy::likelihoodScore(RealVec const &observation_,
+                                 RealVec const &action_,
+                                 RealVec &likScore_) const
 {
-    return distributionPtr->likelihoodScore(policyPtr->getParameters());
+    policyPtr->getParameters(controllerParameters);
+    distributionPtr->likelihoodScore(controllerParameters, likScore_);
+}
+
+void PGPEPolicy::behaviourLikelihoodScore(RealVec const &observation_,
+                                           RealVec const &action_,
+                                           RealVec &likScore_) const
+{
+    throw std::logic_error("PGPEPolicy cannot score the actions selected by another copy");
 }
 
 void PGPEPolicy::reset()
@@ -46,6 +62,29 @@ void PGPEPolicy::reset()
     distributionPtr->reset();
 }
 
+void PGPEPolicy::seed(unsigned int seed_)
+{
+    generator.seed(seed_, RandomStream::Policy);
+    randDistr.reset();
+    policyPtr->seed(seed_ + 1);
+    distributionPtr->seed(seed_ + 2);
+}
+
+void PGPEPolicy::saveState(CheckpointWriter &writer_) const
+{
+    writer_.write(generator);
+    policyPtr->saveState(writer_);
+    distributionPtr->saveState(writer_);
+}
+
+void PGPEPolicy::loadState(CheckpointReader &reader_)
+{
+    reader_.read(generator);
+    randDistr.reset();
+    policyPtr->loadState(reader_);
+    distributionPtr->loadState(reader_);
+}
+
 std::unique_ptr<Policy> PGPEPolicy::cloneImpl() const
 {
     return std::unique_ptr<Policy>(new PGPEPolicy(*this));
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "thesis/PhaseTimer.h"
+
+namespace
+{
+
+//! Column names of the phases.
+const char *phaseNames[PhaseProfile::NumPhases] =
+    {"observation", "action", "reward", "learn", "stats", "logging", "checkpoint"};
+
+} // namespace
+
+void PhaseProfile::merge(PhaseProfile const &other_)
+{
+    for (size_t i = 0; i < NumPhases; ++i)
+    {
+        elapsed[i] += other_.elapsed[i];
+        calls[i] += other_.calls[i];
+    }
+}
+
+void PhaseProfile::reset()
+{
+    elapsed.fill(Clock::duration::zero());
+    calls.fill(0);
+}
+
+std::string PhaseProfile::header()
+{
+    std::string columns;
+    for (size_t i = 0; i < NumPhases; ++i)
+    {
+        columns += (i > 0) ? "," : "";
+        columns += std::string(phaseNames[i]) + "," + phaseNames[i] + "Calls";
+    }
+    return columns;
+}
+
+void PhaseProfile::write(std::ostream &os) const
+{
+    for (size_t i = 0; i < NumPhases; ++i)
+    {
+        os << ((i > 0) ? "," : "")
+           << std::chrono::duration<double>(elapsed[i]).count() << "," << calls[i];
+    }
+}
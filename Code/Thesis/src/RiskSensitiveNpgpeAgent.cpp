@@ -1,4 +1,6 @@
 #include "thesis/RiskSensitiveNpgpeAgent.h"
+#include "thesis/NormalSampler.h"
+#include <stdexcept>  /* std::invalid_argument */
 #include <math.h>  /* sqrt */
 
 RiskSensitiveNPGPEAgent::RiskSensitiveNPGPEAgent
@@ -6,38 +8,64 @@ RiskSensitiveNPGPEAgent::RiskSensitiveNPGPEAgent
      LearningRate const &baselineLearningRate_,
      LearningRate const &hyperparamsLearningRate_,
      double lambda_)
+    : RiskSensitiveNPGPEAgent(policy_,
+                              FullCovariance(policy_.getDimParameters()),
+                              baselineLearningRate_,
+                              hyperparamsLearningRate_,
+                              lambda_)
+{
+    /* Nothing to do */
+}
+
+RiskSensitiveNPGPEAgent::RiskSensitiveNPGPEAgent
+    (Policy const &policy_,
+     ParameterCovariance const &covariance_,
+     LearningRate const &baselineLearningRate_,
+     LearningRate const &hyperparamsLearningRate_,
+     double lambda_,
+     size_t populationSize_)
     : policyPtr(policy_.clone()),
-      baselineLearningRatePtr(baselineLearningRate_.clone()),
-      hyperparamsLearningRatePtr(hyperparamsLearningRate_.clone()),
+      generator(215, RandomStream::Agent),
+      covariancePtr(covariance_.clone()),
+      xi(covariance_.getDimNoise()),
       mean(policy_.getDimParameters(), arma::fill::zeros),
-      choleskyFactor(policy_.getDimParameters(), policy_.getDimParameters(), arma::fill::zeros),
-      generator(215),
-      gaussianDistr(0.0, 1.0),
-      xi(policy_.getDimParameters()),
+      covarianceFactor(covariance_.getDimFactor()),
       rewardBaseline(0.02),
       squareRewardBaseline(0.02),
       gradientMean(policy_.getDimParameters(), arma::fill::zeros),
-      gradientChol(policy_.getDimParameters(), policy_.getDimParameters(), arma::fill::zeros),
+      gradientFactor(covariance_.getDimFactor(), arma::fill::zeros),
+      policyParameters(policy_.getDimParameters()),
+      likelihoodMean(policy_.getDimParameters()),
+      likelihoodFactor(covariance_.getDimFactor()),
+      population(populationSize_, covariance_, policy_.getDimAction()),
+      baselineLearningRatePtr(baselineLearningRate_.clone()),
+      hyperparamsLearningRatePtr(hyperparamsLearningRate_.clone()),
       lambda(lambda_),
       observation(policy_.getDimObservation()),
       action(policy_.getDimAction())
 {
+    if (covariance_.getDimParameters() != policy_.getDimParameters())
+        throw std::invalid_argument("Covariance structure does not match the controller parameters");
     initializeParameters();
 }
 
 RiskSensitiveNPGPEAgent::RiskSensitiveNPGPEAgent(RiskSensitiveNPGPEAgent const &other_)
     : policyPtr(other_.policyPtr->clone()),
-      baselineLearningRatePtr(other_.baselineLearningRatePtr->clone()),
-      hyperparamsLearningRatePtr(other_.hyperparamsLearningRatePtr->clone()),
-      mean(other_.mean),
-      choleskyFactor(other_.choleskyFactor),
       generator(other_.generator),
-      gaussianDistr(other_.gaussianDistr),
+      covariancePtr(other_.covariancePtr->clone()),
       xi(other_.xi),
+      mean(other_.mean),
+      covarianceFactor(other_.covarianceFactor),
       rewardBaseline(other_.rewardBaseline),
       squareRewardBaseline(other_.squareRewardBaseline),
       gradientMean(other_.gradientMean),
-      gradientChol(other_.gradientChol),
+      gradientFactor(other_.gradientFactor),
+      policyParameters(other_.policyParameters),
+      likelihoodMean(other_.likelihoodMean),
+      likelihoodFactor(other_.likelihoodFactor),
+      population(other_.population),
+      baselineLearningRatePtr(other_.baselineLearningRatePtr->clone()),
+      hyperparamsLearningRatePtr(other_.hyperparamsLearningRatePtr->clone()),
       lambda(other_.lambda),
       observation(other_.observation),
       action(other_.action)
@@ -48,8 +76,7 @@ RiskSensitiveNPGPEAgent::RiskSensitiveNPGPEAgent(RiskSensitiveNPGPEAgent const &
 void RiskSensitiveNPGPEAgent::initializeParameters()
 {
     mean.zeros();
-    choleskyFactor.zeros();
-    choleskyFactor.diag().ones();
+    covariancePtr->initializeFactor(1.0, covarianceFactor);
 }
 
 std::unique_ptr<Agent> RiskSensitiveNPGPEAgent::clone() const
@@ -57,18 +84,42 @@ std::unique_ptr<Agent> RiskSensitiveNPGPEAgent::clone() const
     return std::unique_ptr<Agent>(new RiskSensitiveNPGPEAgent(*this));
 }
 
-arma::vec RiskSensitiveNPGPEAgent::getAction()
+void RiskSensitiveNPGPEAgent::getAction(arma::vec &action_)
 {
-    // Simulate policy parameters: w = mean + cholFactor * xi
-    xi.imbue( [&]() { return gaussianDistr(generator); } );
-    policyPtr->setParameters(mean + choleskyFactor * xi);
+    if (population.size() > 1)
+    {
+        getPopulationAction(action_);
+        return;
+    }
+
+    // Simulate policy parameters: w = mean + perturbation(F, xi)
+    fillStandardNormal(generator, xi);
+    covariancePtr->perturbation(covarianceFactor, xi, policyParameters);
+    policyParameters += mean;
+    policyPtr->setParameters(policyParameters);
 
     // Select action
-    return policyPtr->getAction(observation);
+    policyPtr->getAction(observation, action);
+    convertTo(action, action_);
+}
+
+void RiskSensitiveNPGPEAgent::getPopulationAction(arma::vec &action_)
+{
+    // Simulate the population of policy parameters: w_j = mean + perturbation(F, xi_j)
+    population.sample(generator, *covariancePtr, covarianceFactor, mean);
+
+    // Evaluate the whole population at once and perform the first action
+    population.evaluate(*policyPtr, observation, action_);
 }
 
 void RiskSensitiveNPGPEAgent::learn()
 {
+    if (population.size() > 1)
+    {
+        learnPopulation();
+        return;
+    }
+
     // 1) Update baseline
     double alphaBaseline = baselineLearningRatePtr->get();
     rewardBaseline += alphaBaseline * (reward - rewardBaseline);
@@ -77,33 +128,69 @@ void RiskSensitiveNPGPEAgent::learn()
     double stddev = sqrt(var);
 
     // 2) Compute likelihood score
-    arma::vec likelihoodMean = policyPtr->getParameters() - mean;
-    arma::mat likelihoodChol =
-        (arma::trimatu(xi * xi.t()) -
-        0.5 * arma::diagmat(xi * xi.t()) -
-        0.5 * arma::eye(policyPtr->getDimParameters(), policyPtr->getDimParameters())) *
-        choleskyFactor.t();
-
-    // 3) Update gradients
-    gradientMean = lambda * gradientMean + likelihoodMean;
-    gradientChol = lambda * gradientChol + likelihoodChol;
-
-    arma::vec gradientRewardMean = (reward - rewardBaseline) * gradientMean;
-    arma::vec gradientSquareRewardMean = (reward * reward - squareRewardBaseline) * gradientMean;
-    arma::mat gradientRewardChol = (reward - rewardBaseline) * gradientChol;
-    arma::mat gradientSquareRewardChol = (reward * reward - squareRewardBaseline) * gradientChol;
-
-    arma::vec gradientSharpeMean =
-        (squareRewardBaseline * gradientRewardMean -
-        0.5 * rewardBaseline * gradientSquareRewardMean) / (var * stddev);
-    arma::mat gradientSharpeChol =
-        (squareRewardBaseline * gradientRewardChol -
-        0.5 * rewardBaseline * gradientSquareRewardChol)  / (var * stddev);
-
-    // 4) Update hyperparameters
+    policyPtr->getParameters(likelihoodMean);
+    likelihoodMean -= mean;
+
+    // 3) Update gradients with the natural likelihood score of the factor
+    covariancePtr->factorScore(covarianceFactor, xi, likelihoodMean, likelihoodFactor);
+    gradientMean *= lambda;
+    gradientMean += likelihoodMean;
+    gradientFactor *= lambda;
+    gradientFactor += likelihoodFactor;
+
+    // 4) Update hyperparameters along the Sharpe ratio gradient
     double alphaHyperparams = hyperparamsLearningRatePtr->get();
-    mean += alphaHyperparams * gradientSharpeMean;
-    choleskyFactor += alphaHyperparams * gradientSharpeChol;
+    double const coeffReward = reward - rewardBaseline;
+    double const coeffSquareReward = reward * reward - squareRewardBaseline;
+    double const halfRewardBaseline = 0.5 * rewardBaseline;
+    double const varStddev = var * stddev;
+    auto sharpeGradient = [&](double gradient) {
+        return (squareRewardBaseline * (coeffReward * gradient) -
+                halfRewardBaseline * (coeffSquareReward * gradient)) / varStddev;
+    };
+    for (size_t i = 0; i < mean.n_elem; ++i)
+        mean[i] += alphaHyperparams * sharpeGradient(gradientMean[i]);
+    for (size_t i = 0; i < covarianceFactor.n_elem; ++i)
+        covarianceFactor[i] += alphaHyperparams * sharpeGradient(gradientFactor[i]);
+}
+
+void RiskSensitiveNPGPEAgent::learnPopulation()
+{
+    // 1) Update baselines with the averages over the population
+    double alphaBaseline = baselineLearningRatePtr->get();
+    arma::vec const &populationRewards = population.getRewards();
+    double const meanReward = arma::mean(populationRewards);
+    double const meanSquareReward = arma::dot(populationRewards, populationRewards) /
+                                    population.size();
+    rewardBaseline += alphaBaseline * (meanReward - rewardBaseline);
+    squareRewardBaseline += alphaBaseline * (meanSquareReward - squareRewardBaseline);
+    double var = squareRewardBaseline - rewardBaseline * rewardBaseline;
+    double stddev = sqrt(var);
+
+    // Weight of a likelihood score in the Sharpe ratio gradient
+    auto sharpeWeight = [&](double reward_) {
+        return (squareRewardBaseline * (reward_ - rewardBaseline) -
+                0.5 * rewardBaseline * (reward_ * reward_ - squareRewardBaseline)) /
+               (var * stddev);
+    };
+
+    // 2) Average the Sharpe-weighted likelihood scores of the population
+    population.averageScores(*covariancePtr, covarianceFactor, mean, sharpeWeight,
+                             likelihoodMean, likelihoodFactor);
+
+    // 3) Update hyperparameters. The eligibility trace of the past performed
+    // samples is weighted by the reward of the performed action.
+    double alphaHyperparams = hyperparamsLearningRatePtr->get();
+    double const traceWeight = sharpeWeight(reward);
+    gradientMean *= lambda;
+    gradientFactor *= lambda;
+    mean += alphaHyperparams * (traceWeight * gradientMean + population.getGradientMean());
+    covarianceFactor += alphaHyperparams * (traceWeight * gradientFactor +
+                                            population.getGradientFactor());
+
+    // 4) Update eligibility traces with the score of the performed sample
+    gradientMean += likelihoodMean;
+    gradientFactor += likelihoodFactor;
 }
 
 void RiskSensitiveNPGPEAgent::newEpoch()
@@ -123,7 +210,7 @@ void RiskSensitiveNPGPEAgent::reset()
 
     // Reset cache variables
     gradientMean.zeros();
-    gradientChol.zeros();
+    gradientFactor.zeros();
 
     // Reset reward baseline
     rewardBaseline = 0.0;
@@ -134,3 +221,37 @@ void RiskSensitiveNPGPEAgent::reset()
     hyperparamsLearningRatePtr->reset();
 }
 
+void RiskSensitiveNPGPEAgent::seed(unsigned int seed_)
+{
+    generator.seed(seed_, RandomStream::Agent);
+    policyPtr->seed(seed_ + 1);
+}
+
+void RiskSensitiveNPGPEAgent::saveState(CheckpointWriter &writer_) const
+{
+    writer_.write(mean);
+    writer_.write(covarianceFactor);
+    writer_.write(rewardBaseline);
+    writer_.write(squareRewardBaseline);
+    writer_.write(gradientMean);
+    writer_.write(gradientFactor);
+    baselineLearningRatePtr->saveState(writer_);
+    hyperparamsLearningRatePtr->saveState(writer_);
+    writer_.write(generator);
+    policyPtr->saveState(writer_);
+}
+
+void RiskSensitiveNPGPEAgent::loadState(CheckpointReader &reader_)
+{
+    reader_.read(mean);
+    reader_.read(covarianceFactor);
+    reader_.read(rewardBaseline);
+    reader_.read(squareRewardBaseline);
+    reader_.read(gradientMean);
+    reader_.read(gradientFactor);
+    baselineLearningRatePtr->loadState(reader_);
+    hyperparamsLearningRatePtr->loadState(reader_);
+    reader_.read(generator);
+    policyPtr->loadState(reader_);
+}
+
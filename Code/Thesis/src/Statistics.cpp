@@ -1,5 +1,6 @@
 #include "thesis/Statistics.h"
 #include <math.h>
+#include <algorithm>
 
 StatisticsAverage::StatisticsAverage()
     : runningSum(0.0), nResults(0)
@@ -103,3 +104,109 @@ void StatisticsExperiment::reset()
     averageReward.reset();
     averageSquareReward.reset();
 }
+
+StatisticsBacktest::StatisticsBacktest()
+{
+    reset();
+}
+
+std::unique_ptr<Statistics> StatisticsBacktest::clone() const
+{
+    return std::unique_ptr<Statistics>(new StatisticsBacktest(*this));
+}
+
+void StatisticsBacktest::dumpOneResult(double result)
+{
+    // Moments of the log-returns, with Welford's update of the mean and of the
+    // sum of the squared deviations from the mean
+    nResults += 1;
+    double const delta = result - meanReward;
+    meanReward += delta / nResults;
+    sumSquareDeviation += delta * (result - meanReward);
+    if (result < 0.0)
+        sumSquareDownside += result * result;
+    else if (result > 0.0)
+        nPositive += 1;
+
+    // Drawdown of the wealth from its running peak
+    logWealth += result;
+    if (logWealth >= peakLogWealth)
+    {
+        peakLogWealth = logWealth;
+        drawdownDuration = 0;
+    }
+    else
+    {
+        minDrawdown = std::min(minDrawdown, logWealth - peakLogWealth);
+        drawdownDuration += 1;
+        maxDrawdownDuration = std::max(maxDrawdownDuration, drawdownDuration);
+    }
+}
+
+void StatisticsBacktest::dumpOneRecord(arma::vec const &allocation_, double result)
+{
+    // Turnover between consecutive allocations
+    if (nResults > 0)
+    {
+        double const *allocation = allocation_.memptr();
+        double const *previous = previousAllocation.memptr();
+        for (size_t i = 0; i < allocation_.n_elem; ++i)
+            sumTurnover += fabs(allocation[i] - previous[i]);
+    }
+    else
+        previousAllocation.set_size(allocation_.n_elem);
+    std::copy(allocation_.begin(), allocation_.end(), previousAllocation.begin());
+
+    dumpOneResult(result);
+}
+
+std::vector<std::vector<double>> StatisticsBacktest::getStatistics() const
+{
+    std::vector<std::vector<double>> result(1);
+    result[0].resize(7);
+
+    // The ratios are reported as zero when their denominator vanishes, e.g. for
+    // an empty backtest or a constant series of log-returns
+    double const average = meanReward;
+    double const stddev = (nResults > 0) ?
+                          sqrt(std::max(sumSquareDeviation / nResults, 0.0)) : 0.0;
+    double const downsideDeviation = (nResults > 0) ? sqrt(sumSquareDownside / nResults) : 0.0;
+
+    // Cumulative return
+    result[0][0] = exp(logWealth) - 1.0;
+
+    // Maximum drawdown and its duration
+    result[0][1] = exp(minDrawdown) - 1.0;
+    result[0][2] = maxDrawdownDuration;
+
+    // Average turnover
+    result[0][3] = (nResults > 1) ? sumTurnover / (nResults - 1) : 0.0;
+
+    // Sharpe and Sortino ratios
+    result[0][4] = (stddev > 0.0) ? average / stddev : 0.0;
+    result[0][5] = (downsideDeviation > 0.0) ? average / downsideDeviation : 0.0;
+
+    // Hit rate
+    result[0][6] = (nResults > 0) ? static_cast<double>(nPositive) / nResults : 0.0;
+    return result;
+}
+
+void StatisticsBacktest::reset()
+{
+    nResults = 0;
+    meanReward = 0.0;
+    sumSquareDeviation = 0.0;
+    sumSquareDownside = 0.0;
+    nPositive = 0;
+    logWealth = 0.0;
+    peakLogWealth = 0.0;
+    minDrawdown = 0.0;
+    drawdownDuration = 0;
+    maxDrawdownDuration = 0;
+    sumTurnover = 0.0;
+}
+
+std::string StatisticsBacktest::names()
+{
+    return "cumulativeReturn,maxDrawdown,maxDrawdownDuration,turnover,sharpe,sortino,hitRate";
+}
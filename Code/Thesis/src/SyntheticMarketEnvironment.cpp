@@ -0,0 +1,267 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <thesis/SyntheticMarketEnvironment.h>
+#include <thesis/NormalSampler.h>
+#include <cmath>      /* std::exp, std::expm1, std::sqrt */
+#include <stdexcept>  /* std::invalid_argument */
+
+//----------------------------|
+// SyntheticMarketEnvironment |
+//----------------------------|
+
+SyntheticMarketEnvironment::SyntheticMarketEnvironment(size_t numRiskyAssets_,
+                                                       size_t numDays_,
+                                                       size_t dimNoise_,
+                                                       size_t dimProcess_,
+                                                       size_t blockSize_,
+                                                       unsigned int seed_)
+    : MarketEnvironment(numRiskyAssets_, numDays_),
+      numDays(numDays_),
+      blockSize(blockSize_),
+      pathSeed(seed_),
+      returnsBlock(numRiskyAssets_, blockSize_),
+      blockStart(0),
+      blockValid(false),
+      noiseBlock(dimNoise_, blockSize_)
+{
+    if (numDays_ == 0 || blockSize_ == 0)
+        throw std::invalid_argument("SyntheticMarketEnvironment: empty series or block");
+    cursor.process.set_size(dimProcess_);
+    cursor.nextBlockStart = 0;
+    cursor.valid = false;
+    anchor.valid = false;
+}
+
+arma::vec SyntheticMarketEnvironment::getState() const
+{
+    arma::vec state(getDimState());
+    getState(state);
+    return state;
+}
+
+void SyntheticMarketEnvironment::getState(arma::vec &state_) const
+{
+    seekBlock(getCurrentDate());
+    state_ = returnsBlock.col(getCurrentDate() - blockStart);
+}
+
+void SyntheticMarketEnvironment::reset()
+{
+    MarketEnvironment::reset();
+
+    // The snapshot is taken at the beginning of the block of the start date
+    size_t const anchorBlock = getStartDate() - getStartDate() % blockSize;
+    if (anchor.valid && anchor.nextBlockStart != anchorBlock)
+        anchor.valid = false;
+}
+
+void SyntheticMarketEnvironment::seed(unsigned int seed_)
+{
+    pathSeed = seed_;
+    cursor.valid = false;
+    anchor.valid = false;
+    blockValid = false;
+}
+
+void SyntheticMarketEnvironment::restartPath() const
+{
+    initializeProcess(cursor.process);
+    cursor.nextBlockStart = 0;
+    cursor.valid = true;
+}
+
+void SyntheticMarketEnvironment::seekBlock(size_t date) const
+{
+    if (blockValid && date >= blockStart && date < blockStart + blockSize)
+        return;
+
+    // Rewind to the snapshot or to the beginning of the path
+    if (!blockValid || !cursor.valid || date < blockStart)
+    {
+        if (anchor.valid && anchor.nextBlockStart <= date)
+            cursor = anchor;
+        else
+            restartPath();
+    }
+
+    // Generate the blocks up to the one containing the date
+    size_t const anchorBlock = getStartDate() - getStartDate() % blockSize;
+    while (cursor.nextBlockStart <= date)
+    {
+        if (!anchor.valid && cursor.nextBlockStart == anchorBlock)
+        {
+            anchor = cursor;
+            anchor.valid = true;
+        }
+        generator.seed(pathSeed, RandomStream::Environment, cursor.nextBlockStart / blockSize);
+        fillStandardNormal(generator, noiseBlock);
+        generateBlock(noiseBlock, cursor.process, returnsBlock);
+        blockStart = cursor.nextBlockStart;
+        cursor.nextBlockStart += blockSize;
+    }
+    blockValid = true;
+}
+
+//--------------------------|
+// ArTrendMarketEnvironment |
+//--------------------------|
+
+ArTrendMarketEnvironment::ArTrendMarketEnvironment(size_t numDays_,
+                                                   size_t numRiskyAssets_,
+                                                   double alpha_,
+                                                   double sigma_,
+                                                   double logPriceScale_,
+                                                   size_t blockSize_,
+                                                   unsigned int seed_)
+    : SyntheticMarketEnvironment(numRiskyAssets_, numDays_, 2 * numRiskyAssets_,
+                                 numRiskyAssets_, blockSize_, seed_),
+      alpha(alpha_),
+      sigma(sigma_),
+      logPriceScale(logPriceScale_)
+{
+    /* Nothing to do */
+}
+
+std::unique_ptr<Environment> ArTrendMarketEnvironment::clone() const
+{
+    return std::unique_ptr<Environment>(new ArTrendMarketEnvironment(*this));
+}
+
+std::vector<std::string> ArTrendMarketEnvironment::getAssetsSymbols() const
+{
+    if (getNumRiskyAssets() == 1)
+        return std::vector<std::string> {"SYNT"};
+    std::vector<std::string> symbols;
+    for (size_t i = 0; i < getNumRiskyAssets(); ++i)
+        symbols.push_back("SYNT_" + std::to_string(i + 1));
+    return symbols;
+}
+
+void ArTrendMarketEnvironment::initializeProcess(arma::vec &process_) const
+{
+    process_.zeros();
+}
+
+void ArTrendMarketEnvironment::generateBlock(arma::mat const &noise_,
+                                             arma::vec &process_,
+                                             arma::mat &returns_) const
+{
+    // Noise rows: price innovations epsilon, then trend innovations nu
+    size_t const numAssets = getNumRiskyAssets();
+    for (size_t t = 0; t < returns_.n_cols; ++t)
+    {
+        double const *epsilon = noise_.colptr(t);
+        double const *nu = epsilon + numAssets;
+        double *logPriceIncrement = returns_.colptr(t);
+        for (size_t i = 0; i < numAssets; ++i)
+        {
+            logPriceIncrement[i] = process_(i) + sigma * epsilon[i];
+            process_(i) = alpha * process_(i) + nu[i];
+        }
+    }
+
+    // Simple returns of the rescaled log-prices
+    double const scale = logPriceScale;
+    returns_.transform([scale](double increment) { return std::expm1(increment / scale); });
+}
+
+//-------------------------------|
+// CointegratedMarketEnvironment |
+//-------------------------------|
+
+CointegratedMarketEnvironment::CointegratedMarketEnvironment(size_t numDays_,
+                                                             double sigma1_,
+                                                             double sigma2_,
+                                                             double sigmaSpread_,
+                                                             double theta_,
+                                                             double rho_,
+                                                             double dt_,
+                                                             size_t blockSize_,
+                                                             unsigned int seed_)
+    : SyntheticMarketEnvironment(2, numDays_, 3, 1, blockSize_, seed_),
+      drift1(-0.5 * sigma1_ * sigma1_ * dt_),
+      drift2(-0.5 * sigma2_ * sigma2_ * dt_),
+      vol1(sigma1_ * std::sqrt(dt_)),
+      vol2(sigma2_ * std::sqrt(dt_)),
+      rho(rho_),
+      spreadDecay(std::exp(-theta_ * dt_)),
+      spreadVol(sigmaSpread_ * std::sqrt((1.0 - std::exp(-2.0 * theta_ * dt_)) / (2.0 * theta_)))
+{
+    /* Nothing to do */
+}
+
+std::unique_ptr<Environment> CointegratedMarketEnvironment::clone() const
+{
+    return std::unique_ptr<Environment>(new CointegratedMarketEnvironment(*this));
+}
+
+std::vector<std::string> CointegratedMarketEnvironment::getAssetsSymbols() const
+{
+    return std::vector<std::string> {"ASSET_1", "ASSET_2"};
+}
+
+void CointegratedMarketEnvironment::initializeProcess(arma::vec &process_) const
+{
+    process_.zeros();
+}
+
+void CointegratedMarketEnvironment::generateBlock(arma::mat const &noise_,
+                                                  arma::vec &process_,
+                                                  arma::mat &returns_) const
+{
+    double const rhoComplement = std::sqrt(1.0 - rho * rho);
+    double spread = process_(0);
+    for (size_t t = 0; t < returns_.n_cols; ++t)
+    {
+        double const *z = noise_.colptr(t);
+        double const w1 = z[0];
+        double const w2 = rho * z[0] + rhoComplement * z[1];
+        double const nextSpread = spreadDecay * spread + spreadVol * z[2];
+        returns_(0, t) = drift1 + vol1 * w1;
+        returns_(1, t) = drift2 + vol2 * w2 + nextSpread - spread;
+        spread = nextSpread;
+    }
+    process_(0) = spread;
+
+    // Simple returns from the log-price increments
+    returns_.transform([](double increment) { return std::expm1(increment); });
+}
+
+//---------|
+// Factory |
+//---------|
+
+std::unique_ptr<MarketEnvironment> makeSyntheticMarketEnvironment(std::string const &type_,
+                                                                  size_t numDays_,
+                                                                  unsigned int seed_)
+{
+    if (type_ == "artrend")
+        return std::unique_ptr<MarketEnvironment>(
+            new ArTrendMarketEnvironment(numDays_, 1, 0.9, 10.0, 2000.0, 256, seed_));
+    else if (type_ == "cointegrated")
+        return std::unique_ptr<MarketEnvironment>(
+            new CointegratedMarketEnvironment(numDays_, 0.20, 0.15, 0.20, 0.15, 0.8,
+                                              1.0 / 365, 256, seed_));
+    else
+        throw std::invalid_argument("Unknown synthetic market " + type_);
+}
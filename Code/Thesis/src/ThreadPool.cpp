@@ -0,0 +1,56 @@
+#include "thesis/ThreadPool.h"
+
+ThreadPool::ThreadPool(size_t numThreads_)
+    : stopping(false)
+{
+    size_t numThreads = (numThreads_ > 0) ? numThreads_ : hardwareConcurrency();
+    workers.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; ++i)
+        workers.emplace_back(&ThreadPool::workerLoop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    queueCondition.notify_all();
+    for (std::thread &worker : workers)
+        worker.join();
+}
+
+std::future<void> ThreadPool::submit(std::function<void()> task_)
+{
+    std::packaged_task<void()> task(std::move(task_));
+    std::future<void> result = task.get_future();
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        tasks.push(std::move(task));
+    }
+    queueCondition.notify_one();
+    return result;
+}
+
+size_t ThreadPool::hardwareConcurrency()
+{
+    size_t numThreads = std::thread::hardware_concurrency();
+    return (numThreads > 0) ? numThreads : 1;
+}
+
+void ThreadPool::workerLoop()
+{
+    for (;;)
+    {
+        std::packaged_task<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            queueCondition.wait(lock, [this]() { return stopping || !tasks.empty(); });
+            if (stopping && tasks.empty())
+                return;
+            task = std::move(tasks.front());
+            tasks.pop();
+        }
+        task();
+    }
+}
@@ -0,0 +1,179 @@
+/*
+ * Copyright (c) 2016 Pierpaolo Necchi
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "thesis/WorkStealingPool.h"
+#include "thesis/ThreadPool.h"
+#include <exception>
+
+namespace
+{
+
+//! Pool owning the calling thread and index of the thread in that pool
+thread_local WorkStealingPool const *currentPool = nullptr;
+thread_local size_t currentWorker = 0;
+
+} // namespace
+
+WorkStealingPool::WorkStealingPool(size_t numThreads_)
+    : numQueued(0),
+      nextQueue(0),
+      stopping(false)
+{
+    size_t numThreads = (numThreads_ > 0) ? numThreads_ : ThreadPool::hardwareConcurrency();
+    queues.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; ++i)
+        queues.emplace_back(new WorkerQueue);
+    workers.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; ++i)
+        workers.emplace_back(&WorkStealingPool::workerLoop, this, i);
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    sleepCondition.notify_all();
+    for (std::thread &worker : workers)
+        worker.join();
+}
+
+size_t WorkStealingPool::currentIndex() const
+{
+    return (currentPool == this) ? currentWorker : queues.size();
+}
+
+void WorkStealingPool::notifyAll()
+{
+    // Taking the mutex orders the notification after the waiters' check
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+    }
+    sleepCondition.notify_all();
+}
+
+void WorkStealingPool::push(std::function<void()> task_)
+{
+    size_t const self = currentIndex();
+    size_t const target = (self < queues.size()) ? self : nextQueue++ % queues.size();
+    {
+        std::lock_guard<std::mutex> lock(queues[target]->mutex);
+        queues[target]->tasks.push_back(std::move(task_));
+    }
+    ++numQueued;
+    notifyAll();
+}
+
+bool WorkStealingPool::runOne(size_t self_)
+{
+    std::function<void()> task;
+    size_t const numQueues = queues.size();
+
+    // Newest task of the own queue
+    if (self_ < numQueues)
+    {
+        std::lock_guard<std::mutex> lock(queues[self_]->mutex);
+        if (!queues[self_]->tasks.empty())
+        {
+            task = std::move(queues[self_]->tasks.back());
+            queues[self_]->tasks.pop_back();
+        }
+    }
+
+    // Oldest task of another queue
+    for (size_t k = 1; !task && k <= numQueues; ++k)
+    {
+        WorkerQueue &victim = *queues[(self_ + k) % numQueues];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty())
+        {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+        }
+    }
+
+    if (!task)
+        return false;
+    --numQueued;
+    task();
+    return true;
+}
+
+void WorkStealingPool::parallelFor(size_t numJobs_,
+                                   std::function<void(size_t)> const &job_)
+{
+    // The loop state lives on the stack: the method returns only after the
+    // last job has signaled its completion.
+    std::atomic<size_t> remaining(numJobs_);
+    std::mutex errorMutex;
+    std::exception_ptr error;
+    for (size_t idx = 0; idx < numJobs_; ++idx)
+    {
+        push([this, idx, &job_, &remaining, &errorMutex, &error]()
+        {
+            try
+            {
+                job_(idx);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(errorMutex);
+                if (!error)
+                    error = std::current_exception();
+            }
+            if (--remaining == 0)
+                notifyAll();
+        });
+    }
+
+    // Help until all the jobs are completed
+    size_t const self = currentIndex();
+    while (remaining > 0)
+    {
+        if (runOne(self))
+            continue;
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleepCondition.wait(lock, [this, &remaining]()
+        {
+            return remaining == 0 || numQueued > 0;
+        });
+    }
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+void WorkStealingPool::workerLoop(size_t index_)
+{
+    currentPool = this;
+    currentWorker = index_;
+    for (;;)
+    {
+        if (runOne(index_))
+            continue;
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        sleepCondition.wait(lock, [this]() { return stopping || numQueued > 0; });
+        if (stopping && numQueued == 0)
+            return;
+    }
+}